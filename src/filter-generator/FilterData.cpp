@@ -17,19 +17,31 @@
  * along with multi-delogo.  If not, see <http://www.gnu.org/licenses/>.
  */
 #include <cstring>
+#include <memory>
 #include <string>
+#include <vector>
 #include <istream>
 #include <ostream>
+#include <stdexcept>
+
+#include <boost/algorithm/string.hpp>
 
 #include "Exceptions.hpp"
 #include "IOUtils.hpp"
 #include "FilterData.hpp"
 #include "FilterList.hpp"
+#include "Filters.hpp"
 
 using namespace fg;
 
 
-const std::string FilterData::HEADER_ = "MDLV1";
+const std::string FilterData::HEADER_V1_ = "MDLV1";
+// Version 2 adds the search regions. Files without search regions are
+// still saved as version 1, so that they can be read by older versions
+const std::string FilterData::HEADER_V2_ = "MDLV2";
+// Version 3 adds delogo filters with other regions after the first.
+// Files without them are still saved as version 1 or 2
+const std::string FilterData::HEADER_V3_ = "MDLV3";
 
 
 FilterData::FilterData()
@@ -67,23 +79,44 @@ FilterList& FilterData::filter_list()
 }
 
 
+std::vector<SearchRegion>& FilterData::search_regions()
+{
+  return search_regions_;
+}
+
+
 bool FilterData::is_filter_data(std::istream& in)
 {
-  char header[HEADER_.size()];
-  in.read(header, HEADER_.size());
-  if (memcmp(header, HEADER_.c_str(), HEADER_.size()) != 0) {
-    return false;
+  return read_version(in) != 0;
+}
+
+
+int FilterData::read_version(std::istream& in)
+{
+  char header[HEADER_V1_.size()];
+  in.read(header, HEADER_V1_.size());
+
+  int version;
+  if (memcmp(header, HEADER_V1_.c_str(), HEADER_V1_.size()) == 0) {
+    version = 1;
+  } else if (memcmp(header, HEADER_V2_.c_str(), HEADER_V2_.size()) == 0) {
+    version = 2;
+  } else if (memcmp(header, HEADER_V3_.c_str(), HEADER_V3_.size()) == 0) {
+    version = 3;
+  } else {
+    return 0;
   }
 
   std::string rest_of_line;
   fg::getline(in, rest_of_line);
-  return rest_of_line == "";
+  return rest_of_line == "" ? version : 0;
 }
 
 
 void FilterData::load(std::istream& in)
 {
-  if (!is_filter_data(in)) {
+  int version = read_version(in);
+  if (version == 0) {
     throw InvalidFilterDataException();
   }
 
@@ -97,16 +130,84 @@ void FilterData::load(std::istream& in)
     throw InvalidFilterDataException();
   }
 
+  search_regions_.clear();
+  if (version >= 2) {
+    load_search_regions(in);
+  }
+
   filter_list_.load(in);
 }
 
 
+void FilterData::load_search_regions(std::istream& in)
+{
+  std::string n_regions_str;
+  fg::getline(in, n_regions_str);
+
+  try {
+    int n_regions = std::stoi(n_regions_str);
+    for (int i = 0; i < n_regions; ++i) {
+      std::string line;
+      if (!fg::getline(in, line)) {
+        throw InvalidFilterDataException();
+      }
+
+      std::vector<std::string> dimensions;
+      boost::split(dimensions, line, boost::is_any_of(";"));
+      if (dimensions.size() != 4) {
+        throw InvalidFilterDataException();
+      }
+
+      search_regions_.push_back(SearchRegion{std::stoi(dimensions[0]),
+                                             std::stoi(dimensions[1]),
+                                             std::stoi(dimensions[2]),
+                                             std::stoi(dimensions[3])});
+    }
+  } catch (std::invalid_argument& e) {
+    throw InvalidFilterDataException();
+  }
+}
+
+
 void FilterData::save(std::ostream& out) const
 {
-  out << HEADER_ << '\n';
+  int version = save_version();
+  if (version == 3) {
+    out << HEADER_V3_ << '\n';
+  } else {
+    out << (version == 2 ? HEADER_V2_ : HEADER_V1_) << '\n';
+  }
   out << movie_file_ << '\n';
   out << std::to_string(jump_size_) << '\n';
 
+  if (version >= 2) {
+    save_search_regions(out);
+  }
+
   filter_list_.save(out);
 }
 
+
+// The lowest version that has everything in the file
+int FilterData::save_version() const
+{
+  for (auto& filter: filter_list_) {
+    if (filter.second->type() == FilterType::DELOGO
+        && !std::static_pointer_cast<DelogoFilter>(filter.second)->other_regions().empty()) {
+      return 3;
+    }
+  }
+
+  return search_regions_.empty() ? 1 : 2;
+}
+
+
+void FilterData::save_search_regions(std::ostream& out) const
+{
+  out << search_regions_.size() << '\n';
+  for (auto& region: search_regions_) {
+    out << region.x << ';' << region.y << ';'
+        << region.width << ';' << region.height << '\n';
+  }
+}
+
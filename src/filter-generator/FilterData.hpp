@@ -20,6 +20,7 @@
 #define FG_FILTER_DATA_H
 
 #include <string>
+#include <vector>
 #include <istream>
 #include <ostream>
 
@@ -27,6 +28,18 @@
 
 
 namespace fg {
+  /**
+   * Part of the frame where the logo finder looks for logos.
+   */
+  struct SearchRegion
+  {
+    int x;
+    int y;
+    int width;
+    int height;
+  };
+
+
   class FilterData
   {
   public:
@@ -38,17 +51,26 @@ namespace fg {
     std::string movie_file() const;
     int jump_size() const;
     FilterList& filter_list();
+    std::vector<SearchRegion>& search_regions();
 
     static bool is_filter_data(std::istream& in);
     void load(std::istream& in);
     void save(std::ostream& out) const;
 
   private:
-    const static std::string HEADER_;
+    const static std::string HEADER_V1_;
+    const static std::string HEADER_V2_;
+    const static std::string HEADER_V3_;
 
     std::string movie_file_;
     int jump_size_;
+    std::vector<SearchRegion> search_regions_;
     FilterList filter_list_;
+
+    static int read_version(std::istream& in);
+    int save_version() const;
+    void load_search_regions(std::istream& in);
+    void save_search_regions(std::ostream& out) const;
   };
 }
 
@@ -160,18 +160,41 @@ std::string RectangularFilter::ffmpeg_audio_str() const
 }
 
 
-DelogoFilter::DelogoFilter(int x, int y, int width, int height)
+DelogoFilter::DelogoFilter(int x, int y, int width, int height,
+                           const std::vector<DelogoRegion>& other_regions)
   : RectangularFilter(x, y, width, height)
+  , other_regions_(other_regions)
 {
 }
 
 
 std::shared_ptr<DelogoFilter> DelogoFilter::load(const std::string& parameters)
 {
-  int x, y, width, height;
+  // The rectangle, followed by the ones of the other regions, if any
+  std::vector<std::string> dimensions;
+  boost::split(dimensions, parameters, boost::is_any_of(";"));
+  if (dimensions.size() % 4 != 0) {
+    throw InvalidParametersException();
+  }
 
-  load_rectangle(parameters, x, y, width, height);
-  return std::shared_ptr<DelogoFilter>(new DelogoFilter(x, y, width, height));
+  std::vector<DelogoRegion> regions;
+  for (size_t i = 0; i < dimensions.size(); i += 4) {
+    DelogoRegion region;
+    load_rectangle(boost::join(std::vector<std::string>(dimensions.begin() + i, dimensions.begin() + i + 4), ";"),
+                   region.x, region.y, region.width, region.height);
+    regions.push_back(region);
+  }
+
+  const DelogoRegion& first = regions[0];
+  return std::shared_ptr<DelogoFilter>(
+    new DelogoFilter(first.x, first.y, first.width, first.height,
+                     std::vector<DelogoRegion>(regions.begin() + 1, regions.end())));
+}
+
+
+const std::vector<DelogoRegion>& DelogoFilter::other_regions() const
+{
+  return other_regions_;
 }
 
 
@@ -191,16 +214,36 @@ std::string DelogoFilter::save_str() const
 {
   std::string buf("delogo;");
   buf.append(rectangle_save_str());
+  for (auto& region: other_regions_) {
+    buf.push_back(';');
+    buf.append(std::to_string(region.x)).push_back(';');
+    buf.append(std::to_string(region.y)).push_back(';');
+    buf.append(std::to_string(region.width)).push_back(';');
+    buf.append(std::to_string(region.height));
+  }
   return buf;
 }
 
 
 std::string DelogoFilter::ffmpeg_str(int frame_width, int frame_height) const
 {
-  int adj_x      = std::max(x(), 1);
-  int adj_y      = std::max(y(), 1);
-  int adj_width  = std::min(width(),  frame_width  - adj_x - 1);
-  int adj_height = std::min(height(), frame_height - adj_y - 1);
+  // One delogo for each region, one after the other
+  std::string buf = region_ffmpeg_str(x(), y(), width(), height(), frame_width, frame_height);
+  for (auto& region: other_regions_) {
+    buf.push_back(',');
+    buf.append(region_ffmpeg_str(region.x, region.y, region.width, region.height, frame_width, frame_height));
+  }
+  return buf;
+}
+
+
+std::string DelogoFilter::region_ffmpeg_str(int x, int y, int width, int height,
+                                            int frame_width, int frame_height) const
+{
+  int adj_x      = std::max(x, 1);
+  int adj_y      = std::max(y, 1);
+  int adj_width  = std::min(width,  frame_width  - adj_x - 1);
+  int adj_height = std::min(height, frame_height - adj_y - 1);
 
   std::string buf("delogo=");
   buf.append(rectangle_ffmpeg_str(adj_x, adj_y, adj_width, adj_height));
@@ -96,18 +96,38 @@ namespace fg {
   };
 
 
+  // Another logo removed by a delogo filter, at the same time as the
+  // one of its rectangle
+  struct DelogoRegion
+  {
+    int x;
+    int y;
+    int width;
+    int height;
+  };
+
+
   class DelogoFilter : public RectangularFilter
   {
   public:
-    DelogoFilter(int x, int y, int width, int height);
+    DelogoFilter(int x, int y, int width, int height,
+                 const std::vector<DelogoRegion>& other_regions = std::vector<DelogoRegion>());
 
     static std::shared_ptr<DelogoFilter> load(const std::string& parameters);
 
+    const std::vector<DelogoRegion>& other_regions() const;
+
     FilterType type() const override;
     std::string name() const override;
 
     std::string save_str() const override;
     std::string ffmpeg_str(int frame_width, int frame_height) const override;
+
+  private:
+    std::vector<DelogoRegion> other_regions_;
+
+    std::string region_ffmpeg_str(int x, int y, int width, int height,
+                                  int frame_width, int frame_height) const;
   };
 
 
@@ -17,6 +17,7 @@
  * along with multi-delogo.  If not, see <http://www.gnu.org/licenses/>.
  */
 #include <utility>
+#include <vector>
 
 #include <gtkmm.h>
 #include <glibmm/i18n.h>
@@ -177,11 +178,36 @@ void Coordinator::on_frame_changed(int new_frame)
   }
 
   change_displayed_filter(iter);
+  prefetch_filter_start_frames(new_frame);
 
   current_frame_ = new_frame;
 }
 
 
+// The frames shown by on_previous_filter() and on_next_filter()
+void Coordinator::prefetch_filter_start_frames(int frame)
+{
+  std::vector<int> frames;
+
+  auto previous = filter_model_->get_for_frame(frame - 1);
+  if (previous) {
+    frames.push_back((*previous)[filter_model_->columns.start_frame]);
+  }
+
+  auto next = filter_model_->get_for_frame(frame);
+  if (next) {
+    ++next;
+  } else {
+    next = filter_model_->children().begin();
+  }
+  if (next) {
+    frames.push_back((*next)[filter_model_->columns.start_frame]);
+  }
+
+  frame_navigator_->set_prefetch_frames(frames);
+}
+
+
 void Coordinator::select_row(const FilterListModel::iterator& iter)
 {
   on_filter_selected_.block();
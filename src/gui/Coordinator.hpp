@@ -20,6 +20,7 @@
 #define MDL_COORDINATOR_H
 
 #include <utility>
+#include <vector>
 
 #include <gtkmm.h>
 
@@ -76,6 +77,7 @@ namespace mdl {
     void on_filter_selected(int start_frame);
 
     void on_frame_changed(int new_frame);
+    void prefetch_filter_start_frames(int frame);
 
     void select_row(const FilterListModel::iterator& iter);
     void unselect_rows();
@@ -295,7 +295,30 @@ FilterPanelDelogo::FilterPanelDelogo(int start_frame, int max_frame,
                                      std::shared_ptr<fg::DelogoFilter> filter,
                                      int frame_width, int frame_height)
   : FilterPanelRectangular(start_frame, max_frame, filter, frame_width, frame_height)
+  , other_regions_(filter->other_regions())
 {
+  if (other_regions_.empty()) {
+    return;
+  }
+
+  Glib::ustring regions;
+  for (auto& region: other_regions_) {
+    if (!regions.empty()) {
+      regions += "\n";
+    }
+    regions += Glib::ustring::compose(_("%1, %2, %3x%4"),
+                                      region.x, region.y, region.width, region.height);
+  }
+  lbl_other_regions_.set_label(regions);
+  lbl_other_regions_.set_halign(Gtk::ALIGN_START);
+  add_widget(lbl_other_regions_, _("Other regions:"), 4);
+
+  btn_remove_other_regions_.set_label(_("_Remove other regions"));
+  btn_remove_other_regions_.set_use_underline();
+  attach(btn_remove_other_regions_, 1, 5, 1, 1);
+
+  btn_remove_other_regions_.signal_clicked().connect(
+    sigc::mem_fun(*this, &FilterPanelDelogo::on_remove_other_regions));
 }
 
 
@@ -304,7 +327,19 @@ fg::filter_ptr FilterPanelDelogo::get_filter() const
   return fg::filter_ptr(new fg::DelogoFilter(txt_x_.get_value_as_int(),
                                              txt_y_.get_value_as_int(),
                                              txt_width_.get_value_as_int(),
-                                             txt_height_.get_value_as_int()));
+                                             txt_height_.get_value_as_int(),
+                                             other_regions_));
+}
+
+
+void FilterPanelDelogo::on_remove_other_regions()
+{
+  other_regions_.clear();
+  lbl_other_regions_.set_label(_("None"));
+  btn_remove_other_regions_.set_sensitive(false);
+
+  // Updates the filter, the rectangle is the same
+  on_parameters_changed();
 }
 
 
@@ -136,6 +136,16 @@ namespace mdl {
                       int frame_width, int frame_height);
 
     fg::filter_ptr get_filter() const override;
+
+  private:
+    // Kept when the rectangle is changed. They can't be edited, only
+    // listed and removed
+    std::vector<fg::DelogoRegion> other_regions_;
+
+    Gtk::Label lbl_other_regions_;
+    Gtk::Button btn_remove_other_regions_;
+
+    void on_remove_other_regions();
   };
 
 
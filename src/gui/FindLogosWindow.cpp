@@ -17,6 +17,8 @@
  * along with multi-delogo.  If not, see <http://www.gnu.org/licenses/>.
  */
 #include <memory>
+#include <string>
+#include <vector>
 #include <limits>
 #include <thread>
 #include <mutex>
@@ -57,6 +59,7 @@ FindLogosWindow::FindLogosWindow(BaseObjectType* cobject,
   : MultiDelogoAppWindow(cobject)
 
   , filter_data_(filter_data)
+  , total_frames_(total_frames)
 
   , txt_initial_frame_(nullptr)
   , txt_final_frame_(nullptr)
@@ -68,6 +71,14 @@ FindLogosWindow::FindLogosWindow(BaseObjectType* cobject,
   , txt_min_logo_height_(nullptr)
   , txt_max_logo_height_(nullptr)
 
+  , txt_threads_(nullptr)
+  , chk_cache_(nullptr)
+
+  , cmb_search_area_(nullptr)
+  , txt_corner_size_(nullptr)
+
+  , chk_review_only_(nullptr)
+
   , progress_bar_(nullptr)
 
   , btn_find_logos_(nullptr)
@@ -121,6 +132,29 @@ void FindLogosWindow::configure_widgets(const Glib::RefPtr<Gtk::Builder>& builde
   configure_spin(*txt_max_logo_height_);
   txt_max_logo_height_->set_value(logo_finder_->get_max_logo_height());
 
+  builder->get_widget("txt_threads", txt_threads_);
+  configure_spin(*txt_threads_, 256);
+  txt_threads_->set_value(std::max(1u, std::thread::hardware_concurrency()));
+
+  builder->get_widget("chk_cache", chk_cache_);
+
+  builder->get_widget("txt_corner_size", txt_corner_size_);
+  configure_spin(*txt_corner_size_, 49);
+  txt_corner_size_->set_value(25);
+
+  builder->get_widget("cmb_search_area", cmb_search_area_);
+  cmb_search_area_->signal_changed().connect(sigc::mem_fun(*this, &FindLogosWindow::on_search_area_changed));
+  if (filter_data_.search_regions().empty()) {
+    cmb_search_area_->remove_text(2);
+    cmb_search_area_->set_active_id("whole");
+  } else {
+    cmb_search_area_->set_active_id("regions");
+  }
+
+  builder->get_widget("chk_review_only", chk_review_only_);
+  chk_review_only_->set_sensitive(filter_data_.filter_list().has_review_filter());
+  chk_review_only_->signal_toggled().connect(sigc::mem_fun(*this, &FindLogosWindow::on_review_only_toggled));
+
   builder->get_widget_derived("progress_bar", progress_bar_);
 
   Gtk::Button* btn_close = nullptr;
@@ -145,6 +179,53 @@ void FindLogosWindow::configure_spin(Gtk::SpinButton& spin, int max)
 }
 
 
+void FindLogosWindow::on_search_area_changed()
+{
+  txt_corner_size_->set_sensitive(cmb_search_area_->get_active_id() == "corners");
+}
+
+
+void FindLogosWindow::on_review_only_toggled()
+{
+  bool whole_range = !chk_review_only_->get_active();
+  txt_initial_frame_->set_sensitive(whole_range);
+  txt_final_frame_->set_sensitive(whole_range);
+}
+
+
+void FindLogosWindow::set_search_area()
+{
+  Glib::ustring search_area = cmb_search_area_->get_active_id();
+
+  if (search_area == "corners") {
+    logo_finder_->set_corner_size(txt_corner_size_->get_value_as_int() / 100.0);
+  } else {
+    logo_finder_->set_corner_size(0);
+  }
+
+  std::vector<LogoSearchRegion> search_regions;
+  if (search_area == "regions") {
+    for (auto& region: filter_data_.search_regions()) {
+      search_regions.push_back(LogoSearchRegion{region.x, region.y, region.width, region.height});
+    }
+  }
+  logo_finder_->set_search_regions(search_regions);
+}
+
+
+std::string FindLogosWindow::get_cache_file() const
+{
+  // One file for each video, in the user cache directory, with the
+  // sums in other files next to it
+  std::string dir = Glib::build_filename(Glib::get_user_cache_dir(), "multi-delogo");
+  g_mkdir_with_parents(dir.c_str(), 0755);
+
+  std::string name = Glib::Checksum::compute_checksum(Glib::Checksum::CHECKSUM_SHA1,
+                                                      filter_data_.movie_file());
+  return Glib::build_filename(dir, name + ".sums");
+}
+
+
 void FindLogosWindow::on_find_logos()
 {
   int min_frame_interval = txt_min_frame_interval_->get_value_as_int();
@@ -157,13 +238,26 @@ void FindLogosWindow::on_find_logos()
     return;
   }
 
-  if (already_has_filters() && !confirm_search_with_existing_filters()) {
+  bool review_only = chk_review_only_->get_active();
+  if (!review_only && already_has_filters() && !confirm_search_with_existing_filters()) {
     return;
   }
 
   int initial_frame = txt_initial_frame_->get_value_as_int() - 1;
   int final_frame = txt_final_frame_->get_value_as_int() - 1;
 
+  std::vector<LogoSearchRange> ranges;
+  if (review_only) {
+    ranges = get_review_ranges(filter_data_.filter_list(), total_frames_);
+    if (ranges.empty()) {
+      return;
+    }
+    logo_finder_->set_search_ranges(ranges);
+  } else {
+    ranges.push_back(LogoSearchRange{initial_frame, final_frame});
+    logo_finder_->set_search_ranges(std::vector<LogoSearchRange>());
+  }
+
   logo_finder_->set_start_frame(initial_frame);
   logo_finder_->set_frame_interval_min(min_frame_interval);
   logo_finder_->set_extra_frames(max_frame_interval - min_frame_interval);
@@ -173,8 +267,12 @@ void FindLogosWindow::on_find_logos()
   logo_finder_->set_min_logo_height(txt_min_logo_height_->get_value_as_int());
   logo_finder_->set_max_logo_height(txt_max_logo_height_->get_value_as_int());
 
+  logo_finder_->set_threads(txt_threads_->get_value_as_int());
+  set_search_area();
+  logo_finder_->set_cache_file(chk_cache_->get_active() ? get_cache_file() : "");
+
   search_in_progress_ = true;
-  callback_.start(initial_frame, final_frame);
+  callback_.start(ranges);
   worker_thread_ = new std::thread([this] {
       find_result_ = logo_finder_->find_logos();
       search_in_progress_ = false;
@@ -299,12 +397,18 @@ void FindLogosWindow::ProgressCallback::calculate_progress(int end_frame)
     return;
   }
 
-  int total_frames = final_frame_ - initial_frame_;
-  int elapsed = end_frame - initial_frame_;
+  int elapsed = 0;
+  for (auto& range: ranges_) {
+    if (end_frame >= range.end_frame) {
+      elapsed += range.end_frame - range.start_frame;
+    } else if (end_frame >= range.start_frame) {
+      elapsed += end_frame - range.start_frame;
+    }
+  }
 
   std::lock_guard<std::mutex> lock(mutex_progress_);
 
-  progress_.percentage = (double) elapsed / total_frames;
+  progress_.percentage = (double) elapsed / total_frames_;
   progress_.seconds_elapsed = timer_.elapsed();
   progress_.calculate_time_remaining();
 
@@ -312,10 +416,14 @@ void FindLogosWindow::ProgressCallback::calculate_progress(int end_frame)
 }
 
 
-void FindLogosWindow::ProgressCallback::start(int initial_frame, int final_frame)
+void FindLogosWindow::ProgressCallback::start(const std::vector<LogoSearchRange>& ranges)
 {
-  initial_frame_ = initial_frame;
-  final_frame_ = final_frame;
+  ranges_ = ranges;
+  total_frames_ = 0;
+  for (auto& range: ranges_) {
+    total_frames_ += range.end_frame - range.start_frame;
+  }
+  final_frame_ = ranges_.back().end_frame;
   timer_.start();
 }
 
@@ -19,6 +19,8 @@
 #ifndef MDL_FIND_LOGOS_WINDOW_H
 #define MDL_FIND_LOGOS_WINDOW_H
 
+#include <string>
+#include <vector>
 #include <memory>
 #include <thread>
 #include <mutex>
@@ -51,6 +53,7 @@ namespace mdl {
   private:
     fg::FilterData& filter_data_;
     std::shared_ptr<LogoFinder> logo_finder_;
+    int total_frames_;
 
     Gtk::SpinButton* txt_initial_frame_;
     Gtk::SpinButton* txt_final_frame_;
@@ -62,6 +65,14 @@ namespace mdl {
     Gtk::SpinButton* txt_min_logo_height_;
     Gtk::SpinButton* txt_max_logo_height_;
 
+    Gtk::SpinButton* txt_threads_;
+    Gtk::CheckButton* chk_cache_;
+
+    Gtk::ComboBoxText* cmb_search_area_;
+    Gtk::SpinButton* txt_corner_size_;
+
+    Gtk::CheckButton* chk_review_only_;
+
     ETRProgressBar* progress_bar_;
 
     Gtk::Button* btn_find_logos_;
@@ -78,6 +89,11 @@ namespace mdl {
     void configure_spin(Gtk::SpinButton& spin);
     void configure_spin(Gtk::SpinButton& spin, int max);
 
+    void on_search_area_changed();
+    void on_review_only_toggled();
+    void set_search_area();
+    std::string get_cache_file() const;
+
     void on_find_logos();
     bool already_has_filters();
     bool confirm_search_with_existing_filters();
@@ -100,7 +116,7 @@ namespace mdl {
       void failure(int start_frame, int end_frame) override;
 
       void set_finder(LogoFinder* finder);
-      void start(int initial_frame, int final_frame);
+      void start(const std::vector<LogoSearchRange>& ranges);
       Progress get_progress() const;
 
     private:
@@ -109,7 +125,8 @@ namespace mdl {
       Progress progress_;
       mutable std::mutex mutex_progress_;
 
-      int initial_frame_;
+      std::vector<LogoSearchRange> ranges_;
+      int total_frames_;
       int final_frame_;
 
       Glib::Timer timer_;
@@ -16,6 +16,10 @@
  * You should have received a copy of the GNU General Public License
  * along with multi-delogo.  If not, see <http://www.gnu.org/licenses/>.
  */
+#include <vector>
+#include <algorithm>
+#include <cstdlib>
+
 #include <boost/algorithm/clamp.hpp>
 
 #include <gtkmm.h>
@@ -40,7 +44,10 @@ FrameNavigator::FrameNavigator(BaseObjectType* cobject,
   , parent_window_(parent_window)
   , frame_provider_(frame_provider)
   , number_of_frames_(frame_provider->get_number_of_frames())
+  , frame_number_(0)
   , duration_(frame_provider->get_duration())
+  , last_step_(0)
+  , displayed_frame_number_(0)
   , frame_view_(nullptr)
   , prev_frame_view_(nullptr)
   , lbl_prev_frame_(nullptr)
@@ -165,75 +172,137 @@ double FrameNavigator::get_fps() const
 }
 
 
+// The frame number, and everything that depends on it, changes at
+// once, while the frames are decoded in the background, so that
+// stepping through the video is never blocked by a slow seek. Only
+// the first frame is got synchronously, since the window is laid out
+// around it
 void FrameNavigator::change_displayed_frame(int new_frame_number)
 {
-  try {
-    new_frame_number = boost::algorithm::clamp(new_frame_number, 1, number_of_frames_);
-
-    if (new_frame_number == frame_number_ + 1) {
-      show_next_frame(new_frame_number);
-    } else if (new_frame_number == frame_number_ - 1) {
-      show_previous_frame(new_frame_number);
-    } else if (new_frame_number != frame_number_) {
-      show_frame(new_frame_number);
+  new_frame_number = boost::algorithm::clamp(new_frame_number, 1, number_of_frames_);
+
+  if (displayed_frame_number_ == 0) {
+    if (!show_frame_now(new_frame_number)) {
+      return;
     }
+  } else if (new_frame_number != frame_number_) {
+    request_frames(new_frame_number);
+  }
 
-    signal_frame_changed_.emit(new_frame_number);
-    frame_number_ = new_frame_number;
-    txt_frame_number_->set_value(frame_number_);
+  signal_frame_changed_.emit(new_frame_number);
+  last_step_ = new_frame_number - frame_number_;
+  frame_number_ = new_frame_number;
+  txt_frame_number_->set_value(frame_number_);
 
-    long time_pos = calculate_position((frame_number_ - 1), get_fps());
-    lbl_time_pos_->set_label(format_time_based_on_total(time_pos, duration_));
-  } catch (const FrameNotAvailableException& e) {
-    Gtk::MessageDialog dlg(parent_window_,
-                           _("Could not get frame"), false,
-                           Gtk::MESSAGE_ERROR);
-    txt_frame_number_->set_value(frame_number_);
-    dlg.run();
-  }
+  long time_pos = calculate_position((frame_number_ - 1), get_fps());
+  lbl_time_pos_->set_label(format_time_based_on_total(time_pos, duration_));
 }
 
 
-void FrameNavigator::show_next_frame(int new_frame_number)
+bool FrameNavigator::show_frame_now(int new_frame_number)
 {
-  prev_frame_pixbuf_ = frame_pixbuf_;
-  prev_frame_view_->set_image(frame_pixbuf_);
+  std::vector<Glib::RefPtr<Gdk::Pixbuf>> frames;
+  try {
+    for (int frame: get_frames_to_show(new_frame_number)) {
+      frames.push_back(frame_provider_->get_frame(frame));
+    }
+  } catch (const FrameNotAvailableException& e) {
+    show_frame_error();
+    return false;
+  }
 
-  fetch_and_show_current_frame(new_frame_number);
+  on_frames_ready(frames, new_frame_number);
+  return true;
 }
 
 
-void FrameNavigator::show_previous_frame(int new_frame_number)
+void FrameNavigator::request_frames(int new_frame_number)
 {
-  frame_pixbuf_ = prev_frame_pixbuf_;
-  frame_view_->set_image(prev_frame_pixbuf_);
-
-  fetch_and_show_prev_frame(new_frame_number);
+  frame_provider_->request_frames(get_frames_to_show(new_frame_number),
+                                  sigc::bind(sigc::mem_fun(*this, &FrameNavigator::on_frames_ready),
+                                             new_frame_number));
 }
 
 
-void FrameNavigator::show_frame(int new_frame_number)
+// The frame and the one before it, counting from 0 as the provider
+std::vector<int> FrameNavigator::get_frames_to_show(int new_frame_number) const
 {
-  fetch_and_show_prev_frame(new_frame_number);
-  fetch_and_show_current_frame(new_frame_number);
+  std::vector<int> frames{new_frame_number - 1};
+  if (new_frame_number != 1) {
+    frames.push_back(new_frame_number - 2);
+  }
+  return frames;
 }
 
 
-void FrameNavigator::fetch_and_show_current_frame(int new_frame_number)
+void FrameNavigator::on_frames_ready(const std::vector<Glib::RefPtr<Gdk::Pixbuf>>& frames, int new_frame_number)
 {
-  frame_pixbuf_ = frame_provider_->get_frame(new_frame_number - 1);
+  if (std::any_of(frames.begin(), frames.end(), [](const auto& frame) { return !frame; })) {
+    show_frame_error();
+    // Back to the frame being shown
+    if (displayed_frame_number_ > 0) {
+      change_displayed_frame(displayed_frame_number_);
+    }
+    return;
+  }
+
+  frame_pixbuf_ = frames[0];
   frame_view_->set_image(frame_pixbuf_);
+  if (frames.size() > 1) {
+    prev_frame_pixbuf_ = frames[1];
+    prev_frame_view_->set_image(prev_frame_pixbuf_);
+  } else {
+    prev_frame_pixbuf_.reset();
+    prev_frame_view_->set_image(empty_pixbuf_);
+  }
+  displayed_frame_number_ = new_frame_number;
+
+  prefetch_next_frames();
 }
 
 
-void FrameNavigator::fetch_and_show_prev_frame(int new_frame_number)
+void FrameNavigator::show_frame_error()
 {
-  if (new_frame_number != 1) {
-    prev_frame_pixbuf_ = frame_provider_->get_frame(new_frame_number - 2);
-    prev_frame_view_->set_image(prev_frame_pixbuf_);
+  Gtk::MessageDialog dlg(parent_window_,
+                         _("Could not get frame"), false,
+                         Gtk::MESSAGE_ERROR);
+  dlg.run();
+}
+
+
+// The user usually keeps moving the same way, by the same step
+void FrameNavigator::prefetch_next_frames()
+{
+  int jump_size = txt_jump_size_->get_value();
+  int direction = last_step_ < 0 ? -1 : 1;
+  bool jumping = std::abs(last_step_) == jump_size && jump_size > 1;
+
+  std::vector<int> targets;
+  if (jumping) {
+    targets = {displayed_frame_number_ + jump_size*direction, displayed_frame_number_ + direction,
+               displayed_frame_number_ - direction, displayed_frame_number_ - jump_size*direction};
   } else {
-    prev_frame_view_->set_image(empty_pixbuf_);
+    targets = {displayed_frame_number_ + direction, displayed_frame_number_ + jump_size*direction,
+               displayed_frame_number_ - direction, displayed_frame_number_ - jump_size*direction};
+  }
+  targets.insert(targets.end(), prefetch_frames_.begin(), prefetch_frames_.end());
+
+  // The provider counts frames from 0, and the previous frame is also
+  // shown
+  std::vector<int> frames;
+  for (int target: targets) {
+    if (target >= 1 && target <= number_of_frames_) {
+      frames.push_back(target - 1);
+      frames.push_back(target - 2);
+    }
   }
+  frame_provider_->prefetch(frames);
+}
+
+
+void FrameNavigator::set_prefetch_frames(const std::vector<int>& frame_numbers)
+{
+  prefetch_frames_ = frame_numbers;
 }
 
 
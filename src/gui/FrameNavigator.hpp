@@ -19,6 +19,8 @@
 #ifndef MDL_FRAME_NAVIGATOR_H
 #define MDL_FRAME_NAVIGATOR_H
 
+#include <vector>
+
 #include <gtkmm.h>
 
 #include "common/FrameProvider.hpp"
@@ -52,6 +54,14 @@ namespace mdl {
 
     FrameView* get_frame_view();
 
+    /**
+     * Frames, besides the ones next to the current frame, that will
+     * probably be shown soon, like the start of the filters around
+     * it. They are decoded in the background after the current frame
+     * is shown.
+     */
+    void set_prefetch_frames(const std::vector<int>& frame_numbers);
+
     typedef sigc::signal<void, int> type_signal_frame_changed;
     type_signal_frame_changed signal_frame_changed();
 
@@ -62,6 +72,12 @@ namespace mdl {
     int number_of_frames_;
     int frame_number_;
     long duration_;
+    // Difference between the current frame and the one shown before it
+    int last_step_;
+    // Frame whose image is shown, which lags behind frame_number_
+    // while it is decoded, 0 before the first one
+    int displayed_frame_number_;
+    std::vector<int> prefetch_frames_;
 
     Glib::RefPtr<Gdk::Pixbuf> frame_pixbuf_;
     FrameView* frame_view_;
@@ -90,11 +106,12 @@ namespace mdl {
     void configure_navigation_bar(const Glib::RefPtr<Gtk::Builder>& builder);
     void configure_zoom_bar(const Glib::RefPtr<Gtk::Builder>& builder);
 
-    void show_next_frame(int new_frame_number);
-    void show_previous_frame(int new_frame_number);
-    void show_frame(int new_frame_number);
-    void fetch_and_show_current_frame(int new_frame_number);
-    void fetch_and_show_prev_frame(int new_frame_number);
+    bool show_frame_now(int new_frame_number);
+    void request_frames(int new_frame_number);
+    std::vector<int> get_frames_to_show(int new_frame_number) const;
+    void on_frames_ready(const std::vector<Glib::RefPtr<Gdk::Pixbuf>>& frames, int new_frame_number);
+    void show_frame_error();
+    void prefetch_next_frames();
 
     void on_frame_number_activate();
     bool on_frame_number_input(GdkEventFocus*);
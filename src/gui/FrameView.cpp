@@ -128,6 +128,17 @@ void FrameView::hide_rectangle()
 }
 
 
+bool FrameView::get_rectangle(Rectangle& rect)
+{
+  if (!rect_->is_visible()) {
+    return false;
+  }
+
+  rect = rect_->get_coordinates();
+  return true;
+}
+
+
 void FrameView::scroll_to_current_rectangle()
 {
   goo_canvas_scroll_to(canvas_, rect_->get_coordinates().x - 50, rect_->get_coordinates().y - 50);
@@ -261,6 +272,14 @@ void SelectionRect::set_visible(bool is_visible)
 }
 
 
+bool SelectionRect::is_visible()
+{
+  GooCanvasItemVisibility visibility;
+  g_object_get(rect_, "visibility", &visibility, NULL);
+  return visibility != GOO_CANVAS_ITEM_INVISIBLE;
+}
+
+
 void SelectionRect::enable_drag_and_drop()
 {
   g_signal_connect(rect_, "button-press-event", G_CALLBACK(sr_on_button_press_wrapper), this);
@@ -43,6 +43,7 @@ namespace mdl {
 
     void show_rectangle(const Rectangle& rect);
     void hide_rectangle();
+    bool get_rectangle(Rectangle& rect);
     void scroll_to_current_rectangle();
 
     typedef sigc::signal<void, Rectangle> type_signal_rectangle_changed;
@@ -103,6 +104,7 @@ namespace mdl {
     GooCanvasItem* c_item();
 
     void set_visible(bool is_visible);
+    bool is_visible();
 
     void enable_drag_and_drop();
 
@@ -138,6 +138,16 @@ void MovieWindow::configure_toolbar(const Glib::RefPtr<Gtk::Builder>& builder,
   builder->get_widget("btn_find_logos", btn_find_logos);
   gtk_actionable_set_action_name(GTK_ACTIONABLE(btn_find_logos->gobj()), "win.find-logos");
 
+  add_action("add-search-region", sigc::mem_fun(*this, &MovieWindow::on_add_search_region));
+  Gtk::MenuItem* mnu_add_search_region = nullptr;
+  builder->get_widget("mnu_add_search_region", mnu_add_search_region);
+  gtk_actionable_set_action_name(GTK_ACTIONABLE(mnu_add_search_region->gobj()), "win.add-search-region");
+
+  add_action("clear-search-regions", sigc::mem_fun(*this, &MovieWindow::on_clear_search_regions));
+  Gtk::MenuItem* mnu_clear_search_regions = nullptr;
+  builder->get_widget("mnu_clear_search_regions", mnu_clear_search_regions);
+  gtk_actionable_set_action_name(GTK_ACTIONABLE(mnu_clear_search_regions->gobj()), "win.clear-search-regions");
+
   add_action("encode", sigc::mem_fun(*this, &MovieWindow::on_encode));
   Gtk::ToolButton* btn_encode = nullptr;
   builder->get_widget("btn_encode", btn_encode);
@@ -206,6 +216,34 @@ void MovieWindow::on_find_logos()
 }
 
 
+void MovieWindow::on_add_search_region()
+{
+  Rectangle rect;
+  if (!frame_navigator_->get_frame_view()->get_rectangle(rect)) {
+    Gtk::MessageDialog dlg(*this, _("Please select a rectangle in the frame to use it as a search region."), false, Gtk::MESSAGE_ERROR);
+    dlg.run();
+    return;
+  }
+
+  filter_data_->search_regions().push_back(fg::SearchRegion{int(rect.x), int(rect.y),
+                                                            int(rect.width), int(rect.height)});
+
+  Gtk::MessageDialog dlg(*this,
+                         Glib::ustring::compose(ngettext("The project has %1 search region. Logos will be searched only inside it.",
+                                                         "The project has %1 search regions. Logos will be searched only inside them.",
+                                                         filter_data_->search_regions().size()),
+                                                filter_data_->search_regions().size()),
+                         false, Gtk::MESSAGE_INFO);
+  dlg.run();
+}
+
+
+void MovieWindow::on_clear_search_regions()
+{
+  filter_data_->search_regions().clear();
+}
+
+
 void MovieWindow::on_encode()
 {
   if (filter_data_->filter_list().empty()) {
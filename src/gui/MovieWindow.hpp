@@ -67,6 +67,8 @@ namespace mdl {
 
     void on_save();
     void on_find_logos();
+    void on_add_search_region();
+    void on_clear_search_regions();
     void on_encode();
 
     void on_scroll_filter_toggled(Gtk::ToggleToolButton* chk);
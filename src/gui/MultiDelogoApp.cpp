@@ -52,6 +52,7 @@ MultiDelogoApp::MultiDelogoApp()
 
   add_main_option_entry(OPTION_TYPE_BOOL, "version", '\0', _("Outputs application version and exits"));
   add_main_option_entry(OPTION_TYPE_BOOL, "verbose", 'v', _("Outputs debugging information"));
+  add_main_option_entry(OPTION_TYPE_INT, "frame-cache", '\0', _("Megabytes of decoded frames kept in memory"), _("MB"));
   signal_handle_local_options().connect(sigc::mem_fun(*this, &MultiDelogoApp::handle_options));
 }
 
@@ -73,6 +74,7 @@ int MultiDelogoApp::handle_options(const Glib::RefPtr<Glib::VariantDict>& option
   }
 
   options->lookup_value("verbose", verbose_);
+  options->lookup_value("frame-cache", frame_cache_size_);
 
   return -1;
 }
@@ -107,7 +109,7 @@ void MultiDelogoApp::open_file(const std::string& file)
     return;
   }
 
-  Glib::RefPtr<FrameProvider> frame_provider = open_movie(*(mpr->filter_data));
+  Glib::RefPtr<FrameProvider> frame_provider = open_movie(mpr->file, *(mpr->filter_data));
   if (!frame_provider) {
     return;
   }
@@ -175,14 +177,19 @@ MultiDelogoApp::maybe_Project MultiDelogoApp::create_project(const std::string&
 }
 
 
-Glib::RefPtr<FrameProvider> MultiDelogoApp::open_movie(fg::FilterData& filter_data)
+Glib::RefPtr<FrameProvider> MultiDelogoApp::open_movie(const std::string& project_file, fg::FilterData& filter_data)
 {
   if (!select_new_movie_file_if_necessary(filter_data)) {
     return Glib::RefPtr<FrameProvider>();
   }
 
   try {
-    return create_frame_provider(filter_data.movie_file());
+    Glib::RefPtr<FrameProvider> frame_provider = create_frame_provider(filter_data.movie_file(),
+                                                                       project_file + ".keyframes");
+    if (frame_cache_size_ >= 0) {
+      frame_provider->set_cache_size(size_t(frame_cache_size_) * 1024 * 1024);
+    }
+    return frame_provider;
   } catch (VideoNotOpenedException& e) {
     auto msg = Glib::ustring::compose(_("File %1 not recognized as video or multi-delogo data"), filter_data.movie_file());
     error_dialog(msg);
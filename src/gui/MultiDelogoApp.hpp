@@ -53,6 +53,8 @@ namespace mdl {
     const static std::string EXTENSION_;
 
     bool verbose_ = false;
+    // In megabytes, negative to use the default of the frame provider
+    int frame_cache_size_ = -1;
 
     struct Project
     {
@@ -74,7 +76,7 @@ namespace mdl {
     maybe_Project open_or_create_project(const std::string& file);
     maybe_Project open_project(const std::string& project_file, std::istream& project_file_stream);
     maybe_Project create_project(const std::string& movie_file);
-    Glib::RefPtr<FrameProvider> open_movie(fg::FilterData& filter_data);
+    Glib::RefPtr<FrameProvider> open_movie(const std::string& project_file, fg::FilterData& filter_data);
     bool select_new_movie_file_if_necessary(fg::FilterData& filter_data);
 
     void on_new_project();
@@ -20,7 +20,10 @@
 #define MDL_FRAME_PROVIDER_H
 
 #include <string>
+#include <vector>
+#include <cstddef>
 
+#include <sigc++/sigc++.h>
 #include <glibmm/objectbase.h>
 #include <glibmm/refptr.h>
 #include <gdkmm/pixbuf.h>
@@ -32,15 +35,48 @@ namespace mdl {
   public:
     virtual Glib::RefPtr<Gdk::Pixbuf> get_frame(int frame_number) = 0;
 
+    typedef sigc::slot<void, const std::vector<Glib::RefPtr<Gdk::Pixbuf>>&> SlotFramesReady;
+    /**
+     * Gets frames without blocking, calling slot from the main loop
+     * when they are ready, in the same order, with a null pixbuf for
+     * each frame that could not be read. A new request cancels the
+     * ones not yet delivered, so only the slot of the latest one is
+     * called.
+     */
+    virtual void request_frames(const std::vector<int>& frame_numbers, const SlotFramesReady& slot) = 0;
+
+    /**
+     * Decodes these frames in the background, so that getting them is
+     * fast, the ones most likely to be needed first. Only the first
+     * ones are decoded if they don't all fit in the memory the
+     * provider sets aside for them. The frames requested before and
+     * not yet decoded are dropped, so an empty list cancels the
+     * prefetch.
+     */
+    virtual void prefetch(const std::vector<int>& frame_numbers) = 0;
+
     virtual int get_frame_width() = 0;
     virtual int get_frame_height() = 0;
     virtual int get_number_of_frames() = 0;
     virtual double get_fps() = 0;
     virtual long get_duration() = 0;
+
+    /**
+     * Sets how many bytes of decoded frames are kept, so that showing
+     * them again doesn't need to decode them.
+     */
+    virtual void set_cache_size(size_t max_bytes) = 0;
+    virtual unsigned long get_cache_hits() = 0;
+    virtual unsigned long get_cache_misses() = 0;
   };
 
 
-  Glib::RefPtr<FrameProvider> create_frame_provider(const std::string& movie_filename);
+  /**
+   * index_file is where the positions of the keyframes of the movie
+   * are kept, for faster seeking.
+   */
+  Glib::RefPtr<FrameProvider> create_frame_provider(const std::string& movie_filename,
+                                                    const std::string& index_file = "");
 }
 
 
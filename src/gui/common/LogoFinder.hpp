@@ -19,8 +19,21 @@
 #ifndef MDL_LOGO_FINDER_H
 #define MDL_LOGO_FINDER_H
 
+#include <string>
+#include <vector>
+
 
 namespace mdl {
+  class LogoBox
+  {
+  public:
+    int x;
+    int y;
+    int width;
+    int height;
+  };
+
+
   class LogoFinderResult
   {
   public:
@@ -30,6 +43,88 @@ namespace mdl {
     int y;
     int width;
     int height;
+    // Logos found in the same frames as the one above, when more than
+    // one is searched for
+    std::vector<LogoBox> other_logos;
+  };
+
+
+  class LogoSearchRegion
+  {
+  public:
+    int x;
+    int y;
+    int width;
+    int height;
+  };
+
+
+  /**
+   * Part of the video, [start_frame, end_frame), to be searched.
+   */
+  class LogoSearchRange
+  {
+  public:
+    int start_frame;
+    int end_frame;
+  };
+
+
+  /**
+   * How the frames used to calculate the averages are read.
+   */
+  enum class SamplingMode
+  {
+    /**
+     * Every frame is decoded, and only the sampled ones are used.
+     */
+    EXHAUSTIVE,
+    /**
+     * The video is seeked to each sampled frame, so the frames in
+     * between are not decoded. Seeking decodes from the previous
+     * keyframe, so this is faster only when the sampled frames are
+     * further apart than the keyframes.
+     */
+    SEEK,
+  };
+
+
+  /**
+   * How the boxes that might be logos are extracted from the
+   * averages.
+   */
+  enum class BoxExtraction
+  {
+    /**
+     * Single pass over the average for all channels, with the boxes
+     * taken from connected components, in raster order. Faster.
+     */
+    FUSED,
+    /**
+     * One pass for each channel and morphological operation, with the
+     * boxes taken from contours, in the order findContours() returns
+     * them.
+     */
+    CONTOURS,
+  };
+
+
+  /**
+   * What identifies the pixels of a logo in the sampled frames.
+   */
+  enum class DetectionSignal
+  {
+    /**
+     * Edges of the average, where the background is blurred.
+     */
+    GRADIENT,
+    /**
+     * Edges of the average that are next to pixels that barely change
+     * from one sampled frame to the other. This separates the logo
+     * from the background with fewer sampled frames than the average
+     * alone, so a bigger frame step can be used.
+     */
+    VARIANCE,
   };
 
 
@@ -65,6 +160,35 @@ namespace mdl {
       extra_frames_ = extra_frames;
     }
 
+    const std::vector<LogoSearchRange>& get_search_ranges() const {
+      return search_ranges_;
+    }
+
+    void set_search_ranges(const std::vector<LogoSearchRange>& search_ranges) {
+      search_ranges_ = search_ranges;
+    }
+
+    void set_initial_failures(int initial_failures) {
+      initial_failures_ = initial_failures;
+    }
+
+
+    bool get_scene_cuts() const {
+      return scene_cuts_;
+    }
+
+    void set_scene_cuts(bool scene_cuts) {
+      scene_cuts_ = scene_cuts;
+    }
+
+    double get_scene_cut_threshold() const {
+      return scene_cut_threshold_;
+    }
+
+    void set_scene_cut_threshold(double scene_cut_threshold) {
+      scene_cut_threshold_ = scene_cut_threshold;
+    }
+
 
     void set_verbose(bool verbose = true) {
       verbose_ = verbose;
@@ -104,9 +228,157 @@ namespace mdl {
     }
 
 
+    int get_frame_step() const {
+      return frame_step_;
+    }
+
+    void set_frame_step(int frame_step) {
+      frame_step_ = frame_step;
+    }
+
+    int get_analysis_height() const {
+      return analysis_height_;
+    }
+
+    void set_analysis_height(int analysis_height) {
+      analysis_height_ = analysis_height;
+    }
+
+    int get_gradient_threshold() const {
+      return gradient_threshold_;
+    }
+
+    void set_gradient_threshold(int gradient_threshold) {
+      gradient_threshold_ = gradient_threshold;
+    }
+
+    int get_close_steps() const {
+      return close_steps_;
+    }
+
+    void set_close_steps(int close_steps) {
+      close_steps_ = close_steps;
+    }
+
+    double get_similarity_threshold() const {
+      return similarity_threshold_;
+    }
+
+    void set_similarity_threshold(double similarity_threshold) {
+      similarity_threshold_ = similarity_threshold;
+    }
+
+
+    DetectionSignal get_detection_signal() const {
+      return detection_signal_;
+    }
+
+    void set_detection_signal(DetectionSignal detection_signal) {
+      detection_signal_ = detection_signal;
+    }
+
+    int get_max_deviation() const {
+      return max_deviation_;
+    }
+
+    void set_max_deviation(int max_deviation) {
+      max_deviation_ = max_deviation;
+    }
+
+
+    int get_max_tracked_logos() const {
+      return max_tracked_logos_;
+    }
+
+    void set_max_tracked_logos(int max_tracked_logos) {
+      max_tracked_logos_ = max_tracked_logos;
+    }
+
+    int get_max_logos() const {
+      return max_logos_;
+    }
+
+    void set_max_logos(int max_logos) {
+      max_logos_ = max_logos;
+    }
+
+
+    int get_threads() const {
+      return threads_;
+    }
+
+    void set_threads(int threads) {
+      threads_ = threads;
+    }
+
+
+    int get_decode_buffer_size() const {
+      return decode_buffer_size_;
+    }
+
+    void set_decode_buffer_size(int decode_buffer_size) {
+      decode_buffer_size_ = decode_buffer_size;
+    }
+
+
+    SamplingMode get_sampling_mode() const {
+      return sampling_mode_;
+    }
+
+    void set_sampling_mode(SamplingMode sampling_mode) {
+      sampling_mode_ = sampling_mode;
+    }
+
+
+    BoxExtraction get_box_extraction() const {
+      return box_extraction_;
+    }
+
+    void set_box_extraction(BoxExtraction box_extraction) {
+      box_extraction_ = box_extraction;
+    }
+
+
+    double get_corner_size() const {
+      return corner_size_;
+    }
+
+    void set_corner_size(double corner_size) {
+      corner_size_ = corner_size;
+    }
+
+    const std::vector<LogoSearchRegion>& get_search_regions() const {
+      return search_regions_;
+    }
+
+    void set_search_regions(const std::vector<LogoSearchRegion>& search_regions) {
+      search_regions_ = search_regions;
+    }
+
+
+    const std::string& get_cache_file() const {
+      return cache_file_;
+    }
+
+    void set_cache_file(const std::string& cache_file) {
+      cache_file_ = cache_file;
+    }
+
+    int get_cache_size() const {
+      return cache_size_;
+    }
+
+    void set_cache_size(int cache_size) {
+      cache_size_ = cache_size;
+    }
+
+
     typedef std::pair<bool, std::string> find_result;
 
 
+    virtual int get_total_frames() const = 0;
+
+
     virtual find_result find_logos() = 0;
     virtual void stop() = 0;
 
@@ -115,6 +387,42 @@ namespace mdl {
     int frame_interval_min_;
     int extra_frames_;
 
+    /**
+     * Parts of the video that are searched, in order, instead of
+     * everything from start_frame_. Nothing outside them is read,
+     * and the logos found end at the end of their range. If the
+     * search stops in the middle of a range in which something was
+     * reported, the rest of it is reported as a failure.
+     */
+    std::vector<LogoSearchRange> search_ranges_;
+
+    /**
+     * Number of failures reported just before the start of the search,
+     * by a previous search of the frames before it that is being
+     * resumed. Each failure widens the search for the next logo
+     * transition point, as if it had happened in this search.
+     */
+    int initial_failures_ = 0;
+
+    /**
+     * If true, the video is scanned ahead of the search for scene
+     * cuts and logo changes in the search area, and the intervals end
+     * at them instead of always having frame_interval_min_ frames.
+     *
+     * The scan is a second pass over the video, with its own capture
+     * and at the original size: with SamplingMode::EXHAUSTIVE it
+     * decodes every frame, doubling the decoding work of the search,
+     * and with SamplingMode::SEEK it seeks to every sampled frame. It
+     * runs in its own thread, so it costs less time than that only
+     * when there are idle cores.
+     */
+    bool scene_cuts_ = false;
+    /**
+     * Distance between the colour histograms of the search area in
+     * two sampled frames, from 0 to 1, above which there is a cut.
+     */
+    double scene_cut_threshold_ = 0.3;
+
     bool verbose_ = false;
 
     /**
@@ -134,6 +442,115 @@ namespace mdl {
      */
     int max_logo_height_ = 23;
 
+    /**
+     * Step between frames used to calculate the average. Bigger makes
+     * it faster, but possibly less accurate.
+     */
+    int frame_step_ = 10;
+    /**
+     * Height the frames are reduced to, right after being decoded, to
+     * be searched. The sizes of the logos and the boxes found are
+     * still in pixels of the original frames, the boxes being refined
+     * at the original resolution. 0 to search the frames at their
+     * original size.
+     */
+    int analysis_height_ = 0;
+    /**
+     * Minimum gradient for a pixel to be considered part of a box.
+     */
+    int gradient_threshold_ = 190;
+    /**
+     * Number of times to apply CLOSE morphology.
+     */
+    int close_steps_ = 3;
+    /**
+     * Threshold for similarity when searching for the logo in extra
+     * frames (when the frame interval is not constant). Higher might
+     * detect the logo in case the background changes a lot, but can
+     * also generate more incorrect results.
+     */
+    double similarity_threshold_ = 0.7;
+
+    DetectionSignal detection_signal_ = DetectionSignal::GRADIENT;
+    /**
+     * Maximum standard deviation, across the sampled frames, of a
+     * pixel considered static. Only used with
+     * DetectionSignal::VARIANCE.
+     */
+    int max_deviation_ = 12;
+
+    /**
+     * Number of the last logos found that are looked for first, at
+     * the same position, in the next intervals. Only when none of
+     * them is there is the whole search done. 0 to always do the
+     * whole search. With more than one thread the upcoming intervals
+     * are analysed ahead, before the logos of the previous ones are
+     * known. An interval analysed while the tracked logos were others
+     * is analysed again, so the results are the same with any number
+     * of threads.
+     */
+    int max_tracked_logos_ = 0;
+    /**
+     * Maximum number of logos found in the same frames, such as the
+     * logo of a channel and a rating badge. The first logo is found
+     * and tracked as when only one is searched for, and ends the
+     * intervals, the others are the best candidate boxes of the
+     * interval that don't overlap it or each other, taken from the
+     * same averages.
+     */
+    int max_logos_ = 1;
+
+    /**
+     * Number of threads used to analyse intervals. With more than
+     * one, upcoming intervals are analysed in parallel, but results
+     * are still reported in frame order.
+     */
+    int threads_ = 1;
+
+    /**
+     * Memory, in megabytes, used to keep frames decoded ahead of
+     * their analysis by a separate thread. With 0 decoding and
+     * analysis are done one after the other.
+     */
+    int decode_buffer_size_ = 64;
+
+    SamplingMode sampling_mode_ = SamplingMode::EXHAUSTIVE;
+
+    /**
+     * CONTOURS until FUSED is shown to find the same logos: it checks
+     * the boxes in another order, so when several fit the logo sizes
+     * it can pick another one.
+     */
+    BoxExtraction box_extraction_ = BoxExtraction::CONTOURS;
+
+    /**
+     * If greater than zero, logos are only searched in the corners of
+     * the frame. This is the size of each corner, as a fraction of
+     * the frame width and height.
+     */
+    double corner_size_ = 0;
+    /**
+     * Parts of the frame where logos are searched, in addition to the
+     * corners. When there are no regions and no corners, the whole
+     * frame is searched.
+     */
+    std::vector<LogoSearchRegion> search_regions_;
+
+    /**
+     * File where the sums of the frames used to calculate the
+     * averages are kept, so that the video is not decoded again when
+     * the same part of it is searched with other logo sizes. Empty to
+     * not keep them. The sums are written to other files next to it,
+     * named after it with a number added.
+     */
+    std::string cache_file_;
+
+    /**
+     * Maximum size, in megabytes, of the sums kept. The least recently
+     * used are deleted to stay below it.
+     */
+    int cache_size_ = 2048;
+
 
     LogoFinderCallback& callback_;
   };
@@ -0,0 +1,112 @@
+/*
+ * Copyright (C) 2018-2025 Werner Turing <werner.turing@protonmail.com>
+ *
+ * This file is part of multi-delogo.
+ *
+ * multi-delogo is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * multi-delogo is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with multi-delogo.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include <cstddef>
+#include <memory>
+#include <vector>
+#include <mutex>
+
+#include "FrameBufferPool.hpp"
+
+using namespace mdl::opencv;
+
+
+std::shared_ptr<FrameBufferPool> FrameBufferPool::create(size_t max_free_buffers)
+{
+  return std::shared_ptr<FrameBufferPool>(new FrameBufferPool(max_free_buffers));
+}
+
+
+FrameBufferPool::FrameBufferPool(size_t max_free_buffers)
+  : max_free_buffers_(max_free_buffers)
+  , buffer_size_(0)
+  , allocations_(0)
+{
+}
+
+
+FrameBufferPool::~FrameBufferPool()
+{
+  for (unsigned char* buffer: free_buffers_) {
+    delete[] buffer;
+  }
+}
+
+
+FrameBufferPool::buffer_ptr FrameBufferPool::acquire(size_t size)
+{
+  unsigned char* buffer = nullptr;
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (size != buffer_size_) {
+      for (unsigned char* free_buffer: free_buffers_) {
+        delete[] free_buffer;
+      }
+      free_buffers_.clear();
+      buffer_size_ = size;
+    }
+
+    if (!free_buffers_.empty()) {
+      buffer = free_buffers_.back();
+      free_buffers_.pop_back();
+    } else {
+      ++allocations_;
+    }
+  }
+  if (!buffer) {
+    buffer = new unsigned char[size];
+  }
+
+  std::weak_ptr<FrameBufferPool> pool = shared_from_this();
+  return buffer_ptr(buffer,
+    [pool, size](unsigned char* buffer) {
+      auto owner = pool.lock();
+      if (owner) {
+        owner->release(buffer, size);
+      } else {
+        delete[] buffer;
+      }
+    });
+}
+
+
+void FrameBufferPool::release(unsigned char* buffer, size_t size)
+{
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (size == buffer_size_ && free_buffers_.size() < max_free_buffers_) {
+      free_buffers_.push_back(buffer);
+      return;
+    }
+  }
+  delete[] buffer;
+}
+
+
+size_t FrameBufferPool::get_free_buffers() const
+{
+  std::lock_guard<std::mutex> lock(mutex_);
+  return free_buffers_.size();
+}
+
+
+unsigned long FrameBufferPool::get_allocations() const
+{
+  std::lock_guard<std::mutex> lock(mutex_);
+  return allocations_;
+}
@@ -0,0 +1,68 @@
+/*
+ * Copyright (C) 2018-2025 Werner Turing <werner.turing@protonmail.com>
+ *
+ * This file is part of multi-delogo.
+ *
+ * multi-delogo is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * multi-delogo is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with multi-delogo.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#ifndef MDL_OPENCV_FRAME_BUFFER_POOL_H
+#define MDL_OPENCV_FRAME_BUFFER_POOL_H
+
+#include <cstddef>
+#include <memory>
+#include <vector>
+#include <mutex>
+
+
+namespace mdl { namespace opencv {
+  /**
+   * Memory for decoded frames, reused instead of allocated for each
+   * frame. A buffer goes back to the pool when the last reference to
+   * it is dropped, or is freed if the pool is already gone or keeps
+   * enough free buffers.
+   *
+   * The frames of a video are all the same size, so only free buffers
+   * of the size asked for are reused; the others are freed.
+   *
+   * Buffers can be taken and dropped by several threads at the same
+   * time.
+   */
+  class FrameBufferPool : public std::enable_shared_from_this<FrameBufferPool>
+  {
+  public:
+    typedef std::shared_ptr<unsigned char> buffer_ptr;
+
+    static std::shared_ptr<FrameBufferPool> create(size_t max_free_buffers);
+    ~FrameBufferPool();
+
+    buffer_ptr acquire(size_t size);
+
+    size_t get_free_buffers() const;
+    unsigned long get_allocations() const;
+
+  private:
+    explicit FrameBufferPool(size_t max_free_buffers);
+
+    size_t max_free_buffers_;
+    size_t buffer_size_;
+    std::vector<unsigned char*> free_buffers_;
+    unsigned long allocations_;
+    mutable std::mutex mutex_;
+
+    void release(unsigned char* buffer, size_t size);
+  };
+} }
+
+
+#endif // MDL_OPENCV_FRAME_BUFFER_POOL_H
@@ -0,0 +1,159 @@
+/*
+ * Copyright (C) 2018-2025 Werner Turing <werner.turing@protonmail.com>
+ *
+ * This file is part of multi-delogo.
+ *
+ * multi-delogo is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * multi-delogo is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with multi-delogo.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#ifndef MDL_OPENCV_FRAME_CACHE_H
+#define MDL_OPENCV_FRAME_CACHE_H
+
+#include <cstddef>
+#include <list>
+#include <unordered_map>
+
+
+namespace mdl { namespace opencv {
+  /**
+   * Keeps the last frames used, by frame number, up to a number of
+   * bytes. When a new frame doesn't fit, the ones used least recently
+   * are dropped. Frames bigger than the whole budget are not kept.
+   *
+   * Frame is usually a reference-counted pointer, so that the frames
+   * returned are shared with the cache instead of copied.
+   */
+  template <typename Frame>
+  class FrameCache
+  {
+  public:
+    explicit FrameCache(size_t max_bytes)
+      : max_bytes_(max_bytes)
+      , bytes_(0)
+      , hits_(0)
+      , misses_(0)
+    {
+    }
+
+    /**
+     * Sets frame to the cached frame and returns true, or returns
+     * false if it is not cached.
+     */
+    bool get(int frame_number, Frame& frame)
+    {
+      auto i = index_.find(frame_number);
+      if (i == index_.end()) {
+        ++misses_;
+        return false;
+      }
+
+      ++hits_;
+      entries_.splice(entries_.begin(), entries_, i->second);
+      frame = i->second->frame;
+      return true;
+    }
+
+    void put(int frame_number, const Frame& frame, size_t bytes)
+    {
+      remove(frame_number);
+      if (bytes > max_bytes_) {
+        return;
+      }
+
+      entries_.push_front(Entry{frame_number, frame, bytes});
+      index_[frame_number] = entries_.begin();
+      bytes_ += bytes;
+      evict();
+    }
+
+    bool contains(int frame_number) const
+    {
+      return index_.count(frame_number) > 0;
+    }
+
+    void clear()
+    {
+      entries_.clear();
+      index_.clear();
+      bytes_ = 0;
+    }
+
+    size_t get_max_bytes() const
+    {
+      return max_bytes_;
+    }
+
+    void set_max_bytes(size_t max_bytes)
+    {
+      max_bytes_ = max_bytes;
+      evict();
+    }
+
+    size_t get_bytes() const
+    {
+      return bytes_;
+    }
+
+    size_t size() const
+    {
+      return entries_.size();
+    }
+
+    unsigned long get_hits() const
+    {
+      return hits_;
+    }
+
+    unsigned long get_misses() const
+    {
+      return misses_;
+    }
+
+  private:
+    struct Entry
+    {
+      int frame_number;
+      Frame frame;
+      size_t bytes;
+    };
+
+    size_t max_bytes_;
+    size_t bytes_;
+    unsigned long hits_;
+    unsigned long misses_;
+
+    // The most recently used first
+    std::list<Entry> entries_;
+    std::unordered_map<int, typename std::list<Entry>::iterator> index_;
+
+    void remove(int frame_number)
+    {
+      auto i = index_.find(frame_number);
+      if (i != index_.end()) {
+        bytes_ -= i->second->bytes;
+        entries_.erase(i->second);
+        index_.erase(i);
+      }
+    }
+
+    void evict()
+    {
+      while (bytes_ > max_bytes_) {
+        remove(entries_.back().frame_number);
+      }
+    }
+  };
+} }
+
+
+#endif // MDL_OPENCV_FRAME_CACHE_H
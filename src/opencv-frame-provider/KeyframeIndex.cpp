@@ -0,0 +1,176 @@
+/*
+ * Copyright (C) 2018-2025 Werner Turing <werner.turing@protonmail.com>
+ *
+ * This file is part of multi-delogo.
+ *
+ * multi-delogo is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * multi-delogo is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with multi-delogo.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include <cstdint>
+#include <string>
+#include <vector>
+#include <utility>
+#include <algorithm>
+#include <fstream>
+#include <sstream>
+
+#include <sys/stat.h>
+
+#include "KeyframeIndex.hpp"
+
+using namespace mdl::opencv;
+
+
+const std::string KeyframeIndex::MAGIC_ = "MDLKEYS1";
+
+
+void KeyframeIndex::add_packet(int64_t pts, bool keyframe)
+{
+  packets_.push_back(std::make_pair(pts, keyframe));
+}
+
+
+void KeyframeIndex::finish()
+{
+  pts_.clear();
+  keyframes_.clear();
+
+  std::sort(packets_.begin(), packets_.end());
+  bool repeated = std::adjacent_find(packets_.begin(), packets_.end(),
+    [](const auto& packet1, const auto& packet2) {
+      return packet1.first == packet2.first;
+    }) != packets_.end();
+
+  if (!repeated) {
+    for (auto& packet: packets_) {
+      if (packet.second) {
+        keyframes_.push_back(pts_.size());
+      }
+      pts_.push_back(packet.first);
+    }
+  }
+
+  // Without a keyframe at the start no frame can be reached
+  if (keyframes_.empty() || keyframes_.front() != 0) {
+    pts_.clear();
+    keyframes_.clear();
+  }
+
+  packets_.clear();
+  packets_.shrink_to_fit();
+}
+
+
+bool KeyframeIndex::empty() const
+{
+  return pts_.empty();
+}
+
+
+int KeyframeIndex::get_number_of_frames() const
+{
+  return pts_.size();
+}
+
+
+int KeyframeIndex::get_keyframe_before(int frame_number) const
+{
+  auto after = std::upper_bound(keyframes_.begin(), keyframes_.end(), frame_number);
+  if (after == keyframes_.begin()) {
+    return -1;
+  }
+  return *(after - 1);
+}
+
+
+int KeyframeIndex::get_frame_for_pts(int64_t pts) const
+{
+  auto frame = std::lower_bound(pts_.begin(), pts_.end(), pts);
+  if (frame == pts_.end() || *frame != pts) {
+    return -1;
+  }
+  return frame - pts_.begin();
+}
+
+
+bool KeyframeIndex::save(const std::string& file, const std::string& video_file) const
+{
+  std::string id;
+  if (!get_video_id(video_file, id)) {
+    return false;
+  }
+
+  std::ofstream out(file);
+  out << MAGIC_ << " " << id << "\n"
+      << pts_.size() << " " << keyframes_.size() << "\n";
+  for (int64_t pts: pts_) {
+    out << pts << "\n";
+  }
+  for (int keyframe: keyframes_) {
+    out << keyframe << "\n";
+  }
+
+  out.close();
+  return bool(out);
+}
+
+
+bool KeyframeIndex::load(const std::string& file, const std::string& video_file)
+{
+  pts_.clear();
+  keyframes_.clear();
+
+  std::string expected_id;
+  if (!get_video_id(video_file, expected_id)) {
+    return false;
+  }
+
+  std::ifstream in(file);
+  std::string header;
+  std::getline(in, header);
+  if (header != MAGIC_ + " " + expected_id) {
+    return false;
+  }
+
+  size_t n_frames, n_keyframes;
+  in >> n_frames >> n_keyframes;
+  pts_.resize(n_frames);
+  for (auto& pts: pts_) {
+    in >> pts;
+  }
+  keyframes_.resize(n_keyframes);
+  for (auto& keyframe: keyframes_) {
+    in >> keyframe;
+  }
+
+  if (!in) {
+    pts_.clear();
+    keyframes_.clear();
+    return false;
+  }
+  return true;
+}
+
+
+bool KeyframeIndex::get_video_id(const std::string& video_file, std::string& id)
+{
+  struct stat video_stat;
+  if (stat(video_file.c_str(), &video_stat) != 0) {
+    return false;
+  }
+
+  std::ostringstream out;
+  out << video_stat.st_size << " " << video_stat.st_mtime;
+  id = out.str();
+  return true;
+}
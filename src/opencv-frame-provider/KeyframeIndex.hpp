@@ -0,0 +1,82 @@
+/*
+ * Copyright (C) 2018-2025 Werner Turing <werner.turing@protonmail.com>
+ *
+ * This file is part of multi-delogo.
+ *
+ * multi-delogo is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * multi-delogo is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with multi-delogo.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#ifndef MDL_OPENCV_KEYFRAME_INDEX_H
+#define MDL_OPENCV_KEYFRAME_INDEX_H
+
+#include <cstdint>
+#include <string>
+#include <vector>
+#include <utility>
+
+
+namespace mdl { namespace opencv {
+  /**
+   * Keyframes and presentation timestamps (PTS) of the frames of a
+   * video, read once by demuxing it, so that frames can be reached by
+   * seeking to the keyframe before them and decoding only the rest of
+   * its group of pictures, and the frame a capture really is at can be
+   * told from the PTS of the frame read.
+   *
+   * The packets are added in the order they are stored, which is not
+   * the presentation order when there are B-frames; finish() sorts
+   * them. If the timestamps can't identify the frames, because some
+   * are missing or repeated, the index is left empty and can't be
+   * used.
+   *
+   * The index is saved to a text file, with the size and modification
+   * time of the video, so that it is discarded when the video changes.
+   */
+  class KeyframeIndex
+  {
+  public:
+    void add_packet(int64_t pts, bool keyframe);
+    void finish();
+
+    bool empty() const;
+    int get_number_of_frames() const;
+
+    /**
+     * Last keyframe at or before frame_number, or -1 if there is none.
+     */
+    int get_keyframe_before(int frame_number) const;
+
+    /**
+     * Number of the frame with this PTS, or -1 if there is none.
+     */
+    int get_frame_for_pts(int64_t pts) const;
+
+    bool save(const std::string& file, const std::string& video_file) const;
+    bool load(const std::string& file, const std::string& video_file);
+
+  private:
+    static const std::string MAGIC_;
+
+    // By frame number
+    std::vector<int64_t> pts_;
+    // Frame numbers, in order
+    std::vector<int> keyframes_;
+    // Only while being built
+    std::vector<std::pair<int64_t, bool>> packets_;
+
+    static bool get_video_id(const std::string& video_file, std::string& id);
+  };
+} }
+
+
+#endif // MDL_OPENCV_KEYFRAME_INDEX_H
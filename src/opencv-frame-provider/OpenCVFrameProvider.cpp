@@ -16,11 +16,18 @@
  * You should have received a copy of the GNU General Public License
  * along with multi-delogo.  If not, see <http://www.gnu.org/licenses/>.
  */
+#include <string>
+#include <vector>
+#include <set>
+#include <algorithm>
 #include <memory>
+#include <thread>
+#include <mutex>
 
 #include <glibmm/refptr.h>
 #include <gdkmm/pixbuf.h>
 
+#include <opencv2/core.hpp>
 #include <opencv2/videoio.hpp>
 #include <opencv2/imgproc.hpp>
 
@@ -31,57 +38,369 @@
 using namespace mdl::opencv;
 
 
-OpenCVFrameProvider::OpenCVFrameProvider(std::unique_ptr<cv::VideoCapture> video)
+// OpenCV tells the timestamp of the frames and whether a packet is a
+// keyframe only since 4.9. With older versions the keyframe index is
+// left empty
+#define HAS_PACKET_PROPERTIES (CV_VERSION_MAJOR > 4 || (CV_VERSION_MAJOR == 4 && CV_VERSION_MINOR >= 9))
+
+
+const size_t OpenCVFrameProvider::DEFAULT_CACHE_SIZE = 256 * 1024 * 1024;
+const size_t OpenCVFrameProvider::MAX_FREE_BUFFERS = 8;
+
+
+OpenCVFrameProvider::OpenCVFrameProvider(const std::string& file, std::unique_ptr<cv::VideoCapture> video,
+                                         const std::string& index_file)
   : FrameProvider()
-  , video_(std::move(video))
-  , current_frame_(-1)
+  , file_(file)
+  , buffer_pool_(FrameBufferPool::create(MAX_FREE_BUFFERS))
+  , decoder_{std::move(video), -1, cv::Mat()}
+  , index_file_(index_file)
+  , stop_requested_(false)
+  , cache_(DEFAULT_CACHE_SIZE)
+  , prefetch_decoder_{nullptr, -1, cv::Mat()}
+  , prefetching_frame_(-1)
+  , last_request_id_(0)
+  , taken_request_id_(0)
+  , ready_request_id_(0)
 {
+  // Read once, the capture is used by other threads
+  frame_width_ = decoder_.video->get(cv::CAP_PROP_FRAME_WIDTH);
+  frame_height_ = decoder_.video->get(cv::CAP_PROP_FRAME_HEIGHT);
+  number_of_frames_ = decoder_.video->get(cv::CAP_PROP_FRAME_COUNT);
+  fps_ = decoder_.video->get(cv::CAP_PROP_FPS);
+
+  frames_ready_.connect(sigc::mem_fun(*this, &OpenCVFrameProvider::on_frames_ready));
+
+  index_thread_ = std::thread(&OpenCVFrameProvider::load_or_build_index, this);
+}
+
+
+OpenCVFrameProvider::~OpenCVFrameProvider()
+{
+  {
+    std::lock_guard<std::mutex> lock(request_mutex_);
+    stop_requested_ = true;
+  }
+  request_available_.notify_one();
+  if (request_thread_.joinable()) {
+    request_thread_.join();
+  }
+
+  prefetch_queue_.stop();
+  if (prefetch_thread_.joinable()) {
+    prefetch_thread_.join();
+  }
+  if (index_thread_.joinable()) {
+    index_thread_.join();
+  }
 }
 
 
 Glib::RefPtr<Gdk::Pixbuf> OpenCVFrameProvider::get_frame(int frame_number)
 {
-  if (frame_number != current_frame_ + 1) {
-    video_->set(cv::CAP_PROP_POS_FRAMES, frame_number);
+  Glib::RefPtr<Gdk::Pixbuf> frame;
+  {
+    std::unique_lock<std::mutex> lock(cache_mutex_);
+    // Waiting for the prefetch thread is faster than decoding it again
+    frame_prefetched_.wait(lock, [this, frame_number] { return prefetching_frame_ != frame_number; });
+    if (cache_.get(frame_number, frame)) {
+      return frame;
+    }
+  }
+
+  {
+    std::lock_guard<std::mutex> lock(decoder_mutex_);
+    frame = decode_frame(decoder_, frame_number);
+  }
+
+  std::lock_guard<std::mutex> lock(cache_mutex_);
+  cache_.put(frame_number, frame, frame->get_byte_length());
+  return frame;
+}
+
+
+void OpenCVFrameProvider::request_frames(const std::vector<int>& frame_numbers, const SlotFramesReady& slot)
+{
+  {
+    std::lock_guard<std::mutex> lock(request_mutex_);
+    ++last_request_id_;
+    requested_frames_ = frame_numbers;
+    request_slot_ = slot;
+  }
+  request_available_.notify_one();
+
+  if (!request_thread_.joinable()) {
+    request_thread_ = std::thread(&OpenCVFrameProvider::request_loop, this);
+  }
+}
+
+
+void OpenCVFrameProvider::request_loop()
+{
+  while (true) {
+    unsigned long request_id;
+    std::vector<int> frame_numbers;
+    {
+      std::unique_lock<std::mutex> lock(request_mutex_);
+      request_available_.wait(lock, [this] { return stop_requested_ || last_request_id_ != taken_request_id_; });
+      if (stop_requested_) {
+        return;
+      }
+      request_id = taken_request_id_ = last_request_id_;
+      frame_numbers = requested_frames_;
+    }
+
+    std::vector<Glib::RefPtr<Gdk::Pixbuf>> frames;
+    for (int frame_number: frame_numbers) {
+      if (is_outdated(request_id)) {
+        break;
+      }
+      try {
+        frames.push_back(get_frame(frame_number));
+      } catch (const mdl::FrameNotAvailableException& e) {
+        frames.push_back(Glib::RefPtr<Gdk::Pixbuf>());
+      }
+    }
+
+    if (!is_outdated(request_id)) {
+      {
+        std::lock_guard<std::mutex> lock(request_mutex_);
+        ready_request_id_ = request_id;
+        ready_frames_ = frames;
+      }
+      frames_ready_.emit();
+    }
+  }
+}
+
+
+bool OpenCVFrameProvider::is_outdated(unsigned long request_id)
+{
+  std::lock_guard<std::mutex> lock(request_mutex_);
+  return stop_requested_ || request_id != last_request_id_;
+}
+
+
+void OpenCVFrameProvider::on_frames_ready()
+{
+  std::vector<Glib::RefPtr<Gdk::Pixbuf>> frames;
+  SlotFramesReady slot;
+  {
+    std::lock_guard<std::mutex> lock(request_mutex_);
+    if (ready_request_id_ != last_request_id_ || ready_frames_.empty()) {
+      return;
+    }
+    frames.swap(ready_frames_);
+    slot = request_slot_;
+  }
+
+  // The slot may make another request
+  slot(frames);
+}
+
+
+void OpenCVFrameProvider::prefetch(const std::vector<int>& frame_numbers)
+{
+  std::vector<int> missing;
+  {
+    std::lock_guard<std::mutex> lock(cache_mutex_);
+    // The frames prefetched take at most half of the cache, so that
+    // they don't push out each other or the frames being shown. The
+    // ones already cached count too, they are kept by being used
+    size_t frame_bytes = std::max<size_t>(1, size_t(frame_width_) * frame_height_ * 3);
+    size_t max_frames = cache_.get_max_bytes() / frame_bytes / 2;
+
+    std::set<int> wanted;
+    for (int frame_number: frame_numbers) {
+      if (wanted.size() >= max_frames) {
+        break;
+      }
+      if (frame_number < 0 || frame_number >= number_of_frames_ || !wanted.insert(frame_number).second) {
+        continue;
+      }
+      if (!cache_.contains(frame_number)) {
+        missing.push_back(frame_number);
+      }
+    }
+  }
+
+  prefetch_queue_.set_requests(missing);
+  if (!missing.empty() && !prefetch_thread_.joinable()) {
+    prefetch_thread_ = std::thread(&OpenCVFrameProvider::prefetch_loop, this);
+  }
+}
+
+
+void OpenCVFrameProvider::prefetch_loop()
+{
+  prefetch_decoder_.video.reset(new cv::VideoCapture(file_));
+  if (!prefetch_decoder_.video->isOpened()) {
+    return;
+  }
+
+  int frame_number;
+  while (prefetch_queue_.wait(frame_number)) {
+    {
+      std::lock_guard<std::mutex> lock(cache_mutex_);
+      if (cache_.contains(frame_number)) {
+        continue;
+      }
+      prefetching_frame_ = frame_number;
+    }
+
+    Glib::RefPtr<Gdk::Pixbuf> frame;
+    try {
+      frame = decode_frame(prefetch_decoder_, frame_number);
+    } catch (const mdl::FrameNotAvailableException& e) {
+      // get_frame() will report it if the frame is shown
+    }
+    finish_prefetching(frame_number, frame);
+  }
+}
+
+
+void OpenCVFrameProvider::finish_prefetching(int frame_number, const Glib::RefPtr<Gdk::Pixbuf>& frame)
+{
+  {
+    std::lock_guard<std::mutex> lock(cache_mutex_);
+    if (frame) {
+      cache_.put(frame_number, frame, frame->get_byte_length());
+    }
+    prefetching_frame_ = -1;
+  }
+  frame_prefetched_.notify_all();
+}
+
+
+void OpenCVFrameProvider::load_or_build_index()
+{
+  auto index = std::make_shared<KeyframeIndex>();
+  if (index_file_.empty() || !index->load(index_file_, file_)) {
+    if (!scan_keyframes(*index)) {
+      return;
+    }
+    if (!index_file_.empty()) {
+      index->save(index_file_, file_);
+    }
+  }
+
+  std::lock_guard<std::mutex> lock(index_mutex_);
+  index_ = index;
+}
+
+
+// The packets are only demuxed, not decoded, which is much faster.
+// Returns false if interrupted
+bool OpenCVFrameProvider::scan_keyframes(KeyframeIndex& index)
+{
+#if HAS_PACKET_PROPERTIES
+  cv::VideoCapture video(file_, cv::CAP_FFMPEG, {cv::CAP_PROP_FORMAT, -1});
+  while (video.isOpened() && video.grab()) {
+    if (stop_requested_) {
+      return false;
+    }
+    index.add_packet(video.get(cv::CAP_PROP_PTS), video.get(cv::CAP_PROP_LRF_HAS_KEY_FRAME) != 0);
+  }
+#endif
+
+  index.finish();
+  return true;
+}
+
+
+std::shared_ptr<const KeyframeIndex> OpenCVFrameProvider::get_index()
+{
+  std::lock_guard<std::mutex> lock(index_mutex_);
+  return index_;
+}
+
+
+// Positions the capture so that the next frame read is frame_number.
+// With the keyframe index the capture is sent to the keyframe before
+// the frame, unless it is already between them, and the frames up to
+// it are only grabbed. Where the capture is is taken from the PTS of
+// the frames grabbed, since the position OpenCV keeps after a seek
+// can be wrong. Without the index OpenCV seeks by itself
+void OpenCVFrameProvider::seek(Decoder& decoder, int frame_number)
+{
+  std::shared_ptr<const KeyframeIndex> index = get_index();
+  int keyframe = index ? index->get_keyframe_before(frame_number) : -1;
+  if (keyframe < 0) {
+    decoder.video->set(cv::CAP_PROP_POS_FRAMES, frame_number);
+    return;
+  }
+
+  // Next frame to be read
+  int position = decoder.current_frame + 1;
+  if (position < keyframe || position > frame_number) {
+    decoder.video->set(cv::CAP_PROP_POS_FRAMES, keyframe);
+    position = keyframe;
+  }
+
+  while (position < frame_number && decoder.video->grab()) {
+#if HAS_PACKET_PROPERTIES
+    int frame_read = index->get_frame_for_pts(decoder.video->get(cv::CAP_PROP_PTS));
+#else
+    int frame_read = -1;
+#endif
+    position = (frame_read >= 0 ? frame_read : position) + 1;
+  }
+
+  // The seek went past the frame
+  if (position > frame_number) {
+    decoder.video->set(cv::CAP_PROP_POS_FRAMES, frame_number);
+  }
+}
+
+
+Glib::RefPtr<Gdk::Pixbuf> OpenCVFrameProvider::decode_frame(Decoder& decoder, int frame_number)
+{
+  if (frame_number != decoder.current_frame + 1) {
+    seek(decoder, frame_number);
   }
-  current_frame_ = frame_number;
+  decoder.current_frame = frame_number;
 
-  cv::Mat bgr_frame;
-  bool success = video_->read(bgr_frame);
+  bool success = decoder.video->read(decoder.frame);
   if (!success) {
-    throw mdl::FrameNotAvailableException(current_frame_);
+    throw mdl::FrameNotAvailableException(decoder.current_frame);
   }
 
-  cv::cvtColor(bgr_frame, frame_, cv::COLOR_BGR2RGB);
-  return Gdk::Pixbuf::create_from_data(frame_.data,
+  // Converted straight into the memory of the pixbuf, which keeps the
+  // buffer until it is destroyed
+  FrameBufferPool::buffer_ptr buffer = buffer_pool_->acquire(decoder.frame.total() * 3);
+  cv::Mat rgb_frame(decoder.frame.rows, decoder.frame.cols, CV_8UC3, buffer.get());
+  cv::cvtColor(decoder.frame, rgb_frame, cv::COLOR_BGR2RGB);
+
+  return Gdk::Pixbuf::create_from_data(rgb_frame.data,
                                        Gdk::COLORSPACE_RGB,
                                        false, 8,
-                                       frame_.cols, frame_.rows,
-                                       frame_.step)->copy();
+                                       rgb_frame.cols, rgb_frame.rows,
+                                       rgb_frame.step,
+                                       [buffer](const guint8*) mutable { buffer.reset(); });
 }
 
 
 int OpenCVFrameProvider::get_frame_width()
 {
-  return video_->get(cv::CAP_PROP_FRAME_WIDTH);
+  return frame_width_;
 }
 
 
 int OpenCVFrameProvider::get_frame_height()
 {
-  return video_->get(cv::CAP_PROP_FRAME_HEIGHT);
+  return frame_height_;
 }
 
 
 int OpenCVFrameProvider::get_number_of_frames()
 {
-  return video_->get(cv::CAP_PROP_FRAME_COUNT);
+  return number_of_frames_;
 }
 
 
 double OpenCVFrameProvider::get_fps()
 {
-  return video_->get(cv::CAP_PROP_FPS);
+  return fps_;
 }
 
 
@@ -89,3 +408,24 @@ long OpenCVFrameProvider::get_duration()
 {
   return get_number_of_frames() / get_fps() * 1000;
 }
+
+
+void OpenCVFrameProvider::set_cache_size(size_t max_bytes)
+{
+  std::lock_guard<std::mutex> lock(cache_mutex_);
+  cache_.set_max_bytes(max_bytes);
+}
+
+
+unsigned long OpenCVFrameProvider::get_cache_hits()
+{
+  std::lock_guard<std::mutex> lock(cache_mutex_);
+  return cache_.get_hits();
+}
+
+
+unsigned long OpenCVFrameProvider::get_cache_misses()
+{
+  std::lock_guard<std::mutex> lock(cache_mutex_);
+  return cache_.get_misses();
+}
@@ -20,24 +20,47 @@
 #define MDL_OPENCV_OPENCV_FRAME_PROVIDER_H
 
 #include <string>
+#include <vector>
 #include <memory>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <atomic>
 
 #include <glibmm/objectbase.h>
 #include <glibmm/refptr.h>
+#include <glibmm/dispatcher.h>
 #include <gdkmm/pixbuf.h>
 
 #include <opencv2/videoio.hpp>
 
 #include "gui/common/FrameProvider.hpp"
 
+#include "FrameCache.hpp"
+#include "PrefetchQueue.hpp"
+#include "KeyframeIndex.hpp"
+#include "FrameBufferPool.hpp"
+
 
 namespace mdl { namespace opencv {
   class OpenCVFrameProvider : public FrameProvider
   {
   public:
-    OpenCVFrameProvider(std::unique_ptr<cv::VideoCapture> video);
+    static const size_t DEFAULT_CACHE_SIZE;
+    static const size_t MAX_FREE_BUFFERS;
+
+    /**
+     * The keyframe index is read from index_file, or built and saved
+     * to it if it is missing or outdated, in the background. If
+     * index_file is empty the index is built but not saved.
+     */
+    OpenCVFrameProvider(const std::string& file, std::unique_ptr<cv::VideoCapture> video,
+                        const std::string& index_file);
+    ~OpenCVFrameProvider();
 
     Glib::RefPtr<Gdk::Pixbuf> get_frame(int frame_number) override;
+    void request_frames(const std::vector<int>& frame_numbers, const SlotFramesReady& slot) override;
+    void prefetch(const std::vector<int>& frame_numbers) override;
 
     int get_frame_width() override;
     int get_frame_height() override;
@@ -45,11 +68,89 @@ namespace mdl { namespace opencv {
     double get_fps() override;
     long get_duration() override;
 
+    void set_cache_size(size_t max_bytes) override;
+    unsigned long get_cache_hits() override;
+    unsigned long get_cache_misses() override;
+
   private:
-    std::unique_ptr<cv::VideoCapture> video_;
-    int current_frame_;
-    // We keep a structure for the frame data in order to avoid reallocating space every time a frame is requested.
-    cv::Mat frame_;
+    // A capture and the frame it is positioned at
+    struct Decoder
+    {
+      std::unique_ptr<cv::VideoCapture> video;
+      int current_frame;
+      // Frame as decoded, in BGR, reused to avoid reallocating it for
+      // every frame
+      cv::Mat frame;
+    };
+
+    std::string file_;
+    int frame_width_;
+    int frame_height_;
+    int number_of_frames_;
+    double fps_;
+
+    // Memory of the pixbufs returned, which is given back when they
+    // are destroyed and reused for the next frames decoded
+    std::shared_ptr<FrameBufferPool> buffer_pool_;
+
+    // Used by get_frame(), which can be called by the main thread and
+    // the request thread
+    Decoder decoder_;
+    std::mutex decoder_mutex_;
+
+    // Keyframe index
+    // Null until it is loaded or built, and empty if the video can't
+    // be indexed
+    std::string index_file_;
+    std::shared_ptr<const KeyframeIndex> index_;
+    std::mutex index_mutex_;
+    std::thread index_thread_;
+    std::atomic<bool> stop_requested_;
+
+    // The pixbufs returned are shared with the cache, they must not
+    // be modified
+    FrameCache<Glib::RefPtr<Gdk::Pixbuf>> cache_;
+    std::mutex cache_mutex_;
+
+    // Prefetch
+    // The frames requested are decoded by a thread with its own
+    // capture, opened when the first frames are requested, and put in
+    // the cache
+    Decoder prefetch_decoder_;
+    PrefetchQueue prefetch_queue_;
+    std::thread prefetch_thread_;
+    // Frame being decoded by the prefetch thread, -1 if none
+    int prefetching_frame_;
+    std::condition_variable frame_prefetched_;
+
+    // Requests
+    // The latest request is taken by a thread, which stops as soon as
+    // there is a newer one. The frames are passed to the main loop by
+    // the dispatcher, which calls the slot if it is still the latest
+    std::thread request_thread_;
+    std::mutex request_mutex_;
+    std::condition_variable request_available_;
+    unsigned long last_request_id_;
+    unsigned long taken_request_id_;
+    std::vector<int> requested_frames_;
+    SlotFramesReady request_slot_; // Used only by the main thread
+    unsigned long ready_request_id_;
+    std::vector<Glib::RefPtr<Gdk::Pixbuf>> ready_frames_;
+    Glib::Dispatcher frames_ready_;
+
+    void request_loop();
+    bool is_outdated(unsigned long request_id);
+    void on_frames_ready();
+
+    void load_or_build_index();
+    bool scan_keyframes(KeyframeIndex& index);
+    std::shared_ptr<const KeyframeIndex> get_index();
+    void seek(Decoder& decoder, int frame_number);
+
+    void prefetch_loop();
+    void finish_prefetching(int frame_number, const Glib::RefPtr<Gdk::Pixbuf>& frame);
+
+    Glib::RefPtr<Gdk::Pixbuf> decode_frame(Decoder& decoder, int frame_number);
   };
 } }
 
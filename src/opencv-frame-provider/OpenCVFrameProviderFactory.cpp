@@ -29,12 +29,13 @@
 #include "OpenCVFrameProvider.hpp"
 
 
-Glib::RefPtr<mdl::FrameProvider> mdl::create_frame_provider(const std::string& movie_filename)
+Glib::RefPtr<mdl::FrameProvider> mdl::create_frame_provider(const std::string& movie_filename,
+                                                            const std::string& index_file)
 {
   std::unique_ptr<cv::VideoCapture> video(new cv::VideoCapture(movie_filename));
   if (!video->isOpened()) {
     throw mdl::VideoNotOpenedException();
   }
 
-  return Glib::RefPtr<mdl::FrameProvider>(new mdl::opencv::OpenCVFrameProvider(std::move(video)));
+  return Glib::RefPtr<mdl::FrameProvider>(new mdl::opencv::OpenCVFrameProvider(movie_filename, std::move(video), index_file));
 }
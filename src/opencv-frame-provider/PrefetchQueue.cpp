@@ -0,0 +1,86 @@
+/*
+ * Copyright (C) 2018-2025 Werner Turing <werner.turing@protonmail.com>
+ *
+ * This file is part of multi-delogo.
+ *
+ * multi-delogo is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * multi-delogo is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with multi-delogo.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include <vector>
+#include <deque>
+#include <algorithm>
+#include <mutex>
+
+#include "PrefetchQueue.hpp"
+
+using namespace mdl::opencv;
+
+
+PrefetchQueue::PrefetchQueue()
+  : stopped_(false)
+{
+}
+
+
+void PrefetchQueue::set_requests(const std::vector<int>& frame_numbers)
+{
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    frames_.clear();
+    for (int frame_number: frame_numbers) {
+      if (std::find(frames_.begin(), frames_.end(), frame_number) == frames_.end()) {
+        frames_.push_back(frame_number);
+      }
+    }
+  }
+  requests_available_.notify_one();
+}
+
+
+void PrefetchQueue::cancel()
+{
+  std::lock_guard<std::mutex> lock(mutex_);
+  frames_.clear();
+}
+
+
+void PrefetchQueue::stop()
+{
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    stopped_ = true;
+    frames_.clear();
+  }
+  requests_available_.notify_all();
+}
+
+
+bool PrefetchQueue::wait(int& frame_number)
+{
+  std::unique_lock<std::mutex> lock(mutex_);
+  requests_available_.wait(lock, [this] { return stopped_ || !frames_.empty(); });
+  if (stopped_) {
+    return false;
+  }
+
+  frame_number = frames_.front();
+  frames_.pop_front();
+  return true;
+}
+
+
+size_t PrefetchQueue::size() const
+{
+  std::lock_guard<std::mutex> lock(mutex_);
+  return frames_.size();
+}
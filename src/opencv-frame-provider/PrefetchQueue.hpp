@@ -0,0 +1,76 @@
+/*
+ * Copyright (C) 2018-2025 Werner Turing <werner.turing@protonmail.com>
+ *
+ * This file is part of multi-delogo.
+ *
+ * multi-delogo is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * multi-delogo is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with multi-delogo.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#ifndef MDL_OPENCV_PREFETCH_QUEUE_H
+#define MDL_OPENCV_PREFETCH_QUEUE_H
+
+#include <vector>
+#include <deque>
+#include <mutex>
+#include <condition_variable>
+
+
+namespace mdl { namespace opencv {
+  /**
+   * Frames to be decoded ahead by a worker thread, the ones most
+   * likely to be shown first. Each set of requests replaces the frames
+   * not yet taken, so that the worker never decodes frames for a
+   * position the user has already left.
+   *
+   * All the functions can be called by several threads at the same
+   * time.
+   */
+  class PrefetchQueue
+  {
+  public:
+    PrefetchQueue();
+
+    /**
+     * Replaces the pending frames. A frame repeated in the list keeps
+     * its first position.
+     */
+    void set_requests(const std::vector<int>& frame_numbers);
+
+    /**
+     * Drops the pending frames.
+     */
+    void cancel();
+
+    /**
+     * Makes wait() return false from now on, to stop the worker.
+     */
+    void stop();
+
+    /**
+     * Waits until there is a frame to be decoded, setting frame_number
+     * to the most likely one. Returns false when the queue is stopped.
+     */
+    bool wait(int& frame_number);
+
+    size_t size() const;
+
+  private:
+    std::deque<int> frames_;
+    bool stopped_;
+    mutable std::mutex mutex_;
+    std::condition_variable requests_available_;
+  };
+} }
+
+
+#endif // MDL_OPENCV_PREFETCH_QUEUE_H
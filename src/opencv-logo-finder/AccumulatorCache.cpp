@@ -0,0 +1,406 @@
+/*
+ * Copyright (C) 2018-2025 Werner Turing <werner.turing@protonmail.com>
+ *
+ * This file is part of multi-delogo.
+ *
+ * multi-delogo is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * multi-delogo is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with multi-delogo.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <string>
+#include <vector>
+#include <map>
+#include <fstream>
+#include <tuple>
+#include <mutex>
+
+#include <sys/stat.h>
+
+#include <opencv2/core.hpp>
+
+#include "AccumulatorCache.hpp"
+#include "FrameAccumulator.hpp"
+
+using namespace mdl::opencv;
+
+
+const uint64_t AccumulatorCache::DEFAULT_MAX_BYTES = uint64_t(2048) * 1024 * 1024;
+const char AccumulatorCache::MAGIC_[8] = {'M', 'D', 'L', 'S', 'U', 'M', 'S', '4'};
+const int AccumulatorCache::CHANNELS_ = 3;
+const int AccumulatorCache::SEGMENTS_ = 8;
+
+
+AccumulatorCache::AccumulatorCache()
+  : max_bytes_(DEFAULT_MAX_BYTES)
+  , bytes_(0)
+  , failed_(true)
+{
+}
+
+
+AccumulatorCache::~AccumulatorCache()
+{
+  close();
+}
+
+
+bool AccumulatorCache::open(const std::string& cache_file, const std::string& video_file)
+{
+  close();
+
+  struct stat video_stat;
+  if (stat(video_file.c_str(), &video_stat) != 0) {
+    return false;
+  }
+  Header expected;
+  std::memset(&expected, 0, sizeof(Header));
+  std::memcpy(expected.magic, MAGIC_, sizeof(MAGIC_));
+  expected.video_size = video_stat.st_size;
+  expected.video_mtime = video_stat.st_mtime;
+
+  cache_file_ = cache_file;
+  bool resume = read_header(cache_file, header_);
+  if (resume && (header_.video_size != expected.video_size
+                 || header_.video_mtime != expected.video_mtime)) {
+    // The cache is for another video, or a previous version of it
+    remove(cache_file);
+    resume = false;
+  }
+
+  if (!resume) {
+    header_ = expected;
+    if (!start_segment(0)) {
+      close();
+      return false;
+    }
+  } else {
+    bool complete = true;
+    for (uint32_t segment = header_.first_segment; segment <= header_.last_segment; ++segment) {
+      complete = read_segment(segment);
+    }
+
+    uint32_t last = header_.last_segment;
+    bool opened;
+    if (complete) {
+      out_.open(segment_file(cache_file_, last), std::ios::binary | std::ios::app);
+      opened = bool(out_);
+    } else {
+      // Anything after the last complete record was left by an
+      // interruption, the new sums go to another segment
+      opened = start_segment(last + 1);
+    }
+    if (!opened) {
+      close();
+      return false;
+    }
+  }
+
+  failed_ = false;
+  evict();
+  return true;
+}
+
+
+void AccumulatorCache::close()
+{
+  if (out_.is_open()) {
+    out_.close();
+  }
+  out_.clear();
+
+  cache_file_.clear();
+  index_.clear();
+  segment_bytes_.clear();
+  bytes_ = 0;
+  failed_ = true;
+}
+
+
+void AccumulatorCache::remove(const std::string& cache_file)
+{
+  Header header;
+  if (read_header(cache_file, header)) {
+    for (uint32_t segment = header.first_segment; segment <= header.last_segment; ++segment) {
+      std::remove(segment_file(cache_file, segment).c_str());
+    }
+  }
+  std::remove(cache_file.c_str());
+}
+
+
+bool AccumulatorCache::get(int start_frame, int end_frame, int frame_step, const cv::Size& frame_size,
+                           const cv::Rect& tile, bool squares, FrameAccumulator& sums)
+{
+  Key key = make_key(start_frame, end_frame, frame_step, frame_size, tile, squares);
+
+  std::lock_guard<std::mutex> lock(mutex_);
+  auto it = index_.find(key);
+  if (it == index_.end() || !it->second.readable) {
+    return false;
+  }
+  Location location = it->second;
+
+  std::ifstream in(segment_file(cache_file_, location.segment), std::ios::binary);
+  in.seekg(location.offset);
+  Record record;
+  in.read(reinterpret_cast<char*>(&record), sizeof(Record));
+  if (!in) {
+    return false;
+  }
+  buffer_.resize(padded(record.sums_size) + record.square_sums_size);
+  in.read(buffer_.data(), buffer_.size());
+  if (!in) {
+    return false;
+  }
+
+  const uint32_t* square_sums = squares
+    ? reinterpret_cast<const uint32_t*>(buffer_.data() + padded(record.sums_size))
+    : nullptr;
+  sums.load(record.height, record.width, CHANNELS_, record.frames, buffer_.data(), square_sums);
+
+  // Keeps the sums used recently in the newest segment, the last to
+  // be deleted
+  if (location.segment != header_.last_segment && !failed_) {
+    append(key, record, buffer_.data(), square_sums, true);
+  }
+  return true;
+}
+
+
+void AccumulatorCache::put(int start_frame, int end_frame, int frame_step, const cv::Size& frame_size,
+                           const cv::Rect& tile, const FrameAccumulator& sums)
+{
+  Key key = make_key(start_frame, end_frame, frame_step, frame_size, tile, sums.has_squares());
+
+  std::lock_guard<std::mutex> lock(mutex_);
+  if (failed_ || index_.count(key) > 0) {
+    return;
+  }
+
+  Record record;
+  std::memset(&record, 0, sizeof(Record));
+  record.start_frame = start_frame;
+  record.end_frame = end_frame;
+  record.frame_step = frame_step;
+  record.frame_width = frame_size.width;
+  record.frame_height = frame_size.height;
+  record.x = tile.x;
+  record.y = tile.y;
+  record.width = tile.width;
+  record.height = tile.height;
+  record.frames = sums.frames();
+  record.sums_size = sums.sums_size();
+  record.square_sums_size = sums.has_squares() ? sums.square_sums_size() : 0;
+
+  append(key, record, sums.sums(), sums.square_sums(), false);
+}
+
+
+void AccumulatorCache::set_max_bytes(uint64_t max_bytes)
+{
+  std::lock_guard<std::mutex> lock(mutex_);
+  max_bytes_ = max_bytes;
+}
+
+
+size_t AccumulatorCache::size() const
+{
+  std::lock_guard<std::mutex> lock(mutex_);
+  size_t readable = 0;
+  for (auto& entry: index_) {
+    if (entry.second.readable) {
+      ++readable;
+    }
+  }
+  return readable;
+}
+
+
+uint64_t AccumulatorCache::bytes() const
+{
+  std::lock_guard<std::mutex> lock(mutex_);
+  return bytes_;
+}
+
+
+AccumulatorCache::Key AccumulatorCache::make_key(int start_frame, int end_frame, int frame_step,
+                                                 const cv::Size& frame_size, const cv::Rect& tile, bool squares)
+{
+  return std::make_tuple(start_frame, end_frame, frame_step, frame_size.width, frame_size.height,
+                         tile.x, tile.y, tile.width, tile.height, squares);
+}
+
+
+uint64_t AccumulatorCache::padded(uint64_t size)
+{
+  // Keeps the records 8-byte aligned
+  return (size + 7) & ~uint64_t(7);
+}
+
+
+uint64_t AccumulatorCache::expected_sums_size(const Record& record)
+{
+  // Same as FrameAccumulator: 16-bit sums for up to 257 frames
+  uint64_t bytes_per_sum = record.frames > 257 ? 4 : 2;
+  return uint64_t(record.width) * record.height * CHANNELS_ * bytes_per_sum;
+}
+
+
+uint64_t AccumulatorCache::expected_square_sums_size(const Record& record)
+{
+  return uint64_t(record.width) * record.height * CHANNELS_ * sizeof(uint32_t);
+}
+
+
+std::string AccumulatorCache::segment_file(const std::string& cache_file, uint32_t segment)
+{
+  return cache_file + "." + std::to_string(segment);
+}
+
+
+bool AccumulatorCache::read_header(const std::string& cache_file, Header& header)
+{
+  std::ifstream in(cache_file, std::ios::binary);
+  in.read(reinterpret_cast<char*>(&header), sizeof(Header));
+  return in
+    && std::memcmp(header.magic, MAGIC_, sizeof(MAGIC_)) == 0
+    && header.first_segment <= header.last_segment;
+}
+
+
+bool AccumulatorCache::write_header()
+{
+  std::ofstream out(cache_file_, std::ios::binary | std::ios::trunc);
+  out.write(reinterpret_cast<const char*>(&header_), sizeof(Header));
+  out.close();
+  return bool(out);
+}
+
+
+bool AccumulatorCache::read_segment(uint32_t segment)
+{
+  std::ifstream in(segment_file(cache_file_, segment), std::ios::binary | std::ios::ate);
+  if (!in) {
+    return false;
+  }
+  uint64_t file_size = in.tellg();
+  segment_bytes_[segment] = file_size;
+  bytes_ += file_size;
+
+  uint64_t offset = 0;
+  in.seekg(0);
+  while (offset + sizeof(Record) <= file_size) {
+    Record record;
+    if (!in.read(reinterpret_cast<char*>(&record), sizeof(Record))) {
+      break;
+    }
+
+    if (record.width <= 0 || record.height <= 0 || record.frames <= 0
+        || record.sums_size != expected_sums_size(record)
+        || (record.square_sums_size != 0 && record.square_sums_size != expected_square_sums_size(record))) {
+      break;
+    }
+    uint64_t record_end = offset + sizeof(Record) + padded(record.sums_size) + padded(record.square_sums_size);
+    if (record_end > file_size) {
+      break;
+    }
+
+    // Sums copied to a newer segment are found there
+    cv::Rect tile(record.x, record.y, record.width, record.height);
+    cv::Size frame_size(record.frame_width, record.frame_height);
+    index_[make_key(record.start_frame, record.end_frame, record.frame_step, frame_size, tile,
+                    record.square_sums_size != 0)] = Location{segment, offset, true};
+    offset = record_end;
+    in.seekg(offset);
+  }
+
+  return offset == file_size;
+}
+
+
+bool AccumulatorCache::start_segment(uint32_t segment)
+{
+  if (out_.is_open()) {
+    out_.close();
+  }
+  out_.clear();
+  out_.open(segment_file(cache_file_, segment), std::ios::binary | std::ios::trunc);
+  if (!out_) {
+    return false;
+  }
+
+  header_.last_segment = segment;
+  segment_bytes_[segment] = 0;
+  return write_header();
+}
+
+
+bool AccumulatorCache::append(const Key& key, const Record& record, const void* sums, const void* square_sums,
+                              bool readable)
+{
+  uint64_t size = sizeof(Record) + padded(record.sums_size) + padded(record.square_sums_size);
+  uint32_t segment = header_.last_segment;
+  if (segment_bytes_[segment] > 0 && segment_bytes_[segment] + size > max_bytes_ / SEGMENTS_) {
+    if (!start_segment(segment + 1)) {
+      failed_ = true;
+      return false;
+    }
+    ++segment;
+  }
+
+  // The record is complete only when all of it is written, so a
+  // partial one left by an interruption is ignored when opening
+  const char zeros[8] = {0};
+  out_.write(reinterpret_cast<const char*>(&record), sizeof(Record));
+  out_.write(static_cast<const char*>(sums), record.sums_size);
+  out_.write(zeros, padded(record.sums_size) - record.sums_size);
+  out_.write(static_cast<const char*>(square_sums), record.square_sums_size);
+  out_.write(zeros, padded(record.square_sums_size) - record.square_sums_size);
+  out_.flush();
+  if (!out_) {
+    // Probably the disk is full, stop trying. The partial record is
+    // ignored when the cache is opened again
+    failed_ = true;
+    return false;
+  }
+
+  index_[key] = Location{segment, segment_bytes_[segment], readable};
+  segment_bytes_[segment] += size;
+  bytes_ += size;
+  evict();
+  return true;
+}
+
+
+void AccumulatorCache::evict()
+{
+  while (bytes_ > max_bytes_ && header_.first_segment < header_.last_segment) {
+    uint32_t segment = header_.first_segment;
+    for (auto it = index_.begin(); it != index_.end(); ) {
+      if (it->second.segment == segment) {
+        it = index_.erase(it);
+      } else {
+        ++it;
+      }
+    }
+    bytes_ -= segment_bytes_[segment];
+    segment_bytes_.erase(segment);
+    std::remove(segment_file(cache_file_, segment).c_str());
+
+    ++header_.first_segment;
+    write_header();
+  }
+}
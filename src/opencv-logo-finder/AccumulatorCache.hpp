@@ -0,0 +1,173 @@
+/*
+ * Copyright (C) 2018-2025 Werner Turing <werner.turing@protonmail.com>
+ *
+ * This file is part of multi-delogo.
+ *
+ * multi-delogo is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * multi-delogo is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with multi-delogo.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#ifndef MDL_OPENCV_ACCUMULATOR_CACHE_H
+#define MDL_OPENCV_ACCUMULATOR_CACHE_H
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+#include <map>
+#include <fstream>
+#include <tuple>
+#include <mutex>
+
+#include <opencv2/core.hpp>
+
+#include "FrameAccumulator.hpp"
+
+
+namespace mdl { namespace opencv {
+  /**
+   * Keeps the sums of the sampled frames of each subinterval on disk,
+   * so that searching the same part of a video again, with other logo
+   * sizes for instance, does not need to decode it.
+   *
+   * A sum is identified by its subinterval, the step between the
+   * sampled frames, the size the frames were reduced to and the part
+   * of them (search tile) it covers, and whether it includes the sums
+   * of the squares.
+   *
+   * The sums are appended to segment files named after the cache file
+   * with a number added, "cache.sums.0", "cache.sums.1" and so on.
+   * The cache file itself only identifies the video, by its size and
+   * modification time, and lists the segments; all of them are
+   * deleted when the video changes. When the segments take more than
+   * the maximum size, the oldest one is deleted. The sums read from
+   * an older segment are copied to the newest one, so the sums
+   * deleted are approximately the least recently used.
+   *
+   * get() and put() can be called by several threads at the same
+   * time, but not while the cache is being opened or closed.
+   */
+  class AccumulatorCache
+  {
+  public:
+    const static uint64_t DEFAULT_MAX_BYTES;
+
+    AccumulatorCache();
+    ~AccumulatorCache();
+
+    /**
+     * Opens the cache file, creating it if needed. The sums put since
+     * the last time it was opened become available. Returns false if
+     * the file can't be used, in which case nothing is cached.
+     */
+    bool open(const std::string& cache_file, const std::string& video_file);
+    void close();
+
+    /**
+     * Deletes the cache file and its segments. The cache must not be
+     * open.
+     */
+    static void remove(const std::string& cache_file);
+
+    bool get(int start_frame, int end_frame, int frame_step, const cv::Size& frame_size,
+             const cv::Rect& tile, bool squares, FrameAccumulator& sums);
+    void put(int start_frame, int end_frame, int frame_step, const cv::Size& frame_size,
+             const cv::Rect& tile, const FrameAccumulator& sums);
+
+    /**
+     * Maximum size of the segments. Applies from the next time the
+     * cache is opened or sums are put.
+     */
+    void set_max_bytes(uint64_t max_bytes);
+
+    /**
+     * Number of sums that can be read.
+     */
+    size_t size() const;
+
+    /**
+     * Size of the segments.
+     */
+    uint64_t bytes() const;
+
+  private:
+    struct Header
+    {
+      char magic[8];
+      uint64_t video_size;
+      int64_t video_mtime;
+      uint32_t first_segment;
+      uint32_t last_segment;
+    };
+
+    struct Record
+    {
+      int32_t start_frame;
+      int32_t end_frame;
+      int32_t frame_step;
+      int32_t frame_width;
+      int32_t frame_height;
+      int32_t x;
+      int32_t y;
+      int32_t width;
+      int32_t height;
+      int32_t frames;
+      uint64_t sums_size;
+      uint64_t square_sums_size;
+    };
+
+    struct Location
+    {
+      uint32_t segment;
+      uint64_t offset;
+      // False for the sums put after opening
+      bool readable;
+    };
+
+    typedef std::tuple<int, int, int, int, int, int, int, int, int, bool> Key;
+
+    const static char MAGIC_[8];
+    const static int CHANNELS_;
+    // Number of segments the maximum size is divided in
+    const static int SEGMENTS_;
+
+    std::string cache_file_;
+    Header header_;
+    uint64_t max_bytes_;
+    std::map<Key, Location> index_;
+    std::map<uint32_t, uint64_t> segment_bytes_;
+    uint64_t bytes_;
+    // Appends to the last segment
+    std::ofstream out_;
+    bool failed_;
+    std::vector<char> buffer_;
+    mutable std::mutex mutex_;
+
+    static Key make_key(int start_frame, int end_frame, int frame_step, const cv::Size& frame_size,
+                        const cv::Rect& tile, bool squares);
+    static uint64_t padded(uint64_t size);
+    static uint64_t expected_sums_size(const Record& record);
+    static uint64_t expected_square_sums_size(const Record& record);
+    static std::string segment_file(const std::string& cache_file, uint32_t segment);
+    static bool read_header(const std::string& cache_file, Header& header);
+
+    bool write_header();
+    bool read_segment(uint32_t segment);
+    bool start_segment(uint32_t segment);
+    bool append(const Key& key, const Record& record, const void* sums, const void* square_sums,
+                bool readable);
+    void evict();
+  };
+} }
+
+
+#endif // MDL_OPENCV_ACCUMULATOR_CACHE_H
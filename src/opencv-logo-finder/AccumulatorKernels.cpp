@@ -0,0 +1,243 @@
+/*
+ * Copyright (C) 2018-2025 Werner Turing <werner.turing@protonmail.com>
+ *
+ * This file is part of multi-delogo.
+ *
+ * multi-delogo is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * multi-delogo is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with multi-delogo.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include <cstddef>
+#include <cstdint>
+
+#if (defined(__x86_64__) || defined(__i386__)) && defined(__GNUC__)
+#define MDL_X86_KERNELS
+#include <immintrin.h>
+#endif
+
+#include "AccumulatorKernels.hpp"
+
+using namespace mdl::opencv;
+
+
+namespace {
+  void add_u8_to_u16_generic(const uint8_t* src, uint16_t* sums, size_t n)
+  {
+    for (size_t i = 0; i < n; ++i) {
+      sums[i] += src[i];
+    }
+  }
+
+
+  void add_u8_to_u32_generic(const uint8_t* src, uint32_t* sums, size_t n)
+  {
+    for (size_t i = 0; i < n; ++i) {
+      sums[i] += src[i];
+    }
+  }
+
+
+  void add_squares_u8_to_u32_generic(const uint8_t* src, uint32_t* sums, size_t n)
+  {
+    for (size_t i = 0; i < n; ++i) {
+      sums[i] += uint32_t(src[i]) * src[i];
+    }
+  }
+
+
+#ifdef MDL_X86_KERNELS
+  __attribute__((target("sse2")))
+  void add_u8_to_u16_sse2(const uint8_t* src, uint16_t* sums, size_t n)
+  {
+    const __m128i zero = _mm_setzero_si128();
+    size_t i = 0;
+    for (; i + 16 <= n; i += 16) {
+      __m128i pixels = _mm_loadu_si128((const __m128i*) (src + i));
+      __m128i* s = (__m128i*) (sums + i);
+      _mm_storeu_si128(s, _mm_add_epi16(_mm_loadu_si128(s), _mm_unpacklo_epi8(pixels, zero)));
+      _mm_storeu_si128(s + 1, _mm_add_epi16(_mm_loadu_si128(s + 1), _mm_unpackhi_epi8(pixels, zero)));
+    }
+    add_u8_to_u16_generic(src + i, sums + i, n - i);
+  }
+
+
+  __attribute__((target("sse2")))
+  void add_u8_to_u32_sse2(const uint8_t* src, uint32_t* sums, size_t n)
+  {
+    const __m128i zero = _mm_setzero_si128();
+    size_t i = 0;
+    for (; i + 16 <= n; i += 16) {
+      __m128i pixels = _mm_loadu_si128((const __m128i*) (src + i));
+      __m128i lo = _mm_unpacklo_epi8(pixels, zero);
+      __m128i hi = _mm_unpackhi_epi8(pixels, zero);
+      __m128i* s = (__m128i*) (sums + i);
+      _mm_storeu_si128(s, _mm_add_epi32(_mm_loadu_si128(s), _mm_unpacklo_epi16(lo, zero)));
+      _mm_storeu_si128(s + 1, _mm_add_epi32(_mm_loadu_si128(s + 1), _mm_unpackhi_epi16(lo, zero)));
+      _mm_storeu_si128(s + 2, _mm_add_epi32(_mm_loadu_si128(s + 2), _mm_unpacklo_epi16(hi, zero)));
+      _mm_storeu_si128(s + 3, _mm_add_epi32(_mm_loadu_si128(s + 3), _mm_unpackhi_epi16(hi, zero)));
+    }
+    add_u8_to_u32_generic(src + i, sums + i, n - i);
+  }
+
+
+  // 255 * 255 = 65025 fits in 16 bits, so the low half of the 16-bit
+  // product is exact
+  __attribute__((target("sse2")))
+  void add_squares_u8_to_u32_sse2(const uint8_t* src, uint32_t* sums, size_t n)
+  {
+    const __m128i zero = _mm_setzero_si128();
+    size_t i = 0;
+    for (; i + 16 <= n; i += 16) {
+      __m128i pixels = _mm_loadu_si128((const __m128i*) (src + i));
+      __m128i lo = _mm_unpacklo_epi8(pixels, zero);
+      __m128i hi = _mm_unpackhi_epi8(pixels, zero);
+      lo = _mm_mullo_epi16(lo, lo);
+      hi = _mm_mullo_epi16(hi, hi);
+      __m128i* s = (__m128i*) (sums + i);
+      _mm_storeu_si128(s, _mm_add_epi32(_mm_loadu_si128(s), _mm_unpacklo_epi16(lo, zero)));
+      _mm_storeu_si128(s + 1, _mm_add_epi32(_mm_loadu_si128(s + 1), _mm_unpackhi_epi16(lo, zero)));
+      _mm_storeu_si128(s + 2, _mm_add_epi32(_mm_loadu_si128(s + 2), _mm_unpacklo_epi16(hi, zero)));
+      _mm_storeu_si128(s + 3, _mm_add_epi32(_mm_loadu_si128(s + 3), _mm_unpackhi_epi16(hi, zero)));
+    }
+    add_squares_u8_to_u32_generic(src + i, sums + i, n - i);
+  }
+
+
+  __attribute__((target("avx2")))
+  void add_u8_to_u16_avx2(const uint8_t* src, uint16_t* sums, size_t n)
+  {
+    size_t i = 0;
+    for (; i + 32 <= n; i += 32) {
+      __m128i lo = _mm_loadu_si128((const __m128i*) (src + i));
+      __m128i hi = _mm_loadu_si128((const __m128i*) (src + i + 16));
+      __m256i* s = (__m256i*) (sums + i);
+      _mm256_storeu_si256(s, _mm256_add_epi16(_mm256_loadu_si256(s), _mm256_cvtepu8_epi16(lo)));
+      _mm256_storeu_si256(s + 1, _mm256_add_epi16(_mm256_loadu_si256(s + 1), _mm256_cvtepu8_epi16(hi)));
+    }
+    add_u8_to_u16_generic(src + i, sums + i, n - i);
+  }
+
+
+  __attribute__((target("avx2")))
+  void add_u8_to_u32_avx2(const uint8_t* src, uint32_t* sums, size_t n)
+  {
+    size_t i = 0;
+    for (; i + 16 <= n; i += 16) {
+      __m128i lo = _mm_loadl_epi64((const __m128i*) (src + i));
+      __m128i hi = _mm_loadl_epi64((const __m128i*) (src + i + 8));
+      __m256i* s = (__m256i*) (sums + i);
+      _mm256_storeu_si256(s, _mm256_add_epi32(_mm256_loadu_si256(s), _mm256_cvtepu8_epi32(lo)));
+      _mm256_storeu_si256(s + 1, _mm256_add_epi32(_mm256_loadu_si256(s + 1), _mm256_cvtepu8_epi32(hi)));
+    }
+    add_u8_to_u32_generic(src + i, sums + i, n - i);
+  }
+
+
+  __attribute__((target("avx2")))
+  void add_squares_u8_to_u32_avx2(const uint8_t* src, uint32_t* sums, size_t n)
+  {
+    size_t i = 0;
+    for (; i + 16 <= n; i += 16) {
+      __m256i pixels = _mm256_cvtepu8_epi16(_mm_loadu_si128((const __m128i*) (src + i)));
+      __m256i squares = _mm256_mullo_epi16(pixels, pixels);
+      __m256i* s = (__m256i*) (sums + i);
+      _mm256_storeu_si256(s, _mm256_add_epi32(_mm256_loadu_si256(s),
+                                              _mm256_cvtepu16_epi32(_mm256_castsi256_si128(squares))));
+      _mm256_storeu_si256(s + 1, _mm256_add_epi32(_mm256_loadu_si256(s + 1),
+                                                  _mm256_cvtepu16_epi32(_mm256_extracti128_si256(squares, 1))));
+    }
+    add_squares_u8_to_u32_generic(src + i, sums + i, n - i);
+  }
+#endif
+
+
+  struct Kernels
+  {
+    void (*add_u8_to_u16)(const uint8_t*, uint16_t*, size_t);
+    void (*add_u8_to_u32)(const uint8_t*, uint32_t*, size_t);
+    void (*add_squares_u8_to_u32)(const uint8_t*, uint32_t*, size_t);
+    const char* name;
+  };
+
+
+  Kernels select_kernels()
+  {
+#ifdef MDL_X86_KERNELS
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("avx2")) {
+      return Kernels{add_u8_to_u16_avx2, add_u8_to_u32_avx2, add_squares_u8_to_u32_avx2, "avx2"};
+    }
+    if (__builtin_cpu_supports("sse2")) {
+      return Kernels{add_u8_to_u16_sse2, add_u8_to_u32_sse2, add_squares_u8_to_u32_sse2, "sse2"};
+    }
+#endif
+    return Kernels{add_u8_to_u16_generic, add_u8_to_u32_generic, add_squares_u8_to_u32_generic, "generic"};
+  }
+
+
+  const Kernels& kernels()
+  {
+    static const Kernels selected = select_kernels();
+    return selected;
+  }
+}
+
+
+void AccumulatorKernels::add_u8_to_u16(const uint8_t* src, uint16_t* sums, size_t n)
+{
+  kernels().add_u8_to_u16(src, sums, n);
+}
+
+
+void AccumulatorKernels::add_u8_to_u32(const uint8_t* src, uint32_t* sums, size_t n)
+{
+  kernels().add_u8_to_u32(src, sums, n);
+}
+
+
+void AccumulatorKernels::add_squares_u8_to_u32(const uint8_t* src, uint32_t* sums, size_t n)
+{
+  kernels().add_squares_u8_to_u32(src, sums, n);
+}
+
+
+// The ones below are used only when merging sums, once per
+// subinterval, so the compiler's vectorization is enough
+
+void AccumulatorKernels::add_u16_to_u16(const uint16_t* src, uint16_t* sums, size_t n)
+{
+  for (size_t i = 0; i < n; ++i) {
+    sums[i] += src[i];
+  }
+}
+
+
+void AccumulatorKernels::add_u16_to_u32(const uint16_t* src, uint32_t* sums, size_t n)
+{
+  for (size_t i = 0; i < n; ++i) {
+    sums[i] += src[i];
+  }
+}
+
+
+void AccumulatorKernels::add_u32_to_u32(const uint32_t* src, uint32_t* sums, size_t n)
+{
+  for (size_t i = 0; i < n; ++i) {
+    sums[i] += src[i];
+  }
+}
+
+
+const char* AccumulatorKernels::implementation()
+{
+  return kernels().name;
+}
@@ -0,0 +1,48 @@
+/*
+ * Copyright (C) 2018-2025 Werner Turing <werner.turing@protonmail.com>
+ *
+ * This file is part of multi-delogo.
+ *
+ * multi-delogo is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * multi-delogo is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with multi-delogo.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#ifndef MDL_OPENCV_ACCUMULATOR_KERNELS_H
+#define MDL_OPENCV_ACCUMULATOR_KERNELS_H
+
+#include <cstddef>
+#include <cstdint>
+
+
+namespace mdl { namespace opencv {
+  /**
+   * Kernels that add rows of 8-bit pixels, or their squares, to rows
+   * of sums. The best implementation for the processor (AVX2, SSE2 or plain C++) is
+   * selected at runtime.
+   */
+  class AccumulatorKernels
+  {
+  public:
+    static void add_u8_to_u16(const uint8_t* src, uint16_t* sums, size_t n);
+    static void add_u8_to_u32(const uint8_t* src, uint32_t* sums, size_t n);
+    static void add_squares_u8_to_u32(const uint8_t* src, uint32_t* sums, size_t n);
+
+    static void add_u16_to_u16(const uint16_t* src, uint16_t* sums, size_t n);
+    static void add_u16_to_u32(const uint16_t* src, uint32_t* sums, size_t n);
+    static void add_u32_to_u32(const uint32_t* src, uint32_t* sums, size_t n);
+
+    static const char* implementation();
+  };
+} }
+
+
+#endif // MDL_OPENCV_ACCUMULATOR_KERNELS_H
@@ -0,0 +1,154 @@
+/*
+ * Copyright (C) 2018-2025 Werner Turing <werner.turing@protonmail.com>
+ *
+ * This file is part of multi-delogo.
+ *
+ * multi-delogo is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * multi-delogo is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with multi-delogo.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include <cstdint>
+#include <vector>
+#include <algorithm>
+
+#include <opencv2/core.hpp>
+#include <opencv2/imgproc.hpp>
+
+#include "BoxExtractor.hpp"
+
+using namespace mdl::opencv;
+
+
+void BoxExtractor::extract_masks(const cv::Mat& frame, int threshold, int close_radius,
+                                 const cv::Mat& allowed)
+{
+  CV_Assert(frame.type() == CV_8UC3);
+  CV_Assert(allowed.empty() || (allowed.type() == CV_8U && allowed.size() == frame.size()));
+
+  int width = frame.cols;
+  for (auto& mask: masks_) {
+    mask.create(frame.rows, width, CV_8U);
+  }
+  column_max_.resize(width * 3);
+  column_min_.resize(width * 3);
+  above_.resize(width);
+  sums_.resize(width + 1);
+
+  for (int row = 0; row < frame.rows; ++row) {
+    calculate_column_extremes(frame, row);
+    const uint8_t* allowed_row = allowed.empty() ? nullptr : allowed.ptr<uint8_t>(row);
+
+    for (int channel = 0; channel < 3; ++channel) {
+      // Gradient of the 3x3 neighbourhood, ignoring the pixels
+      // outside the frame
+      for (int x = 0; x < width; ++x) {
+        int first = std::max(x - 1, 0) * 3 + channel;
+        int last = std::min(x + 1, width - 1) * 3 + channel;
+
+        uint8_t max = column_max_[first];
+        uint8_t min = column_min_[first];
+        for (int i = first + 3; i <= last; i += 3) {
+          max = std::max(max, column_max_[i]);
+          min = std::min(min, column_min_[i]);
+        }
+
+        above_[x] = (max - min) > threshold && (!allowed_row || allowed_row[x]);
+      }
+
+      close_row(width, close_radius, masks_[channel].ptr<uint8_t>(row));
+    }
+  }
+}
+
+
+const cv::Mat& BoxExtractor::get_mask(int channel) const
+{
+  return masks_[channel];
+}
+
+
+cv::Rect BoxExtractor::find_box(int channel, const cv::Size& min_size, const cv::Size& max_size)
+{
+  int n_labels = cv::connectedComponentsWithStats(masks_[channel], labels_, stats_, centroids_, 8, CV_32S);
+
+  // Label 0 is the background
+  for (int label = 1; label < n_labels; ++label) {
+    const int* stats = stats_.ptr<int>(label);
+    cv::Rect box(stats[cv::CC_STAT_LEFT], stats[cv::CC_STAT_TOP],
+                 stats[cv::CC_STAT_WIDTH], stats[cv::CC_STAT_HEIGHT]);
+    if ((box.width >= min_size.width && box.width <= max_size.width)
+        && (box.height >= min_size.height && box.height <= max_size.height)) {
+      return box;
+    }
+  }
+
+  return cv::Rect(0, 0, 0, 0);
+}
+
+
+void BoxExtractor::find_boxes(int channel, const cv::Size& min_size, const cv::Size& max_size,
+                              const cv::Point& offset, std::vector<ScoredBox>& boxes)
+{
+  int n_labels = cv::connectedComponentsWithStats(masks_[channel], labels_, stats_, centroids_, 8, CV_32S);
+
+  for (int label = 1; label < n_labels; ++label) {
+    const int* stats = stats_.ptr<int>(label);
+    cv::Rect box(stats[cv::CC_STAT_LEFT], stats[cv::CC_STAT_TOP],
+                 stats[cv::CC_STAT_WIDTH], stats[cv::CC_STAT_HEIGHT]);
+    if ((box.width >= min_size.width && box.width <= max_size.width)
+        && (box.height >= min_size.height && box.height <= max_size.height)) {
+      boxes.push_back(ScoredBox{box + offset, double(stats[cv::CC_STAT_AREA]) / box.area()});
+    }
+  }
+}
+
+
+void BoxExtractor::calculate_column_extremes(const cv::Mat& frame, int row)
+{
+  const uint8_t* above = frame.ptr<uint8_t>(std::max(row - 1, 0));
+  const uint8_t* current = frame.ptr<uint8_t>(row);
+  const uint8_t* below = frame.ptr<uint8_t>(std::min(row + 1, frame.rows - 1));
+
+  size_t n = column_max_.size();
+  for (size_t i = 0; i < n; ++i) {
+    column_max_[i] = std::max(std::max(above[i], current[i]), below[i]);
+    column_min_[i] = std::min(std::min(above[i], current[i]), below[i]);
+  }
+}
+
+
+void BoxExtractor::close_row(int width, int close_radius, uint8_t* mask_row)
+{
+  // Dilation: a pixel is set if any pixel within close_radius is
+  // above the threshold. The pixels outside the frame are not set
+  sums_[0] = 0;
+  for (int x = 0; x < width; ++x) {
+    sums_[x + 1] = sums_[x] + above_[x];
+  }
+  for (int x = 0; x < width; ++x) {
+    int first = std::max(x - close_radius, 0);
+    int last = std::min(x + close_radius, width - 1);
+    mask_row[x] = (sums_[last + 1] - sums_[first]) > 0;
+  }
+
+  // Erosion: a pixel stays set if all pixels within close_radius are
+  // set. The pixels outside the frame count as set
+  sums_[0] = 0;
+  for (int x = 0; x < width; ++x) {
+    sums_[x + 1] = sums_[x] + mask_row[x];
+  }
+  for (int x = 0; x < width; ++x) {
+    int first = std::max(x - close_radius, 0);
+    int last = std::min(x + close_radius, width - 1);
+    mask_row[x] = (sums_[last + 1] - sums_[first]) == (last - first + 1) ? 255 : 0;
+  }
+}
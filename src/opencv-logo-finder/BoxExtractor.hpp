@@ -0,0 +1,108 @@
+/*
+ * Copyright (C) 2018-2025 Werner Turing <werner.turing@protonmail.com>
+ *
+ * This file is part of multi-delogo.
+ *
+ * multi-delogo is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * multi-delogo is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with multi-delogo.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#ifndef MDL_OPENCV_BOX_EXTRACTOR_H
+#define MDL_OPENCV_BOX_EXTRACTOR_H
+
+#include <cstdint>
+#include <vector>
+
+#include <opencv2/core.hpp>
+
+
+namespace mdl { namespace opencv {
+  /**
+   * Box of a connected component, with the fraction of its area
+   * covered by the component. The outline of a logo, closed, fills
+   * most of its box, the edges left in the background much less.
+   */
+  struct ScoredBox
+  {
+    cv::Rect box;
+    double score;
+  };
+
+
+  /**
+   * Finds boxes in the three channels of a frame.
+   *
+   * Does the same as a 3x3 morphological gradient, a threshold and a
+   * horizontal morphological close of each channel, but in a single
+   * pass over the rows of the frame, for all channels at once. The
+   * boxes are then taken from the statistics of the connected
+   * components of the result. All the buffers are kept between
+   * calls, so nothing is allocated when the frame size does not
+   * change.
+   */
+  class BoxExtractor
+  {
+  public:
+    /**
+     * Calculates the masks of a CV_8UC3 frame. Pixels whose gradient
+     * is above threshold are set, and then gaps of up to
+     * 2*close_radius pixels between them in each row are closed. If
+     * allowed (CV_8U, the size of the frame) is given, only the
+     * pixels that are not 0 in it can be above the threshold.
+     */
+    void extract_masks(const cv::Mat& frame, int threshold, int close_radius,
+                       const cv::Mat& allowed = cv::Mat());
+
+    /**
+     * Returns the mask of a channel calculated by extract_masks(),
+     * with 255 in the pixels that are set and 0 in the others.
+     */
+    const cv::Mat& get_mask(int channel) const;
+
+    /**
+     * Returns the bounding box of the first connected component (in
+     * raster order) of the mask of a channel whose size is within
+     * the limits, or an empty rectangle if there is none.
+     */
+    cv::Rect find_box(int channel, const cv::Size& min_size, const cv::Size& max_size);
+
+    /**
+     * Adds to boxes the bounding boxes of all the connected components
+     * of the mask of a channel whose size is within the limits, in
+     * raster order (so the first one is the box of find_box()), moved
+     * by offset.
+     */
+    void find_boxes(int channel, const cv::Size& min_size, const cv::Size& max_size,
+                    const cv::Point& offset, std::vector<ScoredBox>& boxes);
+
+  private:
+    cv::Mat masks_[3];
+
+    // Rows with the maximum and minimum of each pixel and the pixels
+    // above and below it
+    std::vector<uint8_t> column_max_;
+    std::vector<uint8_t> column_min_;
+    // Rows of each channel above the threshold, and their prefix sums
+    std::vector<uint8_t> above_;
+    std::vector<int> sums_;
+
+    cv::Mat labels_;
+    cv::Mat stats_;
+    cv::Mat centroids_;
+
+    void calculate_column_extremes(const cv::Mat& frame, int row);
+    void close_row(int width, int close_radius, uint8_t* mask_row);
+  };
+} }
+
+
+#endif // MDL_OPENCV_BOX_EXTRACTOR_H
@@ -16,6 +16,9 @@
  * You should have received a copy of the GNU General Public License
  * along with multi-delogo.  If not, see <http://www.gnu.org/licenses/>.
  */
+#include <vector>
+#include <iterator>
+
 #include "filter-generator/FilterList.hpp"
 #include "filter-generator/Filters.hpp"
 
@@ -33,8 +36,14 @@ FilterListAdapter::FilterListAdapter(fg::FilterList& filter_list, LogoFinderCall
 
 void FilterListAdapter::success(const mdl::LogoFinderResult& result)
 {
+  remove_review_filters(result.start_frame + 1, result.end_frame + 1);
+  std::vector<fg::DelogoRegion> other_regions;
+  for (auto& logo: result.other_logos) {
+    other_regions.push_back(fg::DelogoRegion{logo.x, logo.y, logo.width, logo.height});
+  }
   filter_list_.insert(result.start_frame + 1,
-                      fg::filter_ptr(new fg::DelogoFilter(result.x, result.y, result.width, result.height)));
+                      fg::filter_ptr(new fg::DelogoFilter(result.x, result.y, result.width, result.height,
+                                                          other_regions)));
 
   callback_.success(result);
 }
@@ -42,7 +51,48 @@ void FilterListAdapter::success(const mdl::LogoFinderResult& result)
 
 void FilterListAdapter::failure(int start_frame, int end_frame)
 {
+  remove_review_filters(start_frame + 1, end_frame + 1);
   filter_list_.insert(start_frame + 1, fg::filter_ptr(new fg::ReviewFilter()));
 
   callback_.failure(start_frame, end_frame);
 }
+
+
+void FilterListAdapter::remove_review_filters(int first_frame, int last_frame)
+{
+  // Left by a previous search of the same frames, they would split
+  // the new filter
+  std::vector<int> review_frames;
+  for (auto& filter: filter_list_) {
+    if (filter.first > first_frame && filter.first <= last_frame
+        && filter.second->type() == fg::FilterType::REVIEW) {
+      review_frames.push_back(filter.first);
+    }
+  }
+
+  for (int frame: review_frames) {
+    filter_list_.remove(frame);
+  }
+}
+
+
+std::vector<LogoSearchRange> mdl::get_review_ranges(const fg::FilterList& filter_list, int total_frames)
+{
+  std::vector<LogoSearchRange> ranges;
+  for (auto it = filter_list.begin(); it != filter_list.end(); ++it) {
+    if (it->second->type() != fg::FilterType::REVIEW) {
+      continue;
+    }
+
+    auto next = std::next(it);
+    int start_frame = it->first - 1;
+    int end_frame = next == filter_list.end() ? total_frames : next->first - 1;
+    if (!ranges.empty() && ranges.back().end_frame == start_frame) {
+      ranges.back().end_frame = end_frame;
+    } else {
+      ranges.push_back(LogoSearchRange{start_frame, end_frame});
+    }
+  }
+
+  return ranges;
+}
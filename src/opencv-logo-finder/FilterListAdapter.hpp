@@ -20,6 +20,8 @@
 #define MDL_FILTER_LIST_ADAPATER_H
 
 #include <memory>
+#include <vector>
+#include <string>
 
 #include "filter-generator/FilterData.hpp"
 #include "filter-generator/FilterList.hpp"
@@ -38,10 +40,27 @@ namespace mdl {
   private:
     fg::FilterList& filter_list_;
     LogoFinderCallback& callback_;
+
+    void remove_review_filters(int first_frame, int last_frame);
   };
 
 
+  /**
+   * Ranges of the frames covered by review filters, in the numbering
+   * of the logo finder (starting at 0), with adjacent ones joined.
+   * The range of a review filter that is the last one ends at
+   * total_frames.
+   */
+  std::vector<LogoSearchRange> get_review_ranges(const fg::FilterList& filter_list, int total_frames);
+
+
   std::shared_ptr<LogoFinder> create_logo_finder(fg::FilterData& filter_data, LogoFinderCallback& callback, bool verbose);
+
+  /**
+   * Deletes a cache file set with LogoFinder::set_cache_file(), with
+   * the files of the sums next to it.
+   */
+  void remove_logo_finder_cache(const std::string& cache_file);
 }
 
 
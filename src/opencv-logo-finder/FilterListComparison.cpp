@@ -0,0 +1,51 @@
+/*
+ * Copyright (C) 2018-2025 Werner Turing <werner.turing@protonmail.com>
+ *
+ * This file is part of multi-delogo.
+ *
+ * multi-delogo is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * multi-delogo is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with multi-delogo.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include "filter-generator/FilterList.hpp"
+#include "filter-generator/Filters.hpp"
+
+#include "FilterListComparison.hpp"
+
+using namespace mdl;
+
+
+FilterListComparison FilterListComparison::compare(const fg::FilterList& reference, const fg::FilterList& filters)
+{
+  FilterListComparison comparison{};
+  comparison.reference_filters = reference.size();
+  comparison.filters = filters.size();
+
+  for (auto& entry: reference) {
+    auto other = filters.get_by_start_frame(entry.first);
+    if (!other) {
+      ++comparison.missing;
+    } else if (other->second->save_str() == entry.second->save_str()) {
+      ++comparison.equal;
+    } else {
+      ++comparison.different;
+    }
+  }
+
+  for (auto& entry: filters) {
+    if (entry.second->type() == fg::FilterType::REVIEW) {
+      ++comparison.review;
+    }
+  }
+
+  return comparison;
+}
@@ -0,0 +1,61 @@
+/*
+ * Copyright (C) 2018-2025 Werner Turing <werner.turing@protonmail.com>
+ *
+ * This file is part of multi-delogo.
+ *
+ * multi-delogo is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * multi-delogo is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with multi-delogo.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#ifndef MDL_FILTER_LIST_COMPARISON_H
+#define MDL_FILTER_LIST_COMPARISON_H
+
+#include "filter-generator/FilterList.hpp"
+
+
+namespace mdl {
+  /**
+   * Compares the filters found by the logo finder with a reference
+   * filter list, usually one that was checked by hand. Filters are
+   * matched by their start frames.
+   */
+  class FilterListComparison
+  {
+  public:
+    static FilterListComparison compare(const fg::FilterList& reference, const fg::FilterList& filters);
+
+    int reference_filters;
+    int filters;
+    /**
+     * Filters equal to the filter of the reference that starts in the
+     * same frame.
+     */
+    int equal;
+    /**
+     * Filters that start in the same frame as a filter of the
+     * reference, but are not equal to it.
+     */
+    int different;
+    /**
+     * Filters of the reference with no filter starting in the same
+     * frame.
+     */
+    int missing;
+    /**
+     * Filters where no logo was found, which have to be reviewed.
+     */
+    int review;
+  };
+}
+
+
+#endif // MDL_FILTER_LIST_COMPARISON_H
@@ -0,0 +1,264 @@
+/*
+ * Copyright (C) 2018-2025 Werner Turing <werner.turing@protonmail.com>
+ *
+ * This file is part of multi-delogo.
+ *
+ * multi-delogo is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * multi-delogo is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with multi-delogo.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include <cstdint>
+#include <cstring>
+#include <cmath>
+#include <vector>
+
+#include <opencv2/core.hpp>
+
+#include "FrameAccumulator.hpp"
+#include "AccumulatorKernels.hpp"
+
+using namespace mdl::opencv;
+
+
+// 257 * 255 = 65535
+const int FrameAccumulator::MAX_NARROW_FRAMES_ = 257;
+// 66051 * 255 * 255 < 2^32
+const int FrameAccumulator::MAX_SQUARE_FRAMES_ = 66051;
+
+
+FrameAccumulator::FrameAccumulator()
+  : rows_(0)
+  , cols_(0)
+  , channels_(0)
+  , frames_(0)
+  , wide_(false)
+  , squares_(false)
+{
+}
+
+
+void FrameAccumulator::reset(int rows, int cols, int channels, bool squares)
+{
+  rows_ = rows;
+  cols_ = cols;
+  channels_ = channels;
+  frames_ = 0;
+
+  wide_ = false;
+  narrow_sums_.assign(rows_ * row_size(), 0);
+  // The wide sums are allocated only when needed
+  if (!wide_sums_.empty()) {
+    wide_sums_.clear();
+    wide_sums_.shrink_to_fit();
+  }
+
+  squares_ = squares;
+  if (squares_) {
+    square_sums_.assign(rows_ * row_size(), 0);
+  } else if (!square_sums_.empty()) {
+    square_sums_.clear();
+    square_sums_.shrink_to_fit();
+  }
+}
+
+
+size_t FrameAccumulator::row_size() const
+{
+  return (size_t) cols_ * channels_;
+}
+
+
+void FrameAccumulator::add(const cv::Mat& frame)
+{
+  CV_Assert(frame.depth() == CV_8U && frame.rows == rows_
+            && frame.cols == cols_ && frame.channels() == channels_);
+
+  CV_Assert(!squares_ || frames_ < MAX_SQUARE_FRAMES_);
+
+  if (frames_ >= MAX_NARROW_FRAMES_) {
+    widen();
+  }
+
+  size_t n = row_size();
+  for (int row = 0; row < rows_; ++row) {
+    // The row is still in the cache when the squares are added
+    const uint8_t* src = frame.ptr<uint8_t>(row);
+    if (wide_) {
+      AccumulatorKernels::add_u8_to_u32(src, &wide_sums_[row * n], n);
+    } else {
+      AccumulatorKernels::add_u8_to_u16(src, &narrow_sums_[row * n], n);
+    }
+    if (squares_) {
+      AccumulatorKernels::add_squares_u8_to_u32(src, &square_sums_[row * n], n);
+    }
+  }
+
+  ++frames_;
+}
+
+
+void FrameAccumulator::add(const FrameAccumulator& other)
+{
+  CV_Assert(other.rows_ == rows_ && other.cols_ == cols_ && other.channels_ == channels_);
+  CV_Assert(!squares_ || (other.squares_ && frames_ + other.frames_ <= MAX_SQUARE_FRAMES_));
+
+  if (frames_ + other.frames_ > MAX_NARROW_FRAMES_) {
+    widen();
+  }
+
+  size_t n = rows_ * row_size();
+  if (!wide_) {
+    AccumulatorKernels::add_u16_to_u16(other.narrow_sums_.data(), narrow_sums_.data(), n);
+  } else if (!other.wide_) {
+    AccumulatorKernels::add_u16_to_u32(other.narrow_sums_.data(), wide_sums_.data(), n);
+  } else {
+    AccumulatorKernels::add_u32_to_u32(other.wide_sums_.data(), wide_sums_.data(), n);
+  }
+  if (squares_) {
+    AccumulatorKernels::add_u32_to_u32(other.square_sums_.data(), square_sums_.data(), n);
+  }
+
+  frames_ += other.frames_;
+}
+
+
+void FrameAccumulator::widen()
+{
+  if (wide_) {
+    return;
+  }
+
+  wide_sums_.assign(narrow_sums_.begin(), narrow_sums_.end());
+  narrow_sums_.clear();
+  narrow_sums_.shrink_to_fit();
+  wide_ = true;
+}
+
+
+int FrameAccumulator::frames() const
+{
+  return frames_;
+}
+
+
+bool FrameAccumulator::average(cv::Mat& avg) const
+{
+  if (frames_ == 0) {
+    return false;
+  }
+
+  avg.create(rows_, cols_, CV_8UC(channels_));
+
+  // Same calculation as cv::Mat::convertTo() does with a scale, so
+  // that the result is identical to averaging with doubles
+  double scale = 1. / frames_;
+  size_t n = row_size();
+  for (int row = 0; row < rows_; ++row) {
+    uint8_t* dst = avg.ptr<uint8_t>(row);
+    if (wide_) {
+      const uint32_t* src = &wide_sums_[row * n];
+      for (size_t i = 0; i < n; ++i) {
+        dst[i] = cv::saturate_cast<uint8_t>(src[i] * scale);
+      }
+    } else {
+      const uint16_t* src = &narrow_sums_[row * n];
+      for (size_t i = 0; i < n; ++i) {
+        dst[i] = cv::saturate_cast<uint8_t>(src[i] * scale);
+      }
+    }
+  }
+
+  return true;
+}
+
+
+bool FrameAccumulator::has_squares() const
+{
+  return squares_;
+}
+
+
+bool FrameAccumulator::deviation(cv::Mat& dev) const
+{
+  if (frames_ == 0 || !squares_) {
+    return false;
+  }
+
+  dev.create(rows_, cols_, CV_8UC(channels_));
+
+  // n^2 * variance = n * sum(x^2) - sum(x)^2, which is exact in 64
+  // bits, and is never negative
+  uint64_t frames = frames_;
+  double scale = 1. / frames_;
+  size_t n = row_size();
+  for (int row = 0; row < rows_; ++row) {
+    uint8_t* dst = dev.ptr<uint8_t>(row);
+    const uint32_t* squares = &square_sums_[row * n];
+    for (size_t i = 0; i < n; ++i) {
+      uint64_t sum = wide_ ? wide_sums_[row * n + i] : narrow_sums_[row * n + i];
+      uint64_t scaled_variance = frames * squares[i] - sum * sum;
+      dst[i] = cv::saturate_cast<uint8_t>(std::sqrt(double(scaled_variance)) * scale);
+    }
+  }
+
+  return true;
+}
+
+
+const void* FrameAccumulator::sums() const
+{
+  if (wide_) {
+    return wide_sums_.data();
+  }
+  return narrow_sums_.data();
+}
+
+
+size_t FrameAccumulator::sums_size() const
+{
+  if (wide_) {
+    return wide_sums_.size() * sizeof(uint32_t);
+  }
+  return narrow_sums_.size() * sizeof(uint16_t);
+}
+
+
+const uint32_t* FrameAccumulator::square_sums() const
+{
+  return square_sums_.data();
+}
+
+
+size_t FrameAccumulator::square_sums_size() const
+{
+  return square_sums_.size() * sizeof(uint32_t);
+}
+
+
+void FrameAccumulator::load(int rows, int cols, int channels, int frames, const void* sums,
+                            const uint32_t* square_sums)
+{
+  reset(rows, cols, channels, square_sums != nullptr);
+  if (frames > MAX_NARROW_FRAMES_) {
+    widen();
+  }
+  frames_ = frames;
+
+  if (wide_) {
+    std::memcpy(wide_sums_.data(), sums, sums_size());
+  } else {
+    std::memcpy(narrow_sums_.data(), sums, sums_size());
+  }
+  if (squares_) {
+    std::memcpy(square_sums_.data(), square_sums, square_sums_size());
+  }
+}
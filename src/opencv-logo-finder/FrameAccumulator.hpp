@@ -0,0 +1,98 @@
+/*
+ * Copyright (C) 2018-2025 Werner Turing <werner.turing@protonmail.com>
+ *
+ * This file is part of multi-delogo.
+ *
+ * multi-delogo is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * multi-delogo is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with multi-delogo.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#ifndef MDL_OPENCV_FRAME_ACCUMULATOR_H
+#define MDL_OPENCV_FRAME_ACCUMULATOR_H
+
+#include <cstdint>
+#include <vector>
+
+#include <opencv2/core.hpp>
+
+
+namespace mdl { namespace opencv {
+  /**
+   * Sums 8-bit frames in order to calculate their average.
+   *
+   * The sums are kept in 16-bit integers while they can't overflow,
+   * that is, for up to 257 frames, and in 32-bit integers after
+   * that. The division is done only once, when the average is
+   * requested.
+   *
+   * Optionally, the squares of the pixels are also summed, in 32-bit
+   * integers, so that the standard deviation of each pixel can be
+   * calculated. Being integers, the sums are exact and can be added
+   * together, so there is no loss of precision from calculating the
+   * variance as the mean of the squares minus the square of the mean.
+   */
+  class FrameAccumulator
+  {
+  public:
+    FrameAccumulator();
+
+    void reset(int rows, int cols, int channels, bool squares = false);
+
+    void add(const cv::Mat& frame);
+    void add(const FrameAccumulator& other);
+
+    int frames() const;
+    bool average(cv::Mat& avg) const;
+
+    bool has_squares() const;
+    /**
+     * Calculates the standard deviation of each pixel, rounded and
+     * saturated to 8 bits. Only available when the squares are
+     * summed.
+     */
+    bool deviation(cv::Mat& dev) const;
+
+    /**
+     * The sums, to be saved and loaded back. They take sums_size()
+     * bytes, and are 16-bit for up to 257 frames and 32-bit after
+     * that.
+     */
+    const void* sums() const;
+    size_t sums_size() const;
+    const uint32_t* square_sums() const;
+    size_t square_sums_size() const;
+    void load(int rows, int cols, int channels, int frames, const void* sums,
+              const uint32_t* square_sums = nullptr);
+
+  private:
+    const static int MAX_NARROW_FRAMES_;
+    const static int MAX_SQUARE_FRAMES_;
+
+    int rows_;
+    int cols_;
+    int channels_;
+    int frames_;
+
+    bool wide_;
+    std::vector<uint16_t> narrow_sums_;
+    std::vector<uint32_t> wide_sums_;
+
+    bool squares_;
+    std::vector<uint32_t> square_sums_;
+
+    size_t row_size() const;
+    void widen();
+  };
+} }
+
+
+#endif // MDL_OPENCV_FRAME_ACCUMULATOR_H
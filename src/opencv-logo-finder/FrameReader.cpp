@@ -0,0 +1,254 @@
+/*
+ * Copyright (C) 2018-2025 Werner Turing <werner.turing@protonmail.com>
+ *
+ * This file is part of multi-delogo.
+ *
+ * multi-delogo is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * multi-delogo is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with multi-delogo.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include <cstddef>
+#include <algorithm>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+
+#include <opencv2/core.hpp>
+#include <opencv2/imgproc.hpp>
+#include <opencv2/videoio.hpp>
+
+#include "gui/common/Exceptions.hpp"
+
+#include "FrameReader.hpp"
+#include "IntervalCalculator.hpp"
+#include "Profiler.hpp"
+
+using namespace mdl::opencv;
+
+
+FrameReader::FrameReader(cv::VideoCapture& cap, const cv::Size& frame_size, size_t max_bytes)
+  : cap_(cap)
+  , frame_size_(frame_size)
+  , reduce_(frame_size != cv::Size(cap.get(cv::CAP_PROP_FRAME_WIDTH), cap.get(cv::CAP_PROP_FRAME_HEIGHT)))
+  , position_(-1)
+  , profiler_(nullptr)
+  , first_(0)
+  , count_(0)
+  , holding_first_(false)
+  , finished_(true)
+  , failed_frame_(-1)
+  , stop_requested_(false)
+{
+  size_t frame_bytes = size_t(frame_size.width) * frame_size.height * 3;
+  size_t n_slots = std::max<size_t>(2, max_bytes / std::max<size_t>(1, frame_bytes));
+
+  slots_.resize(n_slots);
+  for (auto& slot: slots_) {
+    slot.frame.create(frame_size, CV_8UC3);
+  }
+}
+
+
+FrameReader::~FrameReader()
+{
+  stop();
+}
+
+
+void FrameReader::start(int position, int start_frame, int end_frame, int frame_step, bool seek)
+{
+  stop();
+
+  position_ = position;
+  first_ = 0;
+  count_ = 0;
+  holding_first_ = false;
+  finished_ = false;
+  failed_frame_ = -1;
+  stop_requested_ = false;
+
+  thread_ = std::thread(&FrameReader::decode, this, start_frame, end_frame, frame_step, seek);
+}
+
+
+const cv::Mat* FrameReader::next_frame(int& frame_number)
+{
+  std::unique_lock<std::mutex> lock(mutex_);
+
+  // The frame returned by the last call can be reused now
+  if (holding_first_) {
+    first_ = (first_ + 1) % slots_.size();
+    --count_;
+    holding_first_ = false;
+    not_full_.notify_one();
+  }
+
+  {
+    Profiler::Scope scope(profiler_, Profiler::Stage::WAIT_FOR_DECODED_FRAME);
+    not_empty_.wait(lock, [this] {
+        return count_ > 0 || finished_;
+      });
+  }
+
+  if (count_ > 0) {
+    holding_first_ = true;
+    frame_number = slots_[first_].frame_number;
+    return &slots_[first_].frame;
+  }
+
+  if (failed_frame_ >= 0) {
+    throw mdl::FrameNotAvailableException(failed_frame_);
+  }
+
+  return nullptr;
+}
+
+
+void FrameReader::stop()
+{
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    stop_requested_ = true;
+  }
+  not_full_.notify_one();
+
+  if (thread_.joinable()) {
+    thread_.join();
+  }
+}
+
+
+int FrameReader::position() const
+{
+  return position_;
+}
+
+
+size_t FrameReader::capacity() const
+{
+  return slots_.size();
+}
+
+
+void FrameReader::set_profiler(Profiler* profiler)
+{
+  profiler_ = profiler;
+}
+
+
+void FrameReader::decode(int start_frame, int end_frame, int frame_step, bool seek)
+{
+  if (!seek && position_ != start_frame) {
+    Profiler::Scope scope(profiler_, Profiler::Stage::SEEK);
+    count(Profiler::Counter::SEEKS);
+    cap_.set(cv::CAP_PROP_POS_FRAMES, start_frame);
+    position_ = start_frame;
+  }
+
+  int first_sample = IntervalCalculator::get_first_sample(start_frame, frame_step);
+  for (int f = first_sample; f < end_frame; f += frame_step) {
+    if (seek && position_ != f) {
+      Profiler::Scope scope(profiler_, Profiler::Stage::SEEK);
+      count(Profiler::Counter::SEEKS);
+      cap_.set(cv::CAP_PROP_POS_FRAMES, f);
+      position_ = f;
+    }
+    if (!grab_until(f)) {
+      return;
+    }
+
+    size_t slot;
+    {
+      std::unique_lock<std::mutex> lock(mutex_);
+      {
+        Profiler::Scope scope(profiler_, Profiler::Stage::WAIT_FOR_FREE_SLOT);
+        not_full_.wait(lock, [this] {
+            return count_ < slots_.size() || stop_requested_;
+          });
+      }
+      if (stop_requested_) {
+        lock.unlock();
+        finish(-1);
+        return;
+      }
+      slot = (first_ + count_) % slots_.size();
+    }
+
+    // The slot is not seen by the consumer until count_ is
+    // incremented, so it can be filled without holding the lock
+    bool retrieved;
+    {
+      Profiler::Scope scope(profiler_, Profiler::Stage::RETRIEVE);
+      count(Profiler::Counter::FRAMES_RETRIEVED);
+      retrieved = cap_.retrieve(reduce_ ? decoded_ : slots_[slot].frame);
+    }
+    if (!retrieved) {
+      finish(f);
+      return;
+    }
+    if (reduce_) {
+      Profiler::Scope scope(profiler_, Profiler::Stage::RESIZE);
+      cv::resize(decoded_, slots_[slot].frame, frame_size_, 0, 0, cv::INTER_AREA);
+    }
+    slots_[slot].frame_number = f;
+
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      ++count_;
+    }
+    not_empty_.notify_one();
+  }
+
+  // Decoding the whole interval leaves the capture at its end, where
+  // the search for the logo transition point continues
+  if (!seek && !grab_until(end_frame - 1)) {
+    return;
+  }
+
+  finish(-1);
+}
+
+
+bool FrameReader::grab_until(int frame_number)
+{
+  while (position_ <= frame_number) {
+    Profiler::Scope scope(profiler_, Profiler::Stage::GRAB);
+    count(Profiler::Counter::FRAMES_GRABBED);
+    if (!cap_.grab()) {
+      finish(position_);
+      position_ = -1;
+      return false;
+    }
+    ++position_;
+  }
+
+  return true;
+}
+
+
+void FrameReader::finish(int failed_frame)
+{
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    finished_ = true;
+    failed_frame_ = failed_frame;
+  }
+  not_empty_.notify_one();
+}
+
+
+void FrameReader::count(Profiler::Counter counter)
+{
+  if (profiler_) {
+    profiler_->count(counter);
+  }
+}
@@ -0,0 +1,127 @@
+/*
+ * Copyright (C) 2018-2025 Werner Turing <werner.turing@protonmail.com>
+ *
+ * This file is part of multi-delogo.
+ *
+ * multi-delogo is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * multi-delogo is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with multi-delogo.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#ifndef MDL_OPENCV_FRAME_READER_H
+#define MDL_OPENCV_FRAME_READER_H
+
+#include <cstddef>
+#include <vector>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+
+#include <opencv2/core.hpp>
+#include <opencv2/videoio.hpp>
+
+#include "Profiler.hpp"
+
+
+namespace mdl { namespace opencv {
+  /**
+   * Decodes frames in a separate thread, ahead of their use.
+   *
+   * The decoded frames are kept in a ring buffer of frames allocated
+   * only once, whose size is limited by a maximum number of bytes
+   * (but it always has at least two frames). When the buffer is full
+   * the decoding thread waits for the frames to be consumed.
+   *
+   * The frames can be reduced to a smaller size as they are decoded,
+   * in the decoding thread, so that only the reduced frames are kept.
+   */
+  class FrameReader
+  {
+  public:
+    FrameReader(cv::VideoCapture& cap, const cv::Size& frame_size, size_t max_bytes);
+    ~FrameReader();
+
+    /**
+     * Starts decoding the frames in [start_frame, end_frame). Only
+     * the frames that are a multiple of frame_step are returned. The
+     * others are decoded and skipped, or, if seek is true, not
+     * decoded at all by seeking to each returned frame.
+     *
+     * position is the frame the capture is positioned at (-1 if
+     * unknown). The capture must not be used until stop() is called.
+     */
+    void start(int position, int start_frame, int end_frame, int frame_step, bool seek);
+
+    /**
+     * Returns the next decoded frame, or nullptr when there are no
+     * more frames. The frame is valid until the next call. Throws
+     * FrameNotAvailableException when the frame could not be decoded.
+     */
+    const cv::Mat* next_frame(int& frame_number);
+
+    /**
+     * Stops the decoding thread and waits for it to finish.
+     */
+    void stop();
+
+    /**
+     * Frame the capture is positioned at after stop() (-1 if unknown).
+     */
+    int position() const;
+
+    size_t capacity() const;
+
+    /**
+     * Records the decoding, and the time each thread waits for the
+     * other, in the profiler, which can be null. The time waited
+     * shows if the search is limited by the decoding or by the
+     * analysis.
+     */
+    void set_profiler(Profiler* profiler);
+
+  private:
+    struct Slot
+    {
+      cv::Mat frame;
+      int frame_number;
+    };
+
+    cv::VideoCapture& cap_;
+    cv::Size frame_size_;
+    bool reduce_;
+    int position_;
+
+    Profiler* profiler_;
+
+    std::vector<Slot> slots_;
+    cv::Mat decoded_; // Frame before being reduced
+    size_t first_;
+    size_t count_;
+    bool holding_first_;
+
+    bool finished_;
+    int failed_frame_;
+    bool stop_requested_;
+
+    std::thread thread_;
+    std::mutex mutex_;
+    std::condition_variable not_full_;
+    std::condition_variable not_empty_;
+
+    void decode(int start_frame, int end_frame, int frame_step, bool seek);
+    bool grab_until(int frame_number);
+    void finish(int failed_frame);
+    void count(Profiler::Counter counter);
+  };
+} }
+
+
+#endif // MDL_OPENCV_FRAME_READER_H
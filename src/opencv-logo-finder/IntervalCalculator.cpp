@@ -39,6 +39,12 @@ std::vector<std::pair<int, int>> IntervalCalculator::get_subintervals(int interv
 }
 
 
+int IntervalCalculator::get_first_sample(int interval_start, int frame_step)
+{
+  return ((interval_start + frame_step - 1) / frame_step) * frame_step;
+}
+
+
 void IntervalCalculator::adjust_last_subinterval(std::vector<std::pair<int, int>>& subintervals, int interval_end)
 {
   subintervals.back().second = interval_end;
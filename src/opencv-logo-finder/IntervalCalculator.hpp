@@ -28,6 +28,7 @@ namespace mdl { namespace opencv {
   {
   public:
     static std::vector<std::pair<int, int>> get_subintervals(int interval_start, int interval_end, int n_subintervals);
+    static int get_first_sample(int interval_start, int frame_step);
 
   private:
     static void adjust_last_subinterval(std::vector<std::pair<int, int>>& subintervals, int interval_end);
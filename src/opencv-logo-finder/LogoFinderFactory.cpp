@@ -17,11 +17,14 @@
  * along with multi-delogo.  If not, see <http://www.gnu.org/licenses/>.
  */
 #include <memory>
+#include <vector>
+#include <string>
 
 #include "filter-generator/FilterData.hpp"
 
 #include "gui/common/LogoFinder.hpp"
 #include "OpenCVLogoFinder.hpp"
+#include "AccumulatorCache.hpp"
 
 #include "FilterListAdapter.hpp"
 
@@ -29,10 +32,24 @@
 std::shared_ptr<mdl::LogoFinder> mdl::create_logo_finder(fg::FilterData& filter_data, mdl::LogoFinderCallback& callback, bool verbose)
 {
   mdl::FilterListAdapter* adapter = new mdl::FilterListAdapter(filter_data.filter_list(), callback);
+  mdl::LogoFinder* logo_finder = new mdl::opencv::OpenCVLogoFinder(filter_data.movie_file(), *adapter, verbose);
+
+  std::vector<mdl::LogoSearchRegion> search_regions;
+  for (auto& region: filter_data.search_regions()) {
+    search_regions.push_back(mdl::LogoSearchRegion{region.x, region.y, region.width, region.height});
+  }
+  logo_finder->set_search_regions(search_regions);
+
   return std::shared_ptr<mdl::LogoFinder>(
-    new mdl::opencv::OpenCVLogoFinder(filter_data.movie_file(), *adapter, verbose),
+    logo_finder,
     [adapter](mdl::LogoFinder* logo_finder) {
       delete logo_finder;
       delete adapter;
     });
 }
+
+
+void mdl::remove_logo_finder_cache(const std::string& cache_file)
+{
+  mdl::opencv::AccumulatorCache::remove(cache_file);
+}
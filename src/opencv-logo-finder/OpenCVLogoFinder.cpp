@@ -20,7 +20,15 @@
 #include <vector>
 #include <utility>
 #include <algorithm>
+#include <cmath>
+#include <cstdint>
 #include <iostream>
+#include <deque>
+#include <memory>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <future>
 
 #include <opencv2/videoio.hpp>
 #include <opencv2/imgproc.hpp>
@@ -29,19 +37,38 @@
 
 #include "OpenCVLogoFinder.hpp"
 #include "IntervalCalculator.hpp"
+#include "RegionCalculator.hpp"
+#include "FrameAccumulator.hpp"
+#include "TransitionSearch.hpp"
+#include "Profiler.hpp"
 
 using namespace mdl::opencv;
 
 
+const size_t OpenCVLogoFinder::TransitionFrames::MAX_LOGOS_ = 4;
+
+
 #define INFO(msg) ({if (verbose_) { std::cout << msg; }})
 #define RECT_STR(rect) "[" << rect.x << " " << rect.y << " " \
                            << rect.width << " " << rect.height << "]"
 
 
+// Intersection over union of two boxes
+static double overlap(const cv::Rect& box1, const cv::Rect& box2)
+{
+  return double((box1 & box2).area()) / (box1 | box2).area();
+}
+
+
 OpenCVLogoFinder::OpenCVLogoFinder(const std::string& file, LogoFinderCallback& callback, bool verbose)
   : LogoFinder(callback, verbose)
+  , file_(file)
   , n_last_failures_(0)
   , stop_requested_(false)
+  , current_frame_(0)
+  , search_end_(0)
+  , next_speculative_start_(0)
+  , workers_finished_(false)
 {
   cap_.open(file);
   if (!cap_.isOpened()) {
@@ -56,25 +83,74 @@ OpenCVLogoFinder::OpenCVLogoFinder(const std::string& file, LogoFinderCallback&
 
   kernel_close_ = cv::getStructuringElement(cv::MORPH_RECT, cv::Size(7, 1));
 
-  int width_ = cap_.get(cv::CAP_PROP_FRAME_WIDTH);
-  int height_ = cap_.get(cv::CAP_PROP_FRAME_HEIGHT);
-  t_avg_f_.create(height_, width_, CV_64FC3);
+  frame_width_ = cap_.get(cv::CAP_PROP_FRAME_WIDTH);
+  frame_height_ = cap_.get(cv::CAP_PROP_FRAME_HEIGHT);
+  analysis_size_ = cv::Size(frame_width_, frame_height_);
+}
+
+
+OpenCVLogoFinder::~OpenCVLogoFinder()
+{
+  stop_workers();
+}
+
+
+int OpenCVLogoFinder::get_total_frames() const
+{
+  return total_frames_;
 }
 
 
 OpenCVLogoFinder::find_result OpenCVLogoFinder::find_logos()
 {
   try {
-    int interval_start = start_frame_;
-  while (interval_start < total_frames_) {
-    int interval_end = interval_start + frame_interval_min_;
-    if (interval_end > total_frames_) {
-      interval_end = total_frames_;
+    calculate_analysis_size();
+    calculate_search_tiles();
+    open_cache();
+    tracked_logos_.clear();
+    ++tracked_logos_version_;
+    if (threads_ > 1) {
+      start_workers();
+    }
+
+    if (search_ranges_.empty()) {
+      search_range(start_frame_, total_frames_, initial_failures_);
+    } else {
+      for (auto& range: search_ranges_) {
+        int initial_failures = &range == &search_ranges_.front() ? initial_failures_ : 0;
+        search_range(range.start_frame, std::min(range.end_frame, total_frames_), initial_failures);
+        if (stop_requested_) {
+          break;
+        }
+      }
     }
 
+  stop_workers();
+  stop_scene_cut_detector();
+  return std::make_pair(true, "");
+  } catch (const FrameNotAvailableException& e) {
+    stop_workers();
+    stop_scene_cut_detector();
+    return std::make_pair(false, "Could not get frame " + std::to_string(e.get_frame()));
+  }
+}
+
+
+void OpenCVLogoFinder::search_range(int start_frame, int end_frame, int initial_failures)
+{
+  INFO("search_range [" << start_frame << ", " << end_frame << ")" << std::endl);
+  search_end_ = end_frame;
+  n_last_failures_ = initial_failures;
+  start_scene_cut_detector(start_frame);
+
+  int interval_start = start_frame;
+  while (interval_start < search_end_) {
+    int interval_end = get_interval_end(interval_start);
+
     INFO("find_logos iteration for [" << interval_start
          << ", " << interval_end << ")" << std::endl);
-    cv::Rect box = find_logo_in_interval(interval_start, interval_end);
+    IntervalLogo logo = analyze_interval(interval_start, interval_end);
+    const cv::Rect& box = logo.box;
     INFO("  logo found = " << RECT_STR(box) << std::endl);
 
     if (stop_requested_) {
@@ -82,41 +158,383 @@ OpenCVLogoFinder::find_result OpenCVLogoFinder::find_logos()
     }
 
     if (box.x != 0) {
+      std::vector<cv::Rect> boxes{box};
+      boxes.insert(boxes.end(), logo.other_boxes.begin(), logo.other_boxes.end());
+      // The search for the transition point keeps the parts of the
+      // frames it reads that are needed to refine the boxes
+      t_refine_crops_.clear();
+      if (is_reduced()) {
+        t_refine_areas_ = get_refine_areas(boxes);
+      } else {
+        t_refine_areas_.clear();
+      }
+
       int new_start = get_logo_transition_point(interval_end, box);
+      if (is_reduced()) {
+        boxes = refine_boxes(boxes, interval_start, new_start);
+      }
 
       LogoFinderResult result{.start_frame = interval_start,
                               .end_frame = new_start - 1,
-                              .x = box.x, .y = box.y,
-                              .width = box.width, .height = box.height};
+                              .x = boxes[0].x, .y = boxes[0].y,
+                              .width = boxes[0].width, .height = boxes[0].height};
+      for (size_t i = 1; i < boxes.size(); ++i) {
+        result.other_logos.push_back(LogoBox{.x = boxes[i].x, .y = boxes[i].y,
+                                             .width = boxes[i].width, .height = boxes[i].height});
+      }
       callback_.success(result);
 
       interval_start = new_start;
       n_last_failures_ = 0;
+      track_logo(logo);
     } else {
       callback_.failure(interval_start, interval_end - 1);
 
-      interval_start += frame_interval_min_;
+      interval_start = interval_end;
       ++n_last_failures_;
     }
   }
 
-  return std::make_pair(true, "");
-  } catch (const FrameNotAvailableException& e) {
-    return std::make_pair(false, "Could not get frame " + std::to_string(e.get_frame()));
+  // The rest of the range would be taken as part of the last logo
+  // found
+  if (!search_ranges_.empty() && interval_start > start_frame && interval_start < search_end_) {
+    callback_.failure(interval_start, search_end_ - 1);
+  }
+
+  stop_scene_cut_detector();
+}
+
+
+int OpenCVLogoFinder::get_interval_end(int interval_start)
+{
+  int interval_end = std::min(interval_start + frame_interval_min_, search_end_);
+  if (!scene_cut_detector_ || stop_requested_) {
+    return interval_end;
+  }
+
+  int cut = scene_cut_detector_->find_cut(interval_start + min_scene_cut_samples_ * frame_step_, interval_end);
+  if (cut > 0) {
+    INFO("scene cut at " << cut << std::endl);
+    count(Profiler::Counter::INTERVALS_ENDED_BY_SCENE_CUTS);
+    interval_end = cut;
+  }
+  return interval_end;
+}
+
+
+OpenCVLogoFinder::IntervalLogo OpenCVLogoFinder::analyze_interval(int interval_start, int interval_end)
+{
+  if (workers_.empty()) {
+    return find_logo_in_interval(interval_start, interval_end, tracked_logos_);
+  }
+
+  if (!speculative_intervals_.empty()
+      && (speculative_intervals_.front().start_frame != interval_start
+          || speculative_intervals_.front().end_frame != interval_end)) {
+    INFO("  discarding speculative intervals from " << speculative_intervals_.front().start_frame << std::endl);
+    discard_speculative_intervals();
+  }
+  if (speculative_intervals_.empty()) {
+    next_speculative_start_ = interval_start;
+  }
+  schedule_speculative_intervals();
+  if (speculative_intervals_.empty()) {
+    // Stopped
+    return IntervalLogo();
+  }
+
+  SpeculativeInterval interval = std::move(speculative_intervals_.front());
+  speculative_intervals_.pop_front();
+  schedule_speculative_intervals();
+
+  IntervalLogo logo = interval.logo.get();
+  if (interval.tracked_logos_version != tracked_logos_version_ && !stop_requested_) {
+    // A logo was found and tracked after the interval was scheduled
+    INFO("  analysing again with the tracked logos" << std::endl);
+    count(Profiler::Counter::INTERVALS_ANALYSED_AGAIN);
+    logo = find_logo_in_interval(interval_start, interval_end, tracked_logos_);
+  }
+  return logo;
+}
+
+
+void OpenCVLogoFinder::start_scene_cut_detector(int start_frame)
+{
+  std::unique_ptr<SceneCutDetector> detector;
+  if (scene_cuts_) {
+    // The detector decodes the frames on its own, at the original size
+    std::vector<cv::Rect> tiles;
+    for (auto& tile: search_tiles_) {
+      tiles.push_back(to_source(tile));
+    }
+    detector.reset(new SceneCutDetector(tiles, scene_cut_threshold_));
+    detector->set_profiler(profiler_);
+    detector->start(file_, start_frame, search_end_, frame_step_,
+                    sampling_mode_ == SamplingMode::SEEK);
+  }
+
+  // stop() wakes up the detector, so it is replaced under the lock.
+  // The previous one is destroyed after releasing it
+  std::lock_guard<std::mutex> lock(jobs_mutex_);
+  scene_cut_detector_.swap(detector);
+  if (scene_cut_detector_ && stop_requested_) {
+    scene_cut_detector_->request_stop();
+  }
+}
+
+
+void OpenCVLogoFinder::stop_scene_cut_detector()
+{
+  if (scene_cut_detector_) {
+    scene_cut_detector_->stop();
+  }
+}
+
+
+void OpenCVLogoFinder::calculate_analysis_size()
+{
+  cv::Size size(frame_width_, frame_height_);
+  if (analysis_height_ > 0 && analysis_height_ < frame_height_) {
+    int width = std::lround(double(frame_width_) * analysis_height_ / frame_height_);
+    size = cv::Size(std::max(1, width), analysis_height_);
+  }
+
+  // The frames decoded ahead are kept already reduced
+  if (size != analysis_size_) {
+    frame_reader_.reset();
+  }
+  analysis_size_ = size;
+
+  // Boxes a bit smaller or bigger than the limits can still be logos
+  // of the right size at the original resolution
+  double scale_x = double(analysis_size_.width) / frame_width_;
+  double scale_y = double(analysis_size_.height) / frame_height_;
+  min_box_size_ = cv::Size(std::floor(min_logo_width_ * scale_x), std::floor(min_logo_height_ * scale_y));
+  max_box_size_ = cv::Size(std::ceil(max_logo_width_ * scale_x), std::ceil(max_logo_height_ * scale_y));
+
+  if (is_reduced()) {
+    INFO("analysing frames reduced to " << analysis_size_.width << "x" << analysis_size_.height << std::endl);
+  }
+}
+
+
+bool OpenCVLogoFinder::is_reduced() const
+{
+  return analysis_size_ != cv::Size(frame_width_, frame_height_);
+}
+
+
+cv::Rect OpenCVLogoFinder::to_analysis(const cv::Rect& rect) const
+{
+  double scale_x = double(analysis_size_.width) / frame_width_;
+  double scale_y = double(analysis_size_.height) / frame_height_;
+  cv::Point tl(std::floor(rect.x * scale_x), std::floor(rect.y * scale_y));
+  cv::Point br(std::ceil(rect.br().x * scale_x), std::ceil(rect.br().y * scale_y));
+  return cv::Rect(tl, br) & cv::Rect(cv::Point(0, 0), analysis_size_);
+}
+
+
+cv::Rect OpenCVLogoFinder::to_source(const cv::Rect& rect) const
+{
+  double scale_x = double(frame_width_) / analysis_size_.width;
+  double scale_y = double(frame_height_) / analysis_size_.height;
+  cv::Point tl(std::floor(rect.x * scale_x), std::floor(rect.y * scale_y));
+  cv::Point br(std::ceil(rect.br().x * scale_x), std::ceil(rect.br().y * scale_y));
+  return cv::Rect(tl, br) & cv::Rect(0, 0, frame_width_, frame_height_);
+}
+
+
+// A box found in the reduced frames is only accurate to about one of
+// their pixels. It is searched again at the original resolution, only
+// around it, in the average of a few frames from the end of the
+// interval. Those are the frames showing the logo that the search for
+// the transition point has just read, if there are enough of them;
+// otherwise frames one frame step apart before end_frame are read,
+// which needs seeking back. All the logos of the interval are refined
+// from the same frames. If nothing close enough is found a box is
+// only converted
+std::vector<cv::Rect> OpenCVLogoFinder::refine_boxes(const std::vector<cv::Rect>& boxes,
+                                                     int start_frame, int end_frame)
+{
+  Profiler::Scope scope(profiler_, Profiler::Stage::REFINE_BOX);
+
+  std::vector<cv::Rect> source_boxes;
+  for (auto& box: boxes) {
+    source_boxes.push_back(to_source(box));
+  }
+  const std::vector<cv::Rect>& areas = t_refine_areas_;
+
+  t_refine_sums_.resize(boxes.size());
+  for (size_t i = 0; i < boxes.size(); ++i) {
+    t_refine_sums_[i].reset(areas[i].height, areas[i].width, 3);
+  }
+
+  // The last ones first
+  int n_frames = 0;
+  for (auto it = t_refine_crops_.rbegin(); it != t_refine_crops_.rend() && n_frames < refine_frames_; ++it) {
+    if (it->first < start_frame || it->first >= end_frame) {
+      continue;
+    }
+    for (size_t i = 0; i < boxes.size(); ++i) {
+      t_refine_sums_[i].add(it->second[i]);
+    }
+    ++n_frames;
+  }
+
+  int first_frame = std::max(start_frame, end_frame - (refine_frames_ - n_frames) * frame_step_);
+  for (int f = first_frame; f < end_frame && n_frames < refine_frames_; f += frame_step_) {
+    if (t_refine_crops_.count(f) > 0) {
+      continue;
+    }
+    read_frame(f);
+    count(Profiler::Counter::FRAMES_READ_TO_REFINE_BOXES);
+    for (size_t i = 0; i < boxes.size(); ++i) {
+      t_refine_sums_[i].add(cv::Mat(t_source_frame_, areas[i]));
+    }
+    ++n_frames;
+
+    if (stop_requested_) {
+      return source_boxes;
+    }
+  }
+
+  std::vector<cv::Rect> refined_boxes;
+  for (size_t i = 0; i < boxes.size(); ++i) {
+    count(Profiler::Counter::BOXES_REFINED);
+    cv::Rect refined = source_boxes[i];
+    if (t_refine_sums_[i].average(t_avg_)) {
+      cv::filter2D(t_avg_, t_sharpened_, -1, kernel_sharpen_);
+      std::vector<cv::Rect> candidates;
+      find_boxes_fused(t_sharpened_, areas[i].tl(),
+                       cv::Size(min_logo_width_, min_logo_height_), cv::Size(max_logo_width_, max_logo_height_),
+                       cv::Mat(), candidates, nullptr);
+
+      double best_overlap = 0.5;
+      for (auto& candidate: candidates) {
+        if (candidate.width > 0 && overlap(candidate, source_boxes[i]) > best_overlap) {
+          refined = candidate;
+          best_overlap = overlap(candidate, source_boxes[i]);
+        }
+      }
+    }
+
+    INFO("  box " << RECT_STR(boxes[i]) << " refined to " << RECT_STR(refined) << std::endl);
+    refined_boxes.push_back(refined);
+  }
+  return refined_boxes;
+}
+
+
+// Parts of the original frames searched to refine the boxes
+std::vector<cv::Rect> OpenCVLogoFinder::get_refine_areas(const std::vector<cv::Rect>& boxes) const
+{
+  std::vector<cv::Rect> areas;
+  int margin = std::ceil(double(frame_height_) / analysis_size_.height) + 2;
+  for (auto& box: boxes) {
+    cv::Rect area = to_source(box);
+    area -= cv::Point(margin, margin);
+    area += cv::Size(2 * margin, 2 * margin);
+    areas.push_back(area & cv::Rect(0, 0, frame_width_, frame_height_));
+  }
+  return areas;
+}
+
+
+void OpenCVLogoFinder::keep_refine_crops(int frame)
+{
+  if (t_refine_areas_.empty()) {
+    return;
+  }
+
+  std::vector<cv::Mat>& crops = t_refine_crops_[frame];
+  crops.clear();
+  for (auto& area: t_refine_areas_) {
+    crops.push_back(cv::Mat(t_source_frame_, area).clone());
+  }
+
+  // Only the last frames are used, the search reads the frames mostly
+  // in order
+  while (t_refine_crops_.size() > size_t(4 * refine_frames_)) {
+    t_refine_crops_.erase(t_refine_crops_.begin());
+  }
+}
+
+
+void OpenCVLogoFinder::calculate_search_tiles()
+{
+  std::vector<cv::Rect> regions;
+  if (corner_size_ > 0) {
+    regions = RegionCalculator::get_corners(analysis_size_.width, analysis_size_.height, corner_size_);
+  }
+  for (auto& region: search_regions_) {
+    regions.push_back(to_analysis(cv::Rect(region.x, region.y, region.width, region.height)));
+  }
+
+  search_tiles_ = RegionCalculator::get_tiles(analysis_size_.width, analysis_size_.height, regions);
+  for (auto& tile: search_tiles_) {
+    INFO("search tile " << RECT_STR(tile) << std::endl);
+  }
+}
+
+
+void OpenCVLogoFinder::open_cache()
+{
+  if (cache_file_.empty()) {
+    cache_.reset();
+    return;
+  }
+
+  if (!cache_) {
+    cache_.reset(new AccumulatorCache());
+  }
+  cache_->set_max_bytes(uint64_t(cache_size_) * 1024 * 1024);
+  // Opening again makes the sums saved by the last search available
+  if (cache_->open(cache_file_, file_)) {
+    INFO("cache " << cache_file_ << " has " << cache_->size() << " sums" << std::endl);
+  } else {
+    INFO("cache " << cache_file_ << " could not be opened, not using it" << std::endl);
+    cache_.reset();
+  }
+}
+
+
+OpenCVLogoFinder::IntervalLogo OpenCVLogoFinder::find_logo_in_interval(int interval_start, int interval_end,
+                                                                      const std::deque<IntervalLogo>& tracked_logos)
+{
+  // The interval is decoded only once, keeping the sums of the
+  // subintervals of the last level. The subintervals of the other
+  // levels are calculated by adding those sums.
+  count(Profiler::Counter::INTERVALS);
+  int n_finest_subintervals = 1 << (steps_ - 1);
+  accumulate_subintervals(IntervalCalculator::get_subintervals(interval_start, interval_end, n_finest_subintervals));
+
+  IntervalLogo logo;
+  logo.box = match_tracked_logos(tracked_logos, n_finest_subintervals);
+  if (logo.box.x == 0) {
+    logo.box = find_boxes_in_levels();
+  }
+
+  if (logo.box.x > 0 && max_tracked_logos_ > 0) {
+    logo.average = get_interval_average(logo.box, n_finest_subintervals);
+  }
+  if (logo.box.x > 0 && max_logos_ > 1) {
+    logo.other_boxes = find_other_logos(logo.box, n_finest_subintervals);
   }
+  return logo;
 }
 
 
-cv::Rect OpenCVLogoFinder::find_logo_in_interval(int interval_start, int interval_end)
+cv::Rect OpenCVLogoFinder::find_boxes_in_levels()
 {
+  int n_finest_subintervals = 1 << (steps_ - 1);
   int n_subintervals = 1;
   int level = 1;
   while (level <= steps_) {
-    auto subintervals = IntervalCalculator::get_subintervals(interval_start, interval_end, n_subintervals);
+    int sums_per_subinterval = n_finest_subintervals / n_subintervals;
 
     std::vector<cv::Rect> subinterval_boxes;
-    for (const auto& subinterval: subintervals) {
-      subinterval_boxes.push_back(find_boxes(subinterval.first, subinterval.second));
+    for (int i = 0; i < n_subintervals; ++i) {
+      subinterval_boxes.push_back(find_boxes(i * sums_per_subinterval, sums_per_subinterval));
     }
 
     cv::Rect interval_box = select_box(subinterval_boxes);
@@ -139,50 +557,386 @@ cv::Rect OpenCVLogoFinder::find_logo_in_interval(int interval_start, int interva
 }
 
 
-cv::Rect OpenCVLogoFinder::find_boxes(int start_frame, int end_frame)
+cv::Rect OpenCVLogoFinder::match_tracked_logos(const std::deque<IntervalLogo>& tracked_logos, int n_sums)
 {
-  INFO("  find_boxes in [" << start_frame << ", " << end_frame << ")" << std::endl);
-  average_frame(start_frame, end_frame);
+  if (tracked_logos.empty()) {
+    return cv::Rect();
+  }
+
+  Profiler::Scope scope(profiler_, Profiler::Stage::TEMPLATE_MATCH);
+  int avg_tile = -1;
+  for (auto& logo: tracked_logos) {
+    int tile = get_tile(logo.box);
+    if (tile < 0) {
+      continue;
+    }
+    // The average of the whole interval, the same for all logos in
+    // the tile
+    if (tile != avg_tile) {
+      if (!average_frame(0, n_sums, tile)) {
+        return cv::Rect();
+      }
+      avg_tile = tile;
+    }
+
+    const cv::Rect& tile_rect = search_tiles_[tile];
+    cv::Rect search_area = logo.box;
+    search_area -= cv::Point(template_match_margin_, template_match_margin_);
+    search_area += cv::Size(2 * template_match_margin_, 2 * template_match_margin_);
+    search_area &= tile_rect;
+
+    cv::matchTemplate(cv::Mat(t_avg_, search_area - tile_rect.tl()), logo.average,
+                      t_match_, cv::TM_CCOEFF_NORMED);
+    double max_value;
+    cv::Point max_location;
+    cv::minMaxLoc(t_match_, nullptr, &max_value, nullptr, &max_location);
+
+    if (max_value >= template_match_threshold_) {
+      cv::Rect box(search_area.tl() + max_location, logo.box.size());
+      INFO("  tracked logo " << RECT_STR(logo.box) << " found at " << RECT_STR(box)
+           << ", correlation " << max_value << std::endl);
+      count(Profiler::Counter::TRACKED_LOGOS_FOUND);
+      return box;
+    }
+  }
+
+  INFO("  no tracked logo found" << std::endl);
+  count(Profiler::Counter::TRACKED_LOGOS_NOT_FOUND);
+  return cv::Rect();
+}
 
-  cv::filter2D(t_avg_, t_sharpened_, -1, kernel_sharpen_);
 
+cv::Mat OpenCVLogoFinder::get_interval_average(const cv::Rect& box, int n_sums)
+{
+  int tile = get_tile(box);
+  if (tile < 0 || !average_frame(0, n_sums, tile)) {
+    return cv::Mat();
+  }
+
+  cv::Mat average = cv::Mat(t_avg_, box - search_tiles_[tile].tl()).clone();
+
+  // Flat boxes can't be compared by correlation
+  cv::Scalar mean, stddev;
+  cv::meanStdDev(average, mean, stddev);
+  if (stddev[0] < 2 && stddev[1] < 2 && stddev[2] < 2) {
+    return cv::Mat();
+  }
+  return average;
+}
+
+
+void OpenCVLogoFinder::track_logo(const IntervalLogo& logo)
+{
+  if (logo.average.empty()) {
+    return;
+  }
+
+  auto same_box = std::find_if(tracked_logos_.begin(), tracked_logos_.end(),
+    [&logo](const auto& tracked) {
+      return tracked.box == logo.box;
+    });
+  if (same_box != tracked_logos_.end()) {
+    tracked_logos_.erase(same_box);
+  }
+
+  tracked_logos_.push_front(logo);
+  while (tracked_logos_.size() > size_t(max_tracked_logos_)) {
+    tracked_logos_.pop_back();
+  }
+  ++tracked_logos_version_;
+}
+
+
+// The other logos are taken from the boxes of the whole interval,
+// which were already found unless the main logo was tracked or found
+// in a subinterval. The same logo is usually found in more than one
+// channel, with slightly different boxes, so the boxes that overlap
+// are grouped, adding up their scores, and the best groups are taken
+std::vector<cv::Rect> OpenCVLogoFinder::find_other_logos(const cv::Rect& box, int n_sums)
+{
+  Profiler::Scope scope(profiler_, Profiler::Stage::OTHER_LOGOS);
+  if (t_candidates_sums_ != n_sums) {
+    find_boxes(0, n_sums);
+  }
+
+  std::vector<ScoredBox> groups;
+  for (auto& candidate: t_candidates_) {
+    auto group = std::find_if(groups.begin(), groups.end(),
+      [&candidate](const auto& group) {
+        return overlap(group.box, candidate.box) > 0.5;
+      });
+    if (group != groups.end()) {
+      group->score += candidate.score;
+    } else {
+      groups.push_back(candidate);
+    }
+  }
+  std::stable_sort(groups.begin(), groups.end(),
+    [](const auto& group1, const auto& group2) {
+      return group1.score > group2.score;
+    });
+
+  std::vector<cv::Rect> other_boxes;
+  for (auto& group: groups) {
+    if (other_boxes.size() + 1 >= size_t(max_logos_)) {
+      break;
+    }
+    bool intersects = (group.box & box).area() > 0
+      || std::any_of(other_boxes.begin(), other_boxes.end(),
+                     [&group](const auto& other) {
+                       return (group.box & other).area() > 0;
+                     });
+    if (!intersects) {
+      INFO("  other logo found = " << RECT_STR(group.box) << ", score " << group.score << std::endl);
+      count(Profiler::Counter::OTHER_LOGOS_FOUND);
+      other_boxes.push_back(group.box);
+    }
+  }
+  return other_boxes;
+}
+
+
+int OpenCVLogoFinder::get_tile(const cv::Rect& box) const
+{
+  for (size_t tile = 0; tile < search_tiles_.size(); ++tile) {
+    if ((box & search_tiles_[tile]) == box) {
+      return tile;
+    }
+  }
+  return -1;
+}
+
+
+cv::Rect OpenCVLogoFinder::find_boxes(int first_sum, int n_sums)
+{
+  INFO("  find_boxes in [" << t_subintervals_[first_sum].first
+       << ", " << t_subintervals_[first_sum + n_sums - 1].second << ")" << std::endl);
   std::vector<cv::Rect> boxes;
-  for (int channel = 0; channel <= 2; ++channel) {
-    boxes.push_back(find_box_in_channel(t_sharpened_, channel));
+  std::vector<ScoredBox>* candidates = max_logos_ > 1 ? &t_candidates_ : nullptr;
+  t_candidates_.clear();
+  t_candidates_sums_ = first_sum == 0 ? n_sums : 0;
+  for (size_t tile = 0; tile < search_tiles_.size(); ++tile) {
+    if (!average_frame(first_sum, n_sums, tile)) {
+      return cv::Rect();
+    }
+
+    if (detection_signal_ == DetectionSignal::VARIANCE) {
+      calculate_static_mask(first_sum, n_sums, tile);
+    }
+
+    {
+      Profiler::Scope scope(profiler_, Profiler::Stage::FILTER_2D);
+      cv::filter2D(t_avg_, t_sharpened_, -1, kernel_sharpen_);
+    }
+
+    if (box_extraction_ == BoxExtraction::FUSED) {
+      find_boxes_fused(t_sharpened_, search_tiles_[tile].tl(), min_box_size_, max_box_size_,
+                       detection_signal_ == DetectionSignal::VARIANCE ? t_static_ : cv::Mat(), boxes,
+                       candidates);
+    } else {
+      for (int channel = 0; channel <= 2; ++channel) {
+        boxes.push_back(find_box_in_channel(t_sharpened_, channel, search_tiles_[tile].tl(), candidates));
+      }
+    }
   }
 
   return select_box(boxes);
 }
 
 
-void OpenCVLogoFinder::average_frame(int start_frame, int end_frame)
+void OpenCVLogoFinder::accumulate_subintervals(const std::vector<std::pair<int, int>>& subintervals)
 {
-  t_avg_f_.setTo(cv::Scalar(0, 0, 0));
+  Profiler::Scope scope(profiler_, Profiler::Stage::ACCUMULATE);
 
-  go_to_frame(start_frame);
-  int frames = 0;
-  for (int f = start_frame; f < end_frame; ++f) {
-    advance_frame();
-    if (f % frame_step_ != 0) {
-      continue;
+  t_subintervals_ = subintervals;
+  t_sums_.resize(subintervals.size() * search_tiles_.size());
+
+  if (load_sums_from_cache()) {
+    return;
+  }
+
+  size_t n_tiles = search_tiles_.size();
+  for (size_t i = 0; i < t_sums_.size(); ++i) {
+    const cv::Rect& tile = search_tiles_[i % n_tiles];
+    t_sums_[i].reset(tile.height, tile.width, 3, detection_signal_ == DetectionSignal::VARIANCE);
+  }
+  decode_subintervals(subintervals.front().first, subintervals.back().second);
+
+  if (!stop_requested_) {
+    save_sums_to_cache();
+  }
+}
+
+
+bool OpenCVLogoFinder::load_sums_from_cache()
+{
+  if (!cache_) {
+    return false;
+  }
+
+  size_t n_tiles = search_tiles_.size();
+  for (size_t i = 0; i < t_sums_.size(); ++i) {
+    const std::pair<int, int>& subinterval = t_subintervals_[i / n_tiles];
+    if (!cache_->get(subinterval.first, subinterval.second, frame_step_, analysis_size_,
+                     search_tiles_[i % n_tiles], detection_signal_ == DetectionSignal::VARIANCE,
+                     t_sums_[i])) {
+      count(Profiler::Counter::CACHE_MISSES);
+      return false;
+    }
+  }
+
+  count(Profiler::Counter::CACHE_HITS);
+  return true;
+}
+
+
+void OpenCVLogoFinder::save_sums_to_cache()
+{
+  if (!cache_) {
+    return;
+  }
+
+  size_t n_tiles = search_tiles_.size();
+  for (size_t i = 0; i < t_sums_.size(); ++i) {
+    const std::pair<int, int>& subinterval = t_subintervals_[i / n_tiles];
+    cache_->put(subinterval.first, subinterval.second, frame_step_, analysis_size_,
+                search_tiles_[i % n_tiles], t_sums_[i]);
+  }
+}
+
+
+void OpenCVLogoFinder::decode_subintervals(int start_frame, int end_frame)
+{
+  if (decode_buffer_size_ > 0) {
+    accumulate_decoded_ahead(start_frame, end_frame);
+    return;
+  }
+
+  bool seek = sampling_mode_ == SamplingMode::SEEK;
+  // Consecutive intervals are read without seeking
+  if (!seek && current_frame_ != start_frame) {
+    go_to_frame(start_frame);
+  }
+
+  size_t subinterval = 0;
+  int first_sample = IntervalCalculator::get_first_sample(start_frame, frame_step_);
+  for (int f = first_sample; f < end_frame; f += frame_step_) {
+    if (seek && current_frame_ != f) {
+      go_to_frame(f);
+    }
+    while (current_frame_ <= f) {
+      advance_frame();
     }
 
     get_frame();
-    t_frame_.convertTo(t_frame_f_, CV_64FC3);
-    t_avg_f_ += t_frame_f_;
-    ++frames;
+    add_to_sums(t_frame_, f, subinterval);
+
+    if (stop_requested_) {
+      return;
+    }
+  }
+
+  // Decoding the whole interval leaves the capture at its end, where
+  // the search for the logo transition point continues
+  if (!seek) {
+    while (current_frame_ < end_frame) {
+      advance_frame();
+    }
+  }
+}
+
+
+void OpenCVLogoFinder::accumulate_decoded_ahead(int start_frame, int end_frame)
+{
+  if (!frame_reader_) {
+    frame_reader_.reset(new FrameReader(cap_, analysis_size_, size_t(decode_buffer_size_) * 1024 * 1024));
+    frame_reader_->set_profiler(profiler_);
+    INFO("decoding up to " << frame_reader_->capacity() << " frames ahead" << std::endl);
+  }
+
+  frame_reader_->start(current_frame_, start_frame, end_frame, frame_step_,
+                       sampling_mode_ == SamplingMode::SEEK);
+  // While the reader is running the position of the capture is not known
+  current_frame_ = -1;
+
+  size_t subinterval = 0;
+  int frame_number;
+  while (const cv::Mat* frame = frame_reader_->next_frame(frame_number)) {
+    add_to_sums(*frame, frame_number, subinterval);
 
     if (stop_requested_) {
       break;
     }
   }
 
-  t_avg_f_.convertTo(t_avg_, CV_8U, 1. / frames);
+  frame_reader_->stop();
+  current_frame_ = frame_reader_->position();
+}
+
+
+void OpenCVLogoFinder::add_to_sums(const cv::Mat& frame, int frame_number, size_t& subinterval)
+{
+  Profiler::Scope scope(profiler_, Profiler::Stage::ADD_TO_SUMS);
+
+  while (subinterval < t_subintervals_.size() - 1 && frame_number >= t_subintervals_[subinterval].second) {
+    ++subinterval;
+  }
+
+  size_t n_tiles = search_tiles_.size();
+  for (size_t tile = 0; tile < n_tiles; ++tile) {
+    t_sums_[subinterval*n_tiles + tile].add(cv::Mat(frame, search_tiles_[tile]));
+  }
+}
+
+
+bool OpenCVLogoFinder::average_frame(int first_sum, int n_sums, int tile)
+{
+  Profiler::Scope scope(profiler_, Profiler::Stage::AVERAGE_FRAME);
+
+  int n_tiles = search_tiles_.size();
+  if (n_sums == 1) {
+    return t_sums_[first_sum*n_tiles + tile].average(t_avg_);
+  }
+
+  t_total_.reset(search_tiles_[tile].height, search_tiles_[tile].width, 3,
+                 detection_signal_ == DetectionSignal::VARIANCE);
+  for (int i = first_sum; i < first_sum + n_sums; ++i) {
+    t_total_.add(t_sums_[i*n_tiles + tile]);
+  }
+
+  return t_total_.average(t_avg_);
+}
+
+
+void OpenCVLogoFinder::calculate_static_mask(int first_sum, int n_sums, int tile)
+{
+  Profiler::Scope scope(profiler_, Profiler::Stage::STATIC_MASK);
+
+  // average_frame() has just added the sums together
+  int n_tiles = search_tiles_.size();
+  const FrameAccumulator& sums = n_sums == 1 ? t_sums_[first_sum*n_tiles + tile] : t_total_;
+  sums.deviation(t_deviation_);
+
+  t_static_.create(t_deviation_.size(), CV_8U);
+  for (int row = 0; row < t_deviation_.rows; ++row) {
+    const uint8_t* dev = t_deviation_.ptr<uint8_t>(row);
+    uint8_t* dst = t_static_.ptr<uint8_t>(row);
+    for (int x = 0; x < t_deviation_.cols; ++x, dev += 3) {
+      dst[x] = std::max(std::max(dev[0], dev[1]), dev[2]) <= max_deviation_ ? 255 : 0;
+    }
+  }
+
+  // The gradient is also high on the changing side of the edges of
+  // the logo, which have to be kept
+  cv::dilate(t_static_, t_static_, kernel_gradient_);
 }
 
 
 void OpenCVLogoFinder::go_to_frame(int frame_number)
 {
+  Profiler::Scope scope(profiler_, Profiler::Stage::SEEK);
+  count(Profiler::Counter::SEEKS);
+
   cap_.set(cv::CAP_PROP_POS_FRAMES, frame_number);
   current_frame_ = frame_number;
 }
@@ -190,6 +944,9 @@ void OpenCVLogoFinder::go_to_frame(int frame_number)
 
 void OpenCVLogoFinder::advance_frame()
 {
+  Profiler::Scope scope(profiler_, Profiler::Stage::GRAB);
+  count(Profiler::Counter::FRAMES_GRABBED);
+
   bool success = cap_.grab();
   if (!success) {
     throw mdl::FrameNotAvailableException(current_frame_);
@@ -200,34 +957,110 @@ void OpenCVLogoFinder::advance_frame()
 
 void OpenCVLogoFinder::get_frame()
 {
-  bool success = cap_.retrieve(t_frame_);
+  Profiler::Scope scope(profiler_, Profiler::Stage::RETRIEVE);
+  count(Profiler::Counter::FRAMES_RETRIEVED);
+
+  bool reduced = is_reduced();
+  bool success = cap_.retrieve(reduced ? t_source_frame_ : t_frame_);
   if (!success) {
     throw mdl::FrameNotAvailableException(current_frame_);
   }
+
+  if (reduced) {
+    Profiler::Scope scope(profiler_, Profiler::Stage::RESIZE);
+    cv::resize(t_source_frame_, t_frame_, analysis_size_, 0, 0, cv::INTER_AREA);
+  }
+}
+
+
+void OpenCVLogoFinder::count(Profiler::Counter counter)
+{
+  if (profiler_) {
+    profiler_->count(counter);
+  }
 }
 
 
-cv::Rect OpenCVLogoFinder::find_box_in_channel(const cv::Mat& average_frame, int channel)
+void OpenCVLogoFinder::find_boxes_fused(const cv::Mat& average_frame, const cv::Point& offset,
+                                        const cv::Size& min_size, const cv::Size& max_size, const cv::Mat& allowed,
+                                        std::vector<cv::Rect>& boxes, std::vector<ScoredBox>* candidates)
 {
-  cv::extractChannel(average_frame, t_grey_, channel);
-  cv::morphologyEx(t_grey_, t_gradient_, cv::MORPH_GRADIENT, kernel_gradient_);
-  cv::threshold(t_gradient_, t_thresh_, 190, 255, cv::THRESH_BINARY);
-  cv::morphologyEx(t_thresh_, t_closed_, cv::MORPH_CLOSE, kernel_close_, cv::Point(-1, -1), close_steps_);
+  // Closing n times with the 1-row kernel is the same as closing once
+  // with a kernel n times wider
+  {
+    Profiler::Scope scope(profiler_, Profiler::Stage::MORPHOLOGY);
+    t_box_extractor_.extract_masks(average_frame, gradient_threshold_, close_steps_ * (kernel_close_.cols / 2),
+                                   allowed);
+  }
+
+  for (int channel = 0; channel <= 2; ++channel) {
+    // The connected components take the place of the contours
+    Profiler::Scope scope(profiler_, Profiler::Stage::CONTOURS);
+    cv::Rect box;
+    if (candidates) {
+      // The first box is the one find_box() would return
+      size_t n_candidates = candidates->size();
+      t_box_extractor_.find_boxes(channel, min_size, max_size, offset, *candidates);
+      if (candidates->size() > n_candidates) {
+        box = (*candidates)[n_candidates].box;
+      }
+    } else {
+      box = t_box_extractor_.find_box(channel, min_size, max_size);
+      if (box.width > 0) {
+        box += offset;
+      }
+    }
+    if (box.width > 0) {
+      INFO("    find_boxes_fused " << channel << " = " << RECT_STR(box) << std::endl);
+    } else {
+      INFO("    find_boxes_fused " << channel << " = not found" << std::endl);
+    }
+    boxes.push_back(box);
+  }
+}
+
+
+cv::Rect OpenCVLogoFinder::find_box_in_channel(const cv::Mat& average_frame, int channel, const cv::Point& offset,
+                                               std::vector<ScoredBox>* candidates)
+{
+  {
+    Profiler::Scope scope(profiler_, Profiler::Stage::MORPHOLOGY);
+    cv::extractChannel(average_frame, t_grey_, channel);
+    cv::morphologyEx(t_grey_, t_gradient_, cv::MORPH_GRADIENT, kernel_gradient_);
+    cv::threshold(t_gradient_, t_thresh_, gradient_threshold_, 255, cv::THRESH_BINARY);
+    if (detection_signal_ == DetectionSignal::VARIANCE) {
+      cv::bitwise_and(t_thresh_, t_static_, t_thresh_);
+    }
+    cv::morphologyEx(t_thresh_, t_closed_, cv::MORPH_CLOSE, kernel_close_, cv::Point(-1, -1), close_steps_);
+  }
 
   std::vector<std::vector<cv::Point>> contours;
-  cv::findContours(t_closed_, contours, cv::RETR_CCOMP, cv::CHAIN_APPROX_NONE);
+  {
+    Profiler::Scope scope(profiler_, Profiler::Stage::CONTOURS);
+    cv::findContours(t_closed_, contours, cv::RETR_CCOMP, cv::CHAIN_APPROX_NONE);
+  }
 
+  cv::Rect box(0, 0, 0, 0);
   for (auto& contour: contours) {
-    cv::Rect rect = cv::boundingRect(contour);
-    if ((rect.width >= min_logo_width_ && rect.width <= max_logo_width_)
-        && (rect.height >= min_logo_height_ && rect.height <= max_logo_height_)) {
-      INFO("    find_box_in_channel " << channel << " = " << RECT_STR(rect) << std::endl);
-      return rect;
+    cv::Rect rect = cv::boundingRect(contour) + offset;
+    if ((rect.width >= min_box_size_.width && rect.width <= max_box_size_.width)
+        && (rect.height >= min_box_size_.height && rect.height <= max_box_size_.height)) {
+      if (box.width == 0) {
+        box = rect;
+      }
+      if (!candidates) {
+        break;
+      }
+      candidates->push_back(ScoredBox{rect, cv::contourArea(contour) / rect.area()});
     }
   }
 
-  INFO("    find_box_in_channel " << channel << " = not found" << std::endl);
-  return cv::Rect(0, 0, 0, 0);
+  if (box.width > 0) {
+    INFO("    find_box_in_channel " << channel << " = " << RECT_STR(box) << std::endl);
+  } else {
+    INFO("    find_box_in_channel " << channel << " = not found" << std::endl);
+  }
+  return box;
 }
 
 
@@ -252,7 +1085,7 @@ cv::Rect OpenCVLogoFinder::select_box(const std::vector<cv::Rect>& boxes)
 
 int OpenCVLogoFinder::get_logo_transition_point(int current_frame, const cv::Rect& box)
 {
-  if (current_frame >= total_frames_) {
+  if (current_frame >= search_end_) {
     return current_frame;
   }
 
@@ -260,31 +1093,268 @@ int OpenCVLogoFinder::get_logo_transition_point(int current_frame, const cv::Rec
   if (extra_frames_to_check <= 0) {
     return current_frame;
   }
+  int end_frame = std::min(current_frame + extra_frames_to_check, search_end_);
 
-  get_frame();
-  for (int i = 0; i < extra_frames_to_check; ++i) {
-    cv::Mat logo = cv::Mat(t_frame_, box).clone();
+  Profiler::Scope scope(profiler_, Profiler::Stage::TRANSITION_SCAN);
+  TransitionFrames frames(*this, box);
+  TransitionSearch search(frames, similarity_threshold_);
+
+  int transition_point;
+  if (end_frame - current_frame >= min_bisection_frames_) {
+    transition_point = search.find_bisecting(current_frame, end_frame);
+  } else {
+    transition_point = search.find_linear(current_frame, end_frame);
+  }
+
+  INFO("  transition point " << transition_point << ", "
+       << frames.frames_read() << " frames read" << std::endl);
+  return transition_point;
+}
+
+
+void OpenCVLogoFinder::read_frame(int frame_number)
+{
+  // Frames a bit ahead are reached by decoding the ones before them,
+  // which is cheaper than seeking
+  if (current_frame_ < 0
+      || frame_number < current_frame_ - 1
+      || frame_number - current_frame_ > max_decode_forward_) {
+    go_to_frame(frame_number);
+  }
+
+  while (current_frame_ <= frame_number) {
     advance_frame();
-    get_frame();
-    cv::Mat logo_next = cv::Mat(t_frame_, box);
+  }
+  get_frame();
+}
+
 
-    double norm = cv::norm(logo, logo_next, cv::NORM_L2);
-    double difference = norm / (logo.rows * logo.cols);
+OpenCVLogoFinder::TransitionFrames::TransitionFrames(OpenCVLogoFinder& finder, const cv::Rect& box)
+  : finder_(finder)
+  , box_(box)
+  , frames_read_(0)
+{
+}
 
-    INFO("  extra frame " << current_frame << " difference = " << difference << std::endl);
 
-    if (difference > similarity_threshold_) {
-      break;
-    }
+double OpenCVLogoFinder::TransitionFrames::difference(int frame1, int frame2)
+{
+  cv::Mat logo1 = get_logo(frame1);
+  cv::Mat logo2 = get_logo(frame2);
+
+  double norm = cv::norm(logo1, logo2, cv::NORM_L2);
+  double difference = norm / (logo1.rows * logo1.cols);
+
+  if (finder_.verbose_) {
+    std::cout << "  frames " << frame1 << " and " << frame2
+              << " difference = " << difference << std::endl;
+  }
+  return difference;
+}
+
 
-    ++current_frame;
+int OpenCVLogoFinder::TransitionFrames::frames_read() const
+{
+  return frames_read_;
+}
+
+
+cv::Mat OpenCVLogoFinder::TransitionFrames::get_logo(int frame)
+{
+  auto it = std::find_if(logos_.begin(), logos_.end(),
+    [frame](const auto& logo) {
+      return logo.first == frame;
+    });
+  if (it != logos_.end()) {
+    // Keep the most recently used at the end
+    std::rotate(it, it + 1, logos_.end());
+    return logos_.back().second;
   }
 
-  return current_frame;
+  finder_.read_frame(frame);
+  ++frames_read_;
+  finder_.count(Profiler::Counter::TRANSITION_FRAMES);
+  finder_.keep_refine_crops(frame);
+
+  // Only the most recently used logos are kept, which is enough for
+  // comparisons with the reference and with the previous frame
+  if (logos_.size() == MAX_LOGOS_) {
+    logos_.pop_front();
+  }
+  logos_.push_back(std::make_pair(frame, cv::Mat(finder_.t_frame_, box_).clone()));
+  return logos_.back().second;
 }
 
 
 void OpenCVLogoFinder::stop()
 {
   stop_requested_ = true;
+
+  std::lock_guard<std::mutex> lock(jobs_mutex_);
+  for (auto& worker: workers_) {
+    worker->finder->stop();
+  }
+  if (scene_cut_detector_) {
+    scene_cut_detector_->request_stop();
+  }
+}
+
+
+void OpenCVLogoFinder::set_profiler(Profiler* profiler)
+{
+  profiler_ = profiler;
+}
+
+
+void OpenCVLogoFinder::start_workers()
+{
+  workers_finished_ = false;
+  for (int i = 0; i < threads_; ++i) {
+    std::unique_ptr<Worker> worker(new Worker());
+    worker->finder.reset(new OpenCVLogoFinder(file_, callback_, false));
+    copy_parameters_to(*worker->finder);
+    workers_.push_back(std::move(worker));
+  }
+
+  for (auto& worker: workers_) {
+    worker->thread = std::thread(&OpenCVLogoFinder::worker_loop, this, std::ref(*worker));
+  }
+}
+
+
+void OpenCVLogoFinder::stop_workers()
+{
+  {
+    std::lock_guard<std::mutex> lock(jobs_mutex_);
+    workers_finished_ = true;
+    pending_jobs_.clear();
+    for (auto& worker: workers_) {
+      worker->finder->stop();
+    }
+  }
+  jobs_available_.notify_all();
+
+  for (auto& worker: workers_) {
+    if (worker->thread.joinable()) {
+      worker->thread.join();
+    }
+  }
+
+  workers_.clear();
+  speculative_intervals_.clear();
+}
+
+
+void OpenCVLogoFinder::worker_loop(Worker& worker)
+{
+  while (true) {
+    std::shared_ptr<IntervalJob> job;
+    {
+      std::unique_lock<std::mutex> lock(jobs_mutex_);
+      jobs_available_.wait(lock, [this] {
+          return workers_finished_ || !pending_jobs_.empty();
+        });
+      if (workers_finished_) {
+        return;
+      }
+
+      job = pending_jobs_.front();
+      pending_jobs_.pop_front();
+      worker.current_job = job;
+      worker.finder->stop_requested_ = stop_requested_.load();
+    }
+
+    try {
+      job->logo.set_value(worker.finder->find_logo_in_interval(job->start_frame, job->end_frame,
+                                                               job->tracked_logos));
+    } catch (...) {
+      job->logo.set_exception(std::current_exception());
+    }
+
+    std::lock_guard<std::mutex> lock(jobs_mutex_);
+    worker.current_job.reset();
+  }
+}
+
+
+void OpenCVLogoFinder::copy_parameters_to(OpenCVLogoFinder& worker) const
+{
+  worker.min_logo_width_ = min_logo_width_;
+  worker.max_logo_width_ = max_logo_width_;
+  worker.min_logo_height_ = min_logo_height_;
+  worker.max_logo_height_ = max_logo_height_;
+
+  worker.analysis_height_ = analysis_height_;
+  worker.analysis_size_ = analysis_size_;
+  worker.min_box_size_ = min_box_size_;
+  worker.max_box_size_ = max_box_size_;
+
+  worker.sampling_mode_ = sampling_mode_;
+  worker.box_extraction_ = box_extraction_;
+
+  worker.steps_ = steps_;
+  worker.frame_step_ = frame_step_;
+  worker.gradient_threshold_ = gradient_threshold_;
+  worker.close_steps_ = close_steps_;
+  worker.similarity_threshold_ = similarity_threshold_;
+  worker.detection_signal_ = detection_signal_;
+  worker.max_deviation_ = max_deviation_;
+  worker.max_tracked_logos_ = max_tracked_logos_;
+  worker.max_logos_ = max_logos_;
+
+  // The memory for frames decoded ahead is shared by all workers
+  worker.decode_buffer_size_ = decode_buffer_size_ > 0
+    ? std::max(1, decode_buffer_size_ / threads_)
+    : 0;
+
+  worker.corner_size_ = corner_size_;
+  worker.search_regions_ = search_regions_;
+  worker.search_tiles_ = search_tiles_;
+
+  worker.cache_ = cache_;
+  worker.profiler_ = profiler_;
+}
+
+
+void OpenCVLogoFinder::schedule_speculative_intervals()
+{
+  size_t max_in_flight = 2 * workers_.size();
+
+  while (speculative_intervals_.size() < max_in_flight
+         && next_speculative_start_ < search_end_ && !stop_requested_) {
+    std::shared_ptr<IntervalJob> job(new IntervalJob());
+    job->start_frame = next_speculative_start_;
+    // Might wait for the scene cut detector, so it is called without
+    // the lock, which stop() takes
+    job->end_frame = get_interval_end(next_speculative_start_);
+    // The logos found until now. If the intervals before this one
+    // find others, it is analysed again by analyze_interval()
+    job->tracked_logos = tracked_logos_;
+
+    speculative_intervals_.push_back(SpeculativeInterval{job->start_frame, job->end_frame,
+                                                         tracked_logos_version_, job->logo.get_future()});
+    {
+      std::lock_guard<std::mutex> lock(jobs_mutex_);
+      pending_jobs_.push_back(job);
+    }
+    jobs_available_.notify_one();
+
+    next_speculative_start_ = job->end_frame;
+  }
+}
+
+
+void OpenCVLogoFinder::discard_speculative_intervals()
+{
+  std::lock_guard<std::mutex> lock(jobs_mutex_);
+  pending_jobs_.clear();
+
+  // Abort the intervals being analysed, they are not needed anymore
+  for (auto& worker: workers_) {
+    if (worker->current_job) {
+      worker->finder->stop_requested_ = true;
+    }
+  }
+
+  speculative_intervals_.clear();
 }
@@ -21,25 +21,72 @@
 
 #include <string>
 #include <vector>
+#include <deque>
+#include <map>
+#include <memory>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <future>
+#include <atomic>
+#include <utility>
 
 #include <opencv2/videoio.hpp>
 
 #include "gui/common/LogoFinder.hpp"
 
+#include "FrameAccumulator.hpp"
+#include "FrameReader.hpp"
+#include "AccumulatorCache.hpp"
+#include "BoxExtractor.hpp"
+#include "TransitionSearch.hpp"
+#include "SceneCutDetector.hpp"
+#include "Profiler.hpp"
+
 
 namespace mdl { namespace opencv {
   class OpenCVLogoFinder: public LogoFinder
   {
   public:
     OpenCVLogoFinder(const std::string& file, LogoFinderCallback& callback, bool verbose);
+    ~OpenCVLogoFinder();
+
+    int get_total_frames() const override;
 
     OpenCVLogoFinder::find_result find_logos() override;
 
     void stop() override;
 
+    /**
+     * If not null, the time spent in each stage of the search and the
+     * work done are recorded there.
+     */
+    void set_profiler(Profiler* profiler);
+
   private:
+    std::string file_;
     cv::VideoCapture cap_;
     int total_frames_;
+    int frame_width_;
+    int frame_height_;
+
+    /**
+     * Size the frames are reduced to, right after being decoded, to
+     * be searched, calculated from analysis_height_ when the search
+     * starts. The search tiles, the boxes found and the logos tracked
+     * are in pixels of the reduced frames, and the logo sizes are
+     * converted to them.
+     */
+    cv::Size analysis_size_;
+    cv::Size min_box_size_;
+    cv::Size max_box_size_;
+
+    /**
+     * Parts of the frame that are analysed, calculated from the
+     * corners and search regions when the search starts. Only these
+     * pixels are accumulated and searched for logos.
+     */
+    std::vector<cv::Rect> search_tiles_;
 
     cv::Mat kernel_sharpen_;
     cv::Mat kernel_gradient_;
@@ -47,63 +94,232 @@ namespace mdl { namespace opencv {
 
     int n_last_failures_;
 
-    bool stop_requested_;
+    std::atomic<bool> stop_requested_;
 
+    // Frame the capture is positioned at, or -1 if unknown
     int current_frame_;
 
+    // End of the range being searched, no frame after it is read
+    int search_end_;
+
+    std::unique_ptr<FrameReader> frame_reader_;
+
+    // Shared with the workers
+    std::shared_ptr<AccumulatorCache> cache_;
+
+    std::unique_ptr<SceneCutDetector> scene_cut_detector_;
+
+    Profiler* profiler_ = nullptr;
+
     /**
      * Number of steps to do while searching for the logo in an
      * interval. The first step considers the whole interval, the
      * second divides the interval in to subintervals, the third
      * divides each of the two in two more, for a total of four, and
-     * so on. Bigger makes the search slower, but might find more
-     * logos.
+     * so on. Bigger might find more logos. The frames are decoded
+     * only once regardless of the number of steps, so it only makes
+     * the analysis of the averages slower.
      */
     int steps_ = 2;
     /**
-     * Step between frames used to calculate the average. Bigger makes
-     * it faster, but possibly less accurate.
+     * Minimum number of extra frames for the logo transition point to
+     * be searched by bisection instead of checking every frame.
+     */
+    int min_bisection_frames_ = 16;
+    /**
+     * Maximum number of frames decoded to reach a frame ahead of the
+     * current position. Frames further away are reached by seeking.
      */
-    int frame_step_ = 10;
+    int max_decode_forward_ = 100;
     /**
-     * Number of times to apply CLOSE morphology.
+     * Minimum normalized cross-correlation between a tracked logo and
+     * the average of an interval for the logo to be considered found.
      */
-    int close_steps_ = 3;
+    double template_match_threshold_ = 0.9;
     /**
-     * Threshold for similarity when searching for the logo in extra
-     * frames (when the frame interval is not constant). Higher might
-     * detect the logo in case the background changes a lot, but can
-     * also generate more incorrect results.
+     * Distance, in pixels, a tracked logo is allowed to move from one
+     * interval to the next.
      */
-    double similarity_threshold_ = 0.7;
+    int template_match_margin_ = 2;
+    /**
+     * Minimum number of sampled frames of an interval ended by a
+     * scene cut. Cuts closer to the start of the interval are
+     * ignored.
+     */
+    int min_scene_cut_samples_ = 8;
+    /**
+     * Number of frames, at the original resolution, averaged to
+     * refine the box of a logo found in reduced frames.
+     */
+    int refine_frames_ = 8;
+
+
+    // Logo found in an interval, with its average in the interval,
+    // which is used to look for it in the next intervals, and the
+    // other logos shown with it when max_logos_ > 1
+    struct IntervalLogo
+    {
+      cv::Rect box;
+      cv::Mat average;
+      std::vector<cv::Rect> other_boxes;
+    };
 
+    // Last logos found, the most recent first
+    std::deque<IntervalLogo> tracked_logos_;
+    // Incremented whenever tracked_logos_ changes
+    unsigned long tracked_logos_version_ = 0;
 
-    cv::Rect find_logo_in_interval(int interval_start, int interval_end);
 
-    cv::Rect find_boxes(int start_frame, int end_frame);
+    void search_range(int start_frame, int end_frame, int initial_failures);
+    int get_interval_end(int interval_start);
+    IntervalLogo analyze_interval(int interval_start, int interval_end);
+    IntervalLogo find_logo_in_interval(int interval_start, int interval_end,
+                                       const std::deque<IntervalLogo>& tracked_logos);
+    cv::Rect find_boxes_in_levels();
+    cv::Rect match_tracked_logos(const std::deque<IntervalLogo>& tracked_logos, int n_sums);
+    cv::Mat get_interval_average(const cv::Rect& box, int n_sums);
+    std::vector<cv::Rect> find_other_logos(const cv::Rect& box, int n_sums);
+    void track_logo(const IntervalLogo& logo);
+    int get_tile(const cv::Rect& box) const;
 
-    void average_frame(int start_frame, int end_frame);
+    void calculate_analysis_size();
+    bool is_reduced() const;
+    cv::Rect to_analysis(const cv::Rect& rect) const;
+    cv::Rect to_source(const cv::Rect& rect) const;
+    std::vector<cv::Rect> get_refine_areas(const std::vector<cv::Rect>& boxes) const;
+    void keep_refine_crops(int frame);
+    std::vector<cv::Rect> refine_boxes(const std::vector<cv::Rect>& boxes, int start_frame, int end_frame);
+    void calculate_search_tiles();
+    void open_cache();
+    void start_scene_cut_detector(int start_frame);
+    void stop_scene_cut_detector();
+
+    cv::Rect find_boxes(int first_sum, int n_sums);
+
+    void accumulate_subintervals(const std::vector<std::pair<int, int>>& subintervals);
+    bool load_sums_from_cache();
+    void save_sums_to_cache();
+    void decode_subintervals(int start_frame, int end_frame);
+    void accumulate_decoded_ahead(int start_frame, int end_frame);
+    void add_to_sums(const cv::Mat& frame, int frame_number, size_t& subinterval);
+    bool average_frame(int first_sum, int n_sums, int tile);
+    void calculate_static_mask(int first_sum, int n_sums, int tile);
     void go_to_frame(int frame_number);
     void advance_frame();
     void get_frame();
+    void read_frame(int frame_number);
+    void count(Profiler::Counter counter);
 
-    cv::Rect find_box_in_channel(const cv::Mat& average_frame, int channel);
+    void find_boxes_fused(const cv::Mat& average_frame, const cv::Point& offset,
+                          const cv::Size& min_size, const cv::Size& max_size, const cv::Mat& allowed,
+                          std::vector<cv::Rect>& boxes, std::vector<ScoredBox>* candidates);
+    cv::Rect find_box_in_channel(const cv::Mat& average_frame, int channel, const cv::Point& offset,
+                                 std::vector<ScoredBox>* candidates);
     cv::Rect select_box(const std::vector<cv::Rect>& boxes);
 
     int get_logo_transition_point(int current_frame, const cv::Rect& box);
 
+    // Logos of the frames compared while searching the transition point
+    class TransitionFrames : public TransitionSearch::Frames
+    {
+    public:
+      TransitionFrames(OpenCVLogoFinder& finder, const cv::Rect& box);
+
+      double difference(int frame1, int frame2) override;
+      int frames_read() const;
+
+    private:
+      const static size_t MAX_LOGOS_;
+
+      OpenCVLogoFinder& finder_;
+      cv::Rect box_;
+      std::deque<std::pair<int, cv::Mat>> logos_;
+      int frames_read_;
+
+      cv::Mat get_logo(int frame);
+    };
+
     // Temporary variables
     // They were made class members so that they are allocated only once
     cv::Mat t_avg_;   // Last average frame
     cv::Mat t_frame_; // Last frame read
+    cv::Mat t_source_frame_; // Last frame read, before being reduced
+    // Sums of the sampled frames of each subinterval of the last
+    // search level, from which the averages of all levels are
+    // calculated. There is one sum for each search tile of each
+    // subinterval, the tiles of a subinterval being consecutive
+    std::vector<std::pair<int, int>> t_subintervals_;
+    std::vector<FrameAccumulator> t_sums_;
     // The ones below are used only in one function each
-    cv::Mat t_avg_f_;
-    cv::Mat t_frame_f_;
+    FrameAccumulator t_total_;
+    BoxExtractor t_box_extractor_;
     cv::Mat t_sharpened_;
     cv::Mat t_grey_;
     cv::Mat t_gradient_;
     cv::Mat t_thresh_;
     cv::Mat t_closed_;
+    cv::Mat t_match_;
+    cv::Mat t_deviation_;
+    cv::Mat t_static_; // Pixels next to the ones that barely change
+    std::vector<FrameAccumulator> t_refine_sums_;
+    // Parts of the original frames around the boxes being refined,
+    // and those parts of the frames read by the search for the
+    // transition point, by frame number
+    std::vector<cv::Rect> t_refine_areas_;
+    std::map<int, std::vector<cv::Mat>> t_refine_crops_;
+    // All the boxes that fit the logo sizes found by the last call to
+    // find_boxes(), when max_logos_ > 1, and the number of sums it
+    // averaged if it started at the first one (0 otherwise)
+    std::vector<ScoredBox> t_candidates_;
+    int t_candidates_sums_ = 0;
+
+
+    // Parallel search
+    // Each worker is a finder with its own capture, that analyses
+    // intervals speculatively, assuming that each one starts where
+    // the previous one ended. The results are consumed in frame order
+    // by analyze_interval(), which discards the speculation whenever
+    // a logo transition point moves the start of the next interval.
+    // An interval analysed with tracked logos that changed before its
+    // result was consumed is analysed again with the current ones, so
+    // the results don't depend on the number of threads.
+    struct IntervalJob
+    {
+      int start_frame;
+      int end_frame;
+      std::deque<IntervalLogo> tracked_logos;
+      std::promise<IntervalLogo> logo;
+    };
+
+    struct SpeculativeInterval
+    {
+      int start_frame;
+      int end_frame;
+      unsigned long tracked_logos_version;
+      std::future<IntervalLogo> logo;
+    };
+
+    struct Worker
+    {
+      std::unique_ptr<OpenCVLogoFinder> finder;
+      std::thread thread;
+      std::shared_ptr<IntervalJob> current_job;
+    };
+
+    std::vector<std::unique_ptr<Worker>> workers_;
+    std::deque<std::shared_ptr<IntervalJob>> pending_jobs_;
+    std::deque<SpeculativeInterval> speculative_intervals_;
+    int next_speculative_start_;
+    bool workers_finished_;
+    std::mutex jobs_mutex_;
+    std::condition_variable jobs_available_;
+
+    void start_workers();
+    void stop_workers();
+    void worker_loop(Worker& worker);
+    void copy_parameters_to(OpenCVLogoFinder& worker) const;
+    void schedule_speculative_intervals();
+    void discard_speculative_intervals();
   };
 } }
 
@@ -0,0 +1,376 @@
+/*
+ * Copyright (C) 2018-2025 Werner Turing <werner.turing@protonmail.com>
+ *
+ * This file is part of multi-delogo.
+ *
+ * multi-delogo is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * multi-delogo is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with multi-delogo.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include <string>
+#include <vector>
+#include <array>
+#include <memory>
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <mutex>
+#include <thread>
+#include <ostream>
+#include <iomanip>
+
+#include "Profiler.hpp"
+
+using namespace mdl::opencv;
+
+
+namespace {
+  struct StageInfo
+  {
+    const char* name;
+    bool traced;
+  };
+
+  // In the order of Profiler::Stage. The stages run for every frame
+  // are not traced
+  const StageInfo STAGE_INFO[] = {
+    {"accumulate", true},
+    {"add_to_sums", false},
+    {"average_frame", true},
+    {"contours", true},
+    {"filter2D", true},
+    {"grab", false},
+    {"morphology", true},
+    {"other logos", true},
+    {"refine box", true},
+    {"resize", false},
+    {"retrieve", false},
+    {"scene cut histograms", false},
+    {"seek", false},
+    {"static mask", true},
+    {"template match", true},
+    {"transition scan", true},
+    {"wait for decoded frame", false},
+    {"wait for free slot", false},
+    {"wait for scene cuts", true}
+  };
+
+  // In the order of Profiler::Counter
+  const char* const COUNTER_NAMES[] = {
+    "boxes refined",
+    "cache hits",
+    "cache misses",
+    "frames decoded by the scene cut scan",
+    "frames grabbed",
+    "frames read to refine boxes",
+    "frames retrieved",
+    "intervals",
+    "intervals analysed again",
+    "intervals ended by scene cuts",
+    "other logos found",
+    "scene cuts",
+    "seeks",
+    "tracked logos found",
+    "tracked logos not found",
+    "transition frames"
+  };
+
+  // Only the thread of the value writes it, so it doesn't need an
+  // atomic (locked) addition
+  template<typename T>
+  void add_to(std::atomic<T>& value, T n)
+  {
+    value.store(value.load(std::memory_order_relaxed) + n, std::memory_order_relaxed);
+  }
+}
+
+
+std::atomic<long long> Profiler::next_id_(0);
+
+
+Profiler::Scope::Scope(Profiler* profiler, Stage stage)
+  : profiler_(profiler)
+  , stage_(stage)
+{
+  if (profiler_) {
+    start_ = clock::now();
+  }
+}
+
+
+Profiler::Scope::~Scope()
+{
+  if (profiler_) {
+    profiler_->add(stage_, start_, clock::now());
+  }
+}
+
+
+Profiler::ThreadData::ThreadData(std::thread::id id, int index)
+  : id(id)
+  , index(index)
+{
+  for (auto& r: runs) {
+    r.store(0);
+  }
+  for (auto& t: totals) {
+    t.store(0);
+  }
+  for (auto& c: counters) {
+    c.store(0);
+  }
+}
+
+
+Profiler::Profiler(bool trace)
+  : id_(next_id_++)
+  , trace_(trace)
+  , start_(clock::now())
+  , max_trace_events_(DEFAULT_MAX_TRACE_EVENTS)
+  , dropped_trace_events_(0)
+{
+  static_assert(sizeof(STAGE_INFO) / sizeof(STAGE_INFO[0]) == static_cast<size_t>(STAGES),
+                "A stage has no name");
+  static_assert(sizeof(COUNTER_NAMES) / sizeof(COUNTER_NAMES[0]) == static_cast<size_t>(COUNTERS),
+                "A counter has no name");
+}
+
+
+void Profiler::set_max_trace_events(size_t max_trace_events)
+{
+  std::lock_guard<std::mutex> lock(mutex_);
+  max_trace_events_ = max_trace_events;
+}
+
+
+void Profiler::add(Stage stage, clock::time_point start, clock::time_point end)
+{
+  ThreadData& data = thread_data();
+  int i = static_cast<int>(stage);
+  add_to(data.runs[i], 1);
+  add_to(data.totals[i], (end - start).count());
+
+  if (trace_ && STAGE_INFO[i].traced) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (events_.size() < max_trace_events_) {
+      events_.push_back(Event{stage, data.index, start, end});
+    } else {
+      ++dropped_trace_events_;
+    }
+  }
+}
+
+
+void Profiler::count(Counter counter, long long n)
+{
+  add_to(thread_data().counters[static_cast<int>(counter)], n);
+}
+
+
+int Profiler::get_runs(Stage stage) const
+{
+  std::lock_guard<std::mutex> lock(mutex_);
+  int runs = 0;
+  for (auto& data: threads_) {
+    runs += data->runs[static_cast<int>(stage)].load(std::memory_order_relaxed);
+  }
+  return runs;
+}
+
+
+double Profiler::get_seconds(Stage stage) const
+{
+  std::lock_guard<std::mutex> lock(mutex_);
+  return std::chrono::duration<double>(get_total(stage)).count();
+}
+
+
+long long Profiler::get_count(Counter counter) const
+{
+  std::lock_guard<std::mutex> lock(mutex_);
+  long long count = 0;
+  for (auto& data: threads_) {
+    count += data->counters[static_cast<int>(counter)].load(std::memory_order_relaxed);
+  }
+  return count;
+}
+
+
+size_t Profiler::get_dropped_trace_events() const
+{
+  std::lock_guard<std::mutex> lock(mutex_);
+  return dropped_trace_events_;
+}
+
+
+const char* Profiler::get_name(Stage stage)
+{
+  return STAGE_INFO[static_cast<int>(stage)].name;
+}
+
+
+const char* Profiler::get_name(Counter counter)
+{
+  return COUNTER_NAMES[static_cast<int>(counter)];
+}
+
+
+void Profiler::write_summary(std::ostream& out) const
+{
+  struct StageTotal
+  {
+    Stage stage;
+    int runs;
+    clock::duration total;
+  };
+
+  double elapsed = std::chrono::duration<double>(clock::now() - start_).count();
+
+  std::vector<StageTotal> stages;
+  for (int i = 0; i < STAGES; ++i) {
+    Stage stage = static_cast<Stage>(i);
+    int runs = get_runs(stage);
+    if (runs > 0) {
+      std::lock_guard<std::mutex> lock(mutex_);
+      stages.push_back(StageTotal{stage, runs, get_total(stage)});
+    }
+  }
+  // Slowest stages first
+  std::sort(stages.begin(), stages.end(),
+    [](const StageTotal& s1, const StageTotal& s2) {
+      return s1.total > s2.total;
+    });
+
+  std::ios::fmtflags flags = out.flags();
+  out << std::fixed;
+
+  out << std::left << std::setw(24) << "Stage"
+      << std::right << std::setw(10) << "Runs"
+      << std::setw(14) << "Total (s)"
+      << std::setw(14) << "Average (ms)"
+      << std::setw(10) << "% time" << std::endl;
+  for (auto& stage: stages) {
+    double seconds = std::chrono::duration<double>(stage.total).count();
+    out << std::left << std::setw(24) << get_name(stage.stage)
+        << std::right << std::setw(10) << stage.runs
+        << std::setw(14) << std::setprecision(3) << seconds
+        << std::setw(14) << std::setprecision(3) << 1000 * seconds / stage.runs
+        << std::setw(10) << std::setprecision(1) << (elapsed > 0 ? 100 * seconds / elapsed : 0)
+        << std::endl;
+  }
+  out << "Total time: " << std::setprecision(3) << elapsed << "s" << std::endl;
+
+  bool header = false;
+  for (int i = 0; i < COUNTERS; ++i) {
+    Counter counter = static_cast<Counter>(i);
+    long long value = get_count(counter);
+    if (value == 0) {
+      continue;
+    }
+    if (!header) {
+      out << std::endl
+          << std::left << std::setw(24) << "Counter"
+          << std::right << std::setw(10) << "Value" << std::endl;
+      header = true;
+    }
+    out << std::left << std::setw(24) << get_name(counter)
+        << std::right << std::setw(10) << value << std::endl;
+  }
+
+  size_t dropped = get_dropped_trace_events();
+  if (dropped > 0) {
+    out << std::endl << dropped << " run(s) left out of the trace" << std::endl;
+  }
+
+  out.flags(flags);
+}
+
+
+void Profiler::write_trace(std::ostream& out) const
+{
+  std::vector<long long> counts;
+  for (int i = 0; i < COUNTERS; ++i) {
+    counts.push_back(get_count(static_cast<Counter>(i)));
+  }
+
+  std::lock_guard<std::mutex> lock(mutex_);
+
+  // The names are string literals from the code, so they do not need
+  // to be escaped
+  out << "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[";
+  const char* separator = "\n";
+  for (auto& event: events_) {
+    out << separator
+        << "{\"name\":\"" << get_name(event.stage) << "\",\"cat\":\"logo-finder\",\"ph\":\"X\""
+        << ",\"pid\":1,\"tid\":" << event.thread
+        << ",\"ts\":" << microseconds(event.start)
+        << ",\"dur\":" << microseconds(event.end) - microseconds(event.start) << "}";
+    separator = ",\n";
+  }
+
+  long long end = microseconds(clock::now());
+  for (int i = 0; i < COUNTERS; ++i) {
+    if (counts[i] == 0) {
+      continue;
+    }
+    out << separator
+        << "{\"name\":\"" << get_name(static_cast<Counter>(i)) << "\",\"ph\":\"C\",\"pid\":1,\"tid\":0"
+        << ",\"ts\":" << end
+        << ",\"args\":{\"value\":" << counts[i] << "}}";
+    separator = ",\n";
+  }
+  out << "\n]}" << std::endl;
+}
+
+
+Profiler::ThreadData& Profiler::thread_data()
+{
+  // Each thread remembers its data in the last profiler it used, so
+  // that the lock is taken only the first time
+  thread_local long long cached_id = -1;
+  thread_local ThreadData* cached_data = nullptr;
+  if (cached_id == id_) {
+    return *cached_data;
+  }
+
+  std::lock_guard<std::mutex> lock(mutex_);
+  std::thread::id thread = std::this_thread::get_id();
+  auto it = std::find_if(threads_.begin(), threads_.end(),
+    [thread](const std::unique_ptr<ThreadData>& data) {
+      return data->id == thread;
+    });
+  if (it == threads_.end()) {
+    threads_.emplace_back(new ThreadData(thread, threads_.size()));
+    it = threads_.end() - 1;
+  }
+
+  cached_id = id_;
+  cached_data = it->get();
+  return *cached_data;
+}
+
+
+// Called with the lock taken
+Profiler::clock::duration Profiler::get_total(Stage stage) const
+{
+  clock::rep total = 0;
+  for (auto& data: threads_) {
+    total += data->totals[static_cast<int>(stage)].load(std::memory_order_relaxed);
+  }
+  return clock::duration(total);
+}
+
+
+long long Profiler::microseconds(clock::time_point time) const
+{
+  return std::chrono::duration_cast<std::chrono::microseconds>(time - start_).count();
+}
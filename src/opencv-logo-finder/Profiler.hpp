@@ -0,0 +1,192 @@
+/*
+ * Copyright (C) 2018-2025 Werner Turing <werner.turing@protonmail.com>
+ *
+ * This file is part of multi-delogo.
+ *
+ * multi-delogo is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * multi-delogo is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with multi-delogo.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#ifndef MDL_OPENCV_PROFILER_H
+#define MDL_OPENCV_PROFILER_H
+
+#include <string>
+#include <vector>
+#include <array>
+#include <memory>
+#include <atomic>
+#include <chrono>
+#include <mutex>
+#include <thread>
+#include <ostream>
+
+
+namespace mdl { namespace opencv {
+  /**
+   * Collects the time spent in each stage of the logo search and
+   * counters of the work done (frames decoded, seeks and so on).
+   *
+   * It can be shared by several threads. Each thread adds up its own
+   * times and counters, without taking a lock, and they are added
+   * together when read.
+   *
+   * When tracing, each run of a stage is also kept as an event of a
+   * trace that can be opened in Chrome (chrome://tracing) or
+   * Perfetto, except for the stages run for every frame, which would
+   * make the trace too big. Only the first events, up to a maximum,
+   * are kept.
+   */
+  class Profiler
+  {
+  public:
+    typedef std::chrono::steady_clock clock;
+
+    enum class Stage
+    {
+      ACCUMULATE,
+      ADD_TO_SUMS,
+      AVERAGE_FRAME,
+      CONTOURS,
+      FILTER_2D,
+      GRAB,
+      MORPHOLOGY,
+      OTHER_LOGOS,
+      REFINE_BOX,
+      RESIZE,
+      RETRIEVE,
+      SCENE_CUT_HISTOGRAMS,
+      SEEK,
+      STATIC_MASK,
+      TEMPLATE_MATCH,
+      TRANSITION_SCAN,
+      WAIT_FOR_DECODED_FRAME,
+      WAIT_FOR_FREE_SLOT,
+      WAIT_FOR_SCENE_CUTS
+    };
+
+    enum class Counter
+    {
+      BOXES_REFINED,
+      CACHE_HITS,
+      CACHE_MISSES,
+      FRAMES_DECODED_BY_SCENE_CUT_SCAN,
+      FRAMES_GRABBED,
+      FRAMES_READ_TO_REFINE_BOXES,
+      FRAMES_RETRIEVED,
+      INTERVALS,
+      INTERVALS_ANALYSED_AGAIN,
+      INTERVALS_ENDED_BY_SCENE_CUTS,
+      OTHER_LOGOS_FOUND,
+      SCENE_CUTS,
+      SEEKS,
+      TRACKED_LOGOS_FOUND,
+      TRACKED_LOGOS_NOT_FOUND,
+      TRANSITION_FRAMES
+    };
+
+    /**
+     * Measures a run of a stage, from its construction to its
+     * destruction. Does nothing if the profiler is null, so that the
+     * scopes can be left in the code when profiling is off.
+     */
+    class Scope
+    {
+    public:
+      Scope(Profiler* profiler, Stage stage);
+      ~Scope();
+
+      Scope(const Scope&) = delete;
+      Scope& operator=(const Scope&) = delete;
+
+    private:
+      Profiler* profiler_;
+      Stage stage_;
+      clock::time_point start_;
+    };
+
+    static const size_t DEFAULT_MAX_TRACE_EVENTS = 1000000;
+
+    explicit Profiler(bool trace = false);
+
+    void set_max_trace_events(size_t max_trace_events);
+
+    void add(Stage stage, clock::time_point start, clock::time_point end);
+    void count(Counter counter, long long n = 1);
+
+    int get_runs(Stage stage) const;
+    double get_seconds(Stage stage) const;
+    long long get_count(Counter counter) const;
+    size_t get_dropped_trace_events() const;
+
+    static const char* get_name(Stage stage);
+    static const char* get_name(Counter counter);
+
+    /**
+     * Writes a table with the total and average time of each stage
+     * and the value of each counter. The time of the stages run in
+     * parallel by several threads is added up, so the percentages of
+     * the total time can add up to more than 100%.
+     */
+    void write_summary(std::ostream& out) const;
+
+    /**
+     * Writes the runs of the stages in the Chrome trace event format
+     * (JSON). The counters are written as counter events at the end.
+     */
+    void write_trace(std::ostream& out) const;
+
+  private:
+    static const int STAGES = static_cast<int>(Stage::WAIT_FOR_SCENE_CUTS) + 1;
+    static const int COUNTERS = static_cast<int>(Counter::TRANSITION_FRAMES) + 1;
+
+    // Written only by its thread, the atomics let the totals be read
+    // by the others while it runs
+    struct ThreadData
+    {
+      ThreadData(std::thread::id id, int index);
+
+      std::thread::id id;
+      int index;
+      std::array<std::atomic<int>, STAGES> runs;
+      std::array<std::atomic<clock::rep>, STAGES> totals;
+      std::array<std::atomic<long long>, COUNTERS> counters;
+    };
+
+    struct Event
+    {
+      Stage stage;
+      int thread;
+      clock::time_point start;
+      clock::time_point end;
+    };
+
+    static std::atomic<long long> next_id_;
+
+    const long long id_;
+    const bool trace_;
+    clock::time_point start_;
+
+    std::vector<std::unique_ptr<ThreadData>> threads_;
+    std::vector<Event> events_;
+    size_t max_trace_events_;
+    size_t dropped_trace_events_;
+
+    mutable std::mutex mutex_;
+
+    ThreadData& thread_data();
+    clock::duration get_total(Stage stage) const;
+    long long microseconds(clock::time_point time) const;
+  };
+} }
+
+
+#endif // MDL_OPENCV_PROFILER_H
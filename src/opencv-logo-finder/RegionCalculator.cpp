@@ -0,0 +1,80 @@
+/*
+ * Copyright (C) 2018-2025 Werner Turing <werner.turing@protonmail.com>
+ *
+ * This file is part of multi-delogo.
+ *
+ * multi-delogo is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * multi-delogo is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with multi-delogo.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include <vector>
+#include <cmath>
+
+#include <opencv2/core.hpp>
+
+#include "RegionCalculator.hpp"
+
+using namespace mdl::opencv;
+
+
+std::vector<cv::Rect> RegionCalculator::get_corners(int frame_width, int frame_height, double corner_size)
+{
+  int width = std::lround(frame_width * corner_size);
+  int height = std::lround(frame_height * corner_size);
+  if (2*width >= frame_width || 2*height >= frame_height) {
+    return {cv::Rect(0, 0, frame_width, frame_height)};
+  }
+
+  return {cv::Rect(0, 0, width, height),
+          cv::Rect(frame_width - width, 0, width, height),
+          cv::Rect(0, frame_height - height, width, height),
+          cv::Rect(frame_width - width, frame_height - height, width, height)};
+}
+
+
+std::vector<cv::Rect> RegionCalculator::get_tiles(int frame_width, int frame_height, const std::vector<cv::Rect>& regions)
+{
+  cv::Rect frame(0, 0, frame_width, frame_height);
+
+  std::vector<cv::Rect> tiles;
+  for (auto& region: regions) {
+    cv::Rect tile = region & frame;
+    if (!tile.empty()) {
+      tiles.push_back(tile);
+    }
+  }
+
+  if (tiles.empty()) {
+    return {frame};
+  }
+
+  while (merge_overlapping(tiles)) {
+  }
+
+  return tiles;
+}
+
+
+bool RegionCalculator::merge_overlapping(std::vector<cv::Rect>& tiles)
+{
+  for (size_t i = 0; i < tiles.size(); ++i) {
+    for (size_t j = i + 1; j < tiles.size(); ++j) {
+      if (!(tiles[i] & tiles[j]).empty()) {
+        tiles[i] |= tiles[j];
+        tiles.erase(tiles.begin() + j);
+        return true;
+      }
+    }
+  }
+
+  return false;
+}
@@ -0,0 +1,52 @@
+/*
+ * Copyright (C) 2018-2025 Werner Turing <werner.turing@protonmail.com>
+ *
+ * This file is part of multi-delogo.
+ *
+ * multi-delogo is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * multi-delogo is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with multi-delogo.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#ifndef MDL_OPENCV_REGION_CALCULATOR_H
+#define MDL_OPENCV_REGION_CALCULATOR_H
+
+#include <vector>
+
+#include <opencv2/core.hpp>
+
+
+namespace mdl { namespace opencv {
+  class RegionCalculator
+  {
+  public:
+    /**
+     * Returns the four corners of the frame, each one with
+     * corner_size of the frame width and height. If the corners
+     * would touch, the whole frame is returned.
+     */
+    static std::vector<cv::Rect> get_corners(int frame_width, int frame_height, double corner_size);
+
+    /**
+     * Returns the tiles that have to be analysed to search the
+     * regions: they are clipped to the frame, and overlapping regions
+     * are merged so that no pixel is analysed twice. Without regions
+     * the whole frame is returned.
+     */
+    static std::vector<cv::Rect> get_tiles(int frame_width, int frame_height, const std::vector<cv::Rect>& regions);
+
+  private:
+    static bool merge_overlapping(std::vector<cv::Rect>& tiles);
+  };
+} }
+
+
+#endif // MDL_OPENCV_REGION_CALCULATOR_H
@@ -0,0 +1,236 @@
+/*
+ * Copyright (C) 2018-2025 Werner Turing <werner.turing@protonmail.com>
+ *
+ * This file is part of multi-delogo.
+ *
+ * multi-delogo is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * multi-delogo is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with multi-delogo.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include <string>
+#include <vector>
+#include <algorithm>
+#include <cmath>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+
+#include <opencv2/core.hpp>
+#include <opencv2/imgproc.hpp>
+#include <opencv2/videoio.hpp>
+
+#include "SceneCutDetector.hpp"
+#include "IntervalCalculator.hpp"
+#include "Profiler.hpp"
+
+using namespace mdl::opencv;
+
+
+// Bins of the histogram of each channel
+const int SceneCutDetector::BINS_ = 16;
+// Factor by which the tiles are scaled down before the histograms
+const int SceneCutDetector::SCALE_ = 8;
+
+
+SceneCutDetector::SceneCutDetector(const std::vector<cv::Rect>& tiles, double threshold)
+  : tiles_(tiles)
+  , threshold_(threshold)
+  , last_distance_(0)
+  , profiler_(nullptr)
+  , scanned_until_(0)
+  , finished_(false)
+  , stop_requested_(false)
+{
+}
+
+
+SceneCutDetector::~SceneCutDetector()
+{
+  stop();
+}
+
+
+bool SceneCutDetector::add(const cv::Mat& frame)
+{
+  Profiler::Scope scope(profiler_, Profiler::Stage::SCENE_CUT_HISTOGRAMS);
+
+  bool first = histograms_.empty();
+  histograms_.resize(tiles_.size());
+
+  bool changed = false;
+  last_distance_ = 0;
+  for (size_t i = 0; i < tiles_.size(); ++i) {
+    calculate_histogram(cv::Mat(frame, tiles_[i]), t_histogram_);
+
+    if (!first) {
+      // Total variation distance: half the sum of the differences of
+      // each channel, which sums to 1
+      double difference = 0;
+      for (size_t bin = 0; bin < t_histogram_.size(); ++bin) {
+        difference += std::abs(t_histogram_[bin] - histograms_[i][bin]);
+      }
+      double distance = difference / (2 * 3);
+
+      last_distance_ = std::max(last_distance_, distance);
+      changed = changed || distance > threshold_;
+    }
+
+    histograms_[i].swap(t_histogram_);
+  }
+
+  return changed;
+}
+
+
+double SceneCutDetector::last_distance() const
+{
+  return last_distance_;
+}
+
+
+void SceneCutDetector::calculate_histogram(const cv::Mat& tile, std::vector<float>& histogram)
+{
+  cv::Size small_size(std::max(1, tile.cols / SCALE_), std::max(1, tile.rows / SCALE_));
+  cv::resize(tile, t_small_, small_size, 0, 0, cv::INTER_AREA);
+
+  histogram.assign(BINS_ * 3, 0);
+  float weight = 1.f / (t_small_.rows * t_small_.cols);
+  for (int row = 0; row < t_small_.rows; ++row) {
+    const uint8_t* pixel = t_small_.ptr<uint8_t>(row);
+    for (int x = 0; x < t_small_.cols; ++x, pixel += 3) {
+      for (int channel = 0; channel < 3; ++channel) {
+        histogram[channel * BINS_ + pixel[channel] * BINS_ / 256] += weight;
+      }
+    }
+  }
+}
+
+
+void SceneCutDetector::start(const std::string& file, int start_frame, int end_frame, int frame_step, bool seek)
+{
+  stop();
+
+  cuts_.clear();
+  histograms_.clear();
+  scanned_until_ = start_frame;
+  finished_ = false;
+  stop_requested_ = false;
+
+  cap_.open(file);
+  if (!cap_.isOpened()) {
+    // Without cuts the intervals are simply not shortened
+    finished_ = true;
+    return;
+  }
+
+  thread_ = std::thread(&SceneCutDetector::scan, this, start_frame, end_frame, frame_step, seek);
+}
+
+
+int SceneCutDetector::find_cut(int first_frame, int end_frame)
+{
+  std::unique_lock<std::mutex> lock(mutex_);
+  if (scanned_until_ < end_frame && !finished_) {
+    Profiler::Scope scope(profiler_, Profiler::Stage::WAIT_FOR_SCENE_CUTS);
+    progress_.wait(lock, [&]() { return scanned_until_ >= end_frame || finished_ || stop_requested_; });
+  }
+
+  auto cut = std::lower_bound(cuts_.begin(), cuts_.end(), first_frame);
+  if (cut == cuts_.end() || *cut >= end_frame) {
+    return -1;
+  }
+  return *cut;
+}
+
+
+void SceneCutDetector::stop()
+{
+  request_stop();
+
+  if (thread_.joinable()) {
+    thread_.join();
+  }
+  cap_.release();
+}
+
+
+void SceneCutDetector::count_decoded_frame()
+{
+  if (profiler_) {
+    profiler_->count(Profiler::Counter::FRAMES_DECODED_BY_SCENE_CUT_SCAN);
+  }
+}
+
+
+void SceneCutDetector::request_stop()
+{
+  std::lock_guard<std::mutex> lock(mutex_);
+  stop_requested_ = true;
+  progress_.notify_all();
+}
+
+
+void SceneCutDetector::set_profiler(Profiler* profiler)
+{
+  profiler_ = profiler;
+}
+
+
+void SceneCutDetector::scan(int start_frame, int end_frame, int frame_step, bool seek)
+{
+  cv::Mat frame;
+  int position = -1;
+  int first_sample = IntervalCalculator::get_first_sample(start_frame, frame_step);
+  for (int f = first_sample; f < end_frame; f += frame_step) {
+    if (!read_sample(f, seek, position, frame)) {
+      break;
+    }
+    bool cut = add(frame);
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (cut) {
+      cuts_.push_back(f);
+      if (profiler_) {
+        profiler_->count(Profiler::Counter::SCENE_CUTS);
+      }
+    }
+    scanned_until_ = f + 1;
+    progress_.notify_all();
+    if (stop_requested_) {
+      break;
+    }
+  }
+
+  std::lock_guard<std::mutex> lock(mutex_);
+  finished_ = true;
+  progress_.notify_all();
+}
+
+
+bool SceneCutDetector::read_sample(int frame_number, bool seek, int& position, cv::Mat& frame)
+{
+  if (seek || position < 0) {
+    cap_.set(cv::CAP_PROP_POS_FRAMES, frame_number);
+    position = frame_number;
+  }
+  while (position < frame_number) {
+    if (!cap_.grab()) {
+      return false;
+    }
+    ++position;
+    count_decoded_frame();
+  }
+
+  ++position;
+  count_decoded_frame();
+  return cap_.read(frame) && !frame.empty();
+}
@@ -0,0 +1,129 @@
+/*
+ * Copyright (C) 2018-2025 Werner Turing <werner.turing@protonmail.com>
+ *
+ * This file is part of multi-delogo.
+ *
+ * multi-delogo is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * multi-delogo is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with multi-delogo.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#ifndef MDL_OPENCV_SCENE_CUT_DETECTOR_H
+#define MDL_OPENCV_SCENE_CUT_DETECTOR_H
+
+#include <string>
+#include <vector>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+
+#include <opencv2/core.hpp>
+#include <opencv2/videoio.hpp>
+
+
+namespace mdl { namespace opencv {
+  class Profiler;
+
+
+  /**
+   * Finds the sampled frames where the search tiles change abruptly,
+   * which happens at scene cuts and when the logo changes, so that
+   * they can be used as interval boundaries.
+   *
+   * Each tile is scaled down and compared to the same tile of the
+   * previous sampled frame by the distance between their colour
+   * histograms. The video is scanned in a separate thread, with its
+   * own capture, ahead of the search.
+   *
+   * The scan does not share the frames decoded by the search: it
+   * decodes them again at the original size, every frame unless it
+   * seeks to the sampled ones, so it is not cheap. The frames it
+   * decodes are counted by the profiler.
+   */
+  class SceneCutDetector
+  {
+  public:
+    /**
+     * threshold is the distance between the histograms, from 0 to 1,
+     * above which a tile is considered to have changed.
+     */
+    SceneCutDetector(const std::vector<cv::Rect>& tiles, double threshold);
+    ~SceneCutDetector();
+
+    /**
+     * Compares a frame with the previous one added, returning true if
+     * any of the tiles changed.
+     */
+    bool add(const cv::Mat& frame);
+    double last_distance() const;
+
+    /**
+     * Starts scanning the sampled frames of [start_frame, end_frame)
+     * of the video in the background. If seek is true the capture is
+     * seeked to each sampled frame, otherwise all frames are decoded.
+     */
+    void start(const std::string& file, int start_frame, int end_frame, int frame_step, bool seek);
+
+    /**
+     * Returns the first cut in [first_frame, end_frame), or -1 if
+     * there is none, waiting until that part of the video is scanned
+     * or the scan is stopped. A cut is the first sampled frame after
+     * the change.
+     */
+    int find_cut(int first_frame, int end_frame);
+
+    /**
+     * Stops the scan and waits for it to finish.
+     */
+    void stop();
+
+    /**
+     * Asks the scan to stop, without waiting, and wakes up
+     * find_cut(). Can be called by any thread.
+     */
+    void request_stop();
+
+    void set_profiler(Profiler* profiler);
+
+  private:
+    const static int BINS_;
+    const static int SCALE_;
+
+    std::vector<cv::Rect> tiles_;
+    double threshold_;
+    std::vector<std::vector<float>> histograms_;
+    double last_distance_;
+
+    Profiler* profiler_;
+
+    cv::VideoCapture cap_;
+    std::vector<int> cuts_;
+    int scanned_until_;
+    bool finished_;
+    bool stop_requested_;
+
+    std::thread thread_;
+    std::mutex mutex_;
+    std::condition_variable progress_;
+
+    void scan(int start_frame, int end_frame, int frame_step, bool seek);
+    bool read_sample(int frame_number, bool seek, int& position, cv::Mat& frame);
+    void count_decoded_frame();
+    void calculate_histogram(const cv::Mat& tile, std::vector<float>& histogram);
+
+    // Temporary variables
+    cv::Mat t_small_;
+    std::vector<float> t_histogram_;
+  };
+} }
+
+
+#endif // MDL_OPENCV_SCENE_CUT_DETECTOR_H
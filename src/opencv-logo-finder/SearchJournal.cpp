@@ -0,0 +1,94 @@
+/*
+ * Copyright (C) 2018-2025 Werner Turing <werner.turing@protonmail.com>
+ *
+ * This file is part of multi-delogo.
+ *
+ * multi-delogo is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * multi-delogo is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with multi-delogo.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include <iostream>
+#include <sstream>
+#include <string>
+
+#include "SearchJournal.hpp"
+
+using namespace mdl;
+
+
+SearchJournal::SearchJournal(std::ostream& out, LogoFinderCallback& callback)
+  : out_(out)
+  , callback_(callback)
+{
+}
+
+
+void SearchJournal::success(const LogoFinderResult& result)
+{
+  out_ << "success " << result.start_frame << " " << result.end_frame
+       << " " << result.x << " " << result.y
+       << " " << result.width << " " << result.height;
+  for (auto& logo: result.other_logos) {
+    out_ << " " << logo.x << " " << logo.y << " " << logo.width << " " << logo.height;
+  }
+  out_ << std::endl;
+
+  callback_.success(result);
+}
+
+
+void SearchJournal::failure(int start_frame, int end_frame)
+{
+  out_ << "failure " << start_frame << " " << end_frame << std::endl;
+
+  callback_.failure(start_frame, end_frame);
+}
+
+
+SearchResumePoint SearchJournal::replay(std::istream& in, LogoFinderCallback& callback)
+{
+  SearchResumePoint resume_point{-1, 0};
+
+  std::string line;
+  while (std::getline(in, line)) {
+    if (in.eof()) {
+      // Not ended by a new line, so it may be incomplete
+      break;
+    }
+
+    std::istringstream words(line);
+    std::string type;
+    LogoFinderResult result;
+    words >> type >> result.start_frame >> result.end_frame;
+    if (type == "success") {
+      words >> result.x >> result.y >> result.width >> result.height;
+    }
+    if (!words || (type != "success" && type != "failure")) {
+      break;
+    }
+    LogoBox logo;
+    while (words >> logo.x >> logo.y >> logo.width >> logo.height) {
+      result.other_logos.push_back(logo);
+    }
+
+    if (type == "success") {
+      callback.success(result);
+      resume_point.failures = 0;
+    } else {
+      callback.failure(result.start_frame, result.end_frame);
+      ++resume_point.failures;
+    }
+    resume_point.start_frame = result.end_frame + 1;
+  }
+
+  return resume_point;
+}
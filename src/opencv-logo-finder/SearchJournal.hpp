@@ -0,0 +1,71 @@
+/*
+ * Copyright (C) 2018-2025 Werner Turing <werner.turing@protonmail.com>
+ *
+ * This file is part of multi-delogo.
+ *
+ * multi-delogo is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * multi-delogo is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with multi-delogo.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#ifndef MDL_SEARCH_JOURNAL_H
+#define MDL_SEARCH_JOURNAL_H
+
+#include <iostream>
+
+#include "gui/common/LogoFinder.hpp"
+
+
+namespace mdl {
+  /**
+   * Point where a search recorded in a journal can be resumed, in the
+   * numbering of the logo finder (starting at 0), with the number of
+   * failures reported since the last logo found. start_frame is -1 if
+   * nothing was recorded.
+   */
+  struct SearchResumePoint
+  {
+    int start_frame;
+    int failures;
+  };
+
+
+  /**
+   * Callback that writes each result to a journal as soon as it is
+   * reported, before passing it to another callback, so that a search
+   * that is interrupted can be resumed where it stopped.
+   *
+   * Each result is a line, "success <start> <end> <x> <y> <width>
+   * <height>", followed by "<x> <y> <width> <height>" for each other
+   * logo, or "failure <start> <end>", flushed when written.
+   */
+  class SearchJournal : public LogoFinderCallback
+  {
+  public:
+    SearchJournal(std::ostream& out, LogoFinderCallback& callback);
+    void success(const LogoFinderResult& result) override;
+    void failure(int start_frame, int end_frame) override;
+
+    /**
+     * Passes the results of a journal to callback, in the order they
+     * were written. An incomplete last line, left by a search killed
+     * while writing it, is ignored.
+     */
+    static SearchResumePoint replay(std::istream& in, LogoFinderCallback& callback);
+
+  private:
+    std::ostream& out_;
+    LogoFinderCallback& callback_;
+  };
+}
+
+
+#endif // MDL_SEARCH_JOURNAL_H
@@ -0,0 +1,185 @@
+/*
+ * Copyright (C) 2018-2025 Werner Turing <werner.turing@protonmail.com>
+ *
+ * This file is part of multi-delogo.
+ *
+ * multi-delogo is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * multi-delogo is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with multi-delogo.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include <cstdlib>
+#include <cstdio>
+#include <algorithm>
+#include <string>
+#include <stdexcept>
+#include <ostream>
+
+#include "filter-generator/FilterData.hpp"
+
+#include "gui/common/LogoFinder.hpp"
+
+#include "SearchOptions.hpp"
+
+using namespace mdl;
+
+
+bool SearchOptions::read(int argc, char* argv[], int& i)
+{
+  std::string arg = argv[i];
+  if (arg == "--scene-cuts") {
+    scene_cuts = true;
+    return true;
+  }
+  if (i + 1 >= argc) {
+    return false;
+  }
+
+  if (arg == "--threads") {
+    threads = std::max(1, atoi(argv[++i]));
+  } else if (arg == "--decode-buffer") {
+    decode_buffer_size = std::max(0, atoi(argv[++i]));
+  } else if (arg == "--sampling") {
+    std::string mode = argv[++i];
+    if (mode == "exhaustive") {
+      sampling_mode = SamplingMode::EXHAUSTIVE;
+    } else if (mode == "seek") {
+      sampling_mode = SamplingMode::SEEK;
+    } else {
+      throw std::invalid_argument(mode);
+    }
+  } else if (arg == "--box-extraction") {
+    std::string mode = argv[++i];
+    if (mode == "fused") {
+      box_extraction = BoxExtraction::FUSED;
+    } else if (mode == "contours") {
+      box_extraction = BoxExtraction::CONTOURS;
+    } else {
+      throw std::invalid_argument(mode);
+    }
+  } else if (arg == "--signal") {
+    std::string signal = argv[++i];
+    if (signal == "gradient") {
+      detection_signal = DetectionSignal::GRADIENT;
+    } else if (signal == "variance") {
+      detection_signal = DetectionSignal::VARIANCE;
+    } else {
+      throw std::invalid_argument(signal);
+    }
+  } else if (arg == "--frame-step") {
+    frame_step = std::max(1, atoi(argv[++i]));
+  } else if (arg == "--analysis-height") {
+    analysis_height = std::max(0, atoi(argv[++i]));
+  } else if (arg == "--corners") {
+    corner_percent = std::max(0, atoi(argv[++i]));
+  } else if (arg == "--region") {
+    fg::SearchRegion region;
+    if (sscanf(argv[++i], "%d,%d,%d,%d", &region.x, &region.y, &region.width, &region.height) != 4) {
+      throw std::invalid_argument(argv[i]);
+    }
+    search_regions.push_back(region);
+  } else if (arg == "--track") {
+    max_tracked_logos = std::max(0, atoi(argv[++i]));
+  } else if (arg == "--max-logos") {
+    max_logos = std::max(1, atoi(argv[++i]));
+  } else if (arg == "--cache") {
+    cache_file = argv[++i];
+  } else if (arg == "--cache-size") {
+    cache_size = std::max(1, atoi(argv[++i]));
+  } else {
+    return false;
+  }
+
+  return true;
+}
+
+
+void SearchOptions::configure(LogoFinder& finder) const
+{
+  finder.set_threads(threads);
+  if (decode_buffer_size >= 0) {
+    finder.set_decode_buffer_size(decode_buffer_size);
+  }
+  finder.set_sampling_mode(sampling_mode);
+  finder.set_box_extraction(box_extraction);
+  finder.set_detection_signal(detection_signal);
+  if (frame_step > 0) {
+    finder.set_frame_step(frame_step);
+  }
+  finder.set_analysis_height(analysis_height);
+  finder.set_scene_cuts(scene_cuts);
+  finder.set_corner_size(corner_percent / 100.0);
+  finder.set_max_tracked_logos(max_tracked_logos);
+  finder.set_max_logos(max_logos);
+  finder.set_cache_file(cache_file);
+  if (cache_size > 0) {
+    finder.set_cache_size(cache_size);
+  }
+}
+
+
+void SearchOptions::write(std::ostream& out) const
+{
+  out << ", " << threads << " thread(s)"
+      << ", " << (decode_buffer_size >= 0 ? std::to_string(decode_buffer_size) + "MB" : "default") << " decode buffer"
+      << ", " << (sampling_mode == SamplingMode::SEEK ? "seek" : "exhaustive") << " sampling"
+      << ", " << (box_extraction == BoxExtraction::FUSED ? "fused" : "contours") << " box extraction"
+      << ", " << (detection_signal == DetectionSignal::VARIANCE ? "variance" : "gradient") << " signal"
+      << ", " << (frame_step > 0 ? std::to_string(frame_step) : "default") << " frame step"
+      << ", " << (analysis_height > 0 ? std::to_string(analysis_height) + "p" : "original size") << " analysis"
+      << ", " << (scene_cuts ? "scene cuts" : "fixed intervals")
+      << ", " << (corner_percent > 0 ? std::to_string(corner_percent) + "% corners" : "no corners")
+      << ", " << search_regions.size() << " search region(s)"
+      << ", " << max_tracked_logos << " tracked logo(s)"
+      << ", up to " << max_logos << " logo(s) at a time"
+      << ", " << (cache_file.empty() ? "no cache" : "cache " + cache_file)
+      << (cache_file.empty() || cache_size == 0 ? "" : " of " + std::to_string(cache_size) + "MB");
+}
+
+
+void SearchOptions::write_usage(std::ostream& out)
+{
+  out << "  --threads <n>              Number of threads used to analyse the video" << std::endl
+      << "  --decode-buffer <MB>       Memory used for frames decoded ahead of their" << std::endl
+      << "                             analysis (0 to decode and analyse in turns)" << std::endl
+      << "  --sampling <mode>          How sampled frames are read: \"exhaustive\" decodes" << std::endl
+      << "                             every frame, \"seek\" seeks to each sampled frame" << std::endl
+      << "  --box-extraction <mode>    How boxes are found in the averages: \"contours\"" << std::endl
+      << "                             (default) or \"fused\", faster but it may pick" << std::endl
+      << "                             another box when several fit the logo sizes" << std::endl
+      << "  --signal <signal>          What identifies the logos: \"gradient\" (default)," << std::endl
+      << "                             the edges of the average of the frames, or" << std::endl
+      << "                             \"variance\", edges next to pixels that barely" << std::endl
+      << "                             change, which works with a bigger frame step" << std::endl
+      << "  --frame-step <n>           Use one of every n frames for the averages" << std::endl
+      << "  --analysis-height <n>      Search frames reduced to this height, which is" << std::endl
+      << "                             faster for big videos, refining the logos found" << std::endl
+      << "                             at the original size" << std::endl
+      << "  --scene-cuts               End the intervals at scene cuts and logo changes," << std::endl
+      << "                             found by scanning the video ahead of the search." << std::endl
+      << "                             The scan decodes the video a second time (every" << std::endl
+      << "                             frame, or the sampled ones with --sampling seek)" << std::endl
+      << "  --corners <percent>        Search logos only in the corners of the frame," << std::endl
+      << "                             each one with this percentage of the frame size" << std::endl
+      << "  --region <x,y,w,h>         Search logos in this region of the frame (can be" << std::endl
+      << "                             repeated, and is saved in the output)" << std::endl
+      << "  --track <n>                Look first for the last n logos found, at the" << std::endl
+      << "                             same position, before searching the whole area" << std::endl
+      << "  --max-logos <n>            Find up to n logos shown at the same time, all" << std::endl
+      << "                             removed by the same filter (default 1)" << std::endl
+      << "  --cache <file>             Keep the sums of the frames in this file, so that" << std::endl
+      << "                             searching the same frames again is faster (with" << std::endl
+      << "                             --batch, in this directory, one file per video)." << std::endl
+      << "                             The sums go to other files next to it, named" << std::endl
+      << "                             after it with a number added" << std::endl
+      << "  --cache-size <MB>          Maximum size of the sums kept in the cache, the" << std::endl
+      << "                             least recently used being deleted (default 2048)" << std::endl;
+}
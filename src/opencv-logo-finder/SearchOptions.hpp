@@ -0,0 +1,82 @@
+/*
+ * Copyright (C) 2018-2025 Werner Turing <werner.turing@protonmail.com>
+ *
+ * This file is part of multi-delogo.
+ *
+ * multi-delogo is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * multi-delogo is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with multi-delogo.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#ifndef MDL_SEARCH_OPTIONS_H
+#define MDL_SEARCH_OPTIONS_H
+
+#include <string>
+#include <vector>
+#include <ostream>
+
+#include "filter-generator/FilterData.hpp"
+
+#include "gui/common/LogoFinder.hpp"
+
+
+namespace mdl {
+  /**
+   * Options of the search given in the command line of logo-finder.
+   * mdl-merge takes them too, so that the seams between the shards
+   * are searched as the shards were.
+   */
+  class SearchOptions
+  {
+  public:
+    int threads = 1;
+    int decode_buffer_size = -1;
+    SamplingMode sampling_mode = SamplingMode::EXHAUSTIVE;
+    BoxExtraction box_extraction = BoxExtraction::CONTOURS;
+    DetectionSignal detection_signal = DetectionSignal::GRADIENT;
+    int frame_step = 0;
+    int analysis_height = 0;
+    bool scene_cuts = false;
+    int corner_percent = 0;
+    std::vector<fg::SearchRegion> search_regions;
+    int max_tracked_logos = 0;
+    int max_logos = 1;
+    std::string cache_file;
+    int cache_size = 0;
+
+    /**
+     * Reads the option in argv[i], with its value, leaving i at the
+     * last argument read. Returns false if argv[i] is not a search
+     * option. Throws std::invalid_argument if its value is invalid.
+     */
+    bool read(int argc, char* argv[], int& i);
+
+    /**
+     * Sets the options in the finder, except for the search regions,
+     * which are kept in the project the finder is created for.
+     */
+    void configure(LogoFinder& finder) const;
+
+    /**
+     * Writes the options for the log, as comma separated items each
+     * one preceded by a comma.
+     */
+    void write(std::ostream& out) const;
+
+    /**
+     * Writes the help of the options.
+     */
+    static void write_usage(std::ostream& out);
+  };
+}
+
+
+#endif // MDL_SEARCH_OPTIONS_H
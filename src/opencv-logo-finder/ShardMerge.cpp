@@ -0,0 +1,136 @@
+/*
+ * Copyright (C) 2018-2025 Werner Turing <werner.turing@protonmail.com>
+ *
+ * This file is part of multi-delogo.
+ *
+ * multi-delogo is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * multi-delogo is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with multi-delogo.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include <vector>
+#include <limits>
+#include <algorithm>
+
+#include "filter-generator/FilterList.hpp"
+#include "filter-generator/Filters.hpp"
+#include "filter-generator/FilterFactory.hpp"
+
+#include "ShardMerge.hpp"
+
+using namespace mdl;
+
+
+std::vector<LogoSearchRange> ShardMerge::merge(const std::vector<const fg::FilterList*>& shards,
+                                               int margin, int total_frames, fg::FilterList& merged)
+{
+  std::vector<const fg::FilterList*> ordered;
+  for (auto shard: shards) {
+    if (!shard->empty()) {
+      ordered.push_back(shard);
+    }
+  }
+  std::sort(ordered.begin(), ordered.end(), [](auto s1, auto s2) {
+      return s1->begin()->first < s2->begin()->first;
+    });
+
+  std::vector<int> seams;
+  for (size_t i = 0; i < ordered.size(); ++i) {
+    int end_frame = i + 1 < ordered.size()
+      ? ordered[i + 1]->begin()->first
+      : std::numeric_limits<int>::max();
+    for (auto& filter: *ordered[i]) {
+      if (filter.first < end_frame) {
+        merged.insert(filter.first, filter.second);
+      }
+    }
+
+    if (i > 0) {
+      seams.push_back(ordered[i]->begin()->first);
+    }
+  }
+
+  std::vector<LogoSearchRange> ranges;
+  int last_range_end = 1;
+  for (int seam: seams) {
+    auto before = merged.get_filter_for_frame(seam - 1);
+    auto after = merged.get_by_start_frame(seam);
+    if (!before || !after) {
+      continue;
+    }
+
+    if (before->second->type() == fg::FilterType::DELOGO
+        && before->second->save_str() == after->second->save_str()) {
+      merged.remove(seam);
+      continue;
+    }
+
+    LogoSearchRange range = prepare_recheck(merged, seam, margin, total_frames, last_range_end);
+    last_range_end = range.end_frame + 1;
+    ranges.push_back(range);
+  }
+
+  return ranges;
+}
+
+
+void ShardMerge::join_equal_filters(fg::FilterList& filter_list)
+{
+  std::vector<int> repeated;
+  fg::filter_ptr previous;
+  for (auto& filter: filter_list) {
+    if (previous
+        && filter.second->type() == fg::FilterType::DELOGO
+        && filter.second->save_str() == previous->save_str()) {
+      repeated.push_back(filter.first);
+    } else {
+      previous = filter.second;
+    }
+  }
+
+  for (int frame: repeated) {
+    filter_list.remove(frame);
+  }
+}
+
+
+LogoSearchRange ShardMerge::prepare_recheck(fg::FilterList& merged, int seam, int margin, int total_frames,
+                                            int min_start_frame)
+{
+  auto before = merged.get_filter_for_frame(seam - 1);
+  fg::filter_ptr after = merged.get_by_start_frame(seam)->second;
+
+  int start_frame = std::max(std::max(before->first, seam - margin), min_start_frame);
+
+  int end_frame = seam + margin;
+  auto next = merged.get_by_position(merged.get_position(seam) + 1);
+  if (next && next->first <= end_frame) {
+    end_frame = next->first;
+  } else if (end_frame > total_frames) {
+    end_frame = total_frames + 1;
+  } else {
+    // The filter after the seam goes on after the range
+    merged.insert(end_frame, fg::FilterFactory::load(after->save_str()));
+  }
+
+  std::vector<int> inside;
+  for (auto& filter: merged) {
+    if (filter.first >= start_frame && filter.first < end_frame) {
+      inside.push_back(filter.first);
+    }
+  }
+  for (int frame: inside) {
+    merged.remove(frame);
+  }
+  merged.insert(start_frame, fg::filter_ptr(new fg::ReviewFilter()));
+
+  return LogoSearchRange{start_frame - 1, end_frame - 1};
+}
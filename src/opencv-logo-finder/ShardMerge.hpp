@@ -0,0 +1,67 @@
+/*
+ * Copyright (C) 2018-2025 Werner Turing <werner.turing@protonmail.com>
+ *
+ * This file is part of multi-delogo.
+ *
+ * multi-delogo is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * multi-delogo is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with multi-delogo.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#ifndef MDL_SHARD_MERGE_H
+#define MDL_SHARD_MERGE_H
+
+#include <vector>
+
+#include "filter-generator/FilterList.hpp"
+
+#include "gui/common/LogoFinder.hpp"
+
+
+namespace mdl {
+  /**
+   * Joins the filter lists found by logo-finder for shards of a video.
+   *
+   * The part of the video of each shard starts at its first filter
+   * and ends where the next shard starts. A logo that continues past
+   * the end of a shard is split in two filters at the seam, which are
+   * joined if they are equal. When they are not, the frames around
+   * the seam have to be searched again.
+   */
+  class ShardMerge
+  {
+  public:
+    /**
+     * Adds the filters of the shards to merged, and returns the ranges
+     * around the seams that have to be searched again, in the
+     * numbering of the logo finder (starting at 0). Each range goes
+     * up to margin frames before and after its seam, without going
+     * past the total_frames of the video, and is left with a review
+     * filter, to be replaced by the results of the search.
+     */
+    static std::vector<LogoSearchRange> merge(const std::vector<const fg::FilterList*>& shards,
+                                              int margin, int total_frames, fg::FilterList& merged);
+
+    /**
+     * Removes the delogo filters that are equal to the one before
+     * them, as the ones left around the seams by a search of the
+     * ranges returned by merge().
+     */
+    static void join_equal_filters(fg::FilterList& filter_list);
+
+  private:
+    static LogoSearchRange prepare_recheck(fg::FilterList& merged, int seam, int margin, int total_frames,
+                                           int min_start_frame);
+  };
+}
+
+
+#endif // MDL_SHARD_MERGE_H
@@ -0,0 +1,95 @@
+/*
+ * Copyright (C) 2018-2025 Werner Turing <werner.turing@protonmail.com>
+ *
+ * This file is part of multi-delogo.
+ *
+ * multi-delogo is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * multi-delogo is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with multi-delogo.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include "TransitionSearch.hpp"
+
+using namespace mdl::opencv;
+
+
+TransitionSearch::TransitionSearch(Frames& frames, double threshold)
+  : frames_(frames)
+  , threshold_(threshold)
+{
+}
+
+
+int TransitionSearch::find_linear(int first_frame, int end_frame)
+{
+  for (int frame = first_frame; frame < end_frame; ++frame) {
+    if (changed(frame - 1, frame)) {
+      return frame;
+    }
+  }
+
+  return end_frame;
+}
+
+
+int TransitionSearch::find_bisecting(int first_frame, int end_frame)
+{
+  if (first_frame >= end_frame) {
+    return end_frame;
+  }
+
+  int reference = first_frame - 1;
+
+  // Find a frame with a different logo, doubling the distance from
+  // the reference each time. At the end, the logo of same is the
+  // same as the reference, and the one of different is not
+  int same = reference;
+  int different = end_frame;
+  int distance = 1;
+  while (true) {
+    int frame = reference + distance;
+    if (frame >= end_frame - 1) {
+      frame = end_frame - 1;
+    }
+
+    if (changed(reference, frame)) {
+      different = frame;
+      break;
+    }
+
+    same = frame;
+    if (frame == end_frame - 1) {
+      return end_frame;
+    }
+    distance *= 2;
+  }
+
+  while (different - same > 1) {
+    int middle = same + (different - same) / 2;
+    if (changed(reference, middle)) {
+      different = middle;
+    } else {
+      same = middle;
+    }
+  }
+
+  if (different == first_frame || changed(different - 1, different)) {
+    return different;
+  }
+
+  return find_linear(first_frame, end_frame);
+}
+
+
+bool TransitionSearch::changed(int frame1, int frame2)
+{
+  return frames_.difference(frame1, frame2) > threshold_;
+}
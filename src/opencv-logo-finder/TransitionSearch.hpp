@@ -0,0 +1,69 @@
+/*
+ * Copyright (C) 2018-2025 Werner Turing <werner.turing@protonmail.com>
+ *
+ * This file is part of multi-delogo.
+ *
+ * multi-delogo is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * multi-delogo is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with multi-delogo.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#ifndef MDL_OPENCV_TRANSITION_SEARCH_H
+#define MDL_OPENCV_TRANSITION_SEARCH_H
+
+
+namespace mdl { namespace opencv {
+  /**
+   * Searches the frame where a logo changes.
+   *
+   * The transition is the first frame whose logo differs from the
+   * logo of the frame before it. The linear search compares each
+   * frame with the one before it. The bisecting search compares
+   * frames with the one before the first frame (the reference),
+   * doubling the distance to it until a different logo is found,
+   * and then bisecting. That assumes the logo does not come back
+   * once it changes; when the frame found is not a transition for the
+   * linear search (the logo changed slowly, for instance) the linear
+   * search is done instead.
+   */
+  class TransitionSearch
+  {
+  public:
+    class Frames
+    {
+    public:
+      virtual ~Frames() { };
+
+      /**
+       * Returns how much the logos of the two frames differ.
+       */
+      virtual double difference(int frame1, int frame2) = 0;
+    };
+
+    TransitionSearch(Frames& frames, double threshold);
+
+    /**
+     * Both searches look for the transition in [first_frame,
+     * end_frame), returning end_frame when it is not found.
+     */
+    int find_linear(int first_frame, int end_frame);
+    int find_bisecting(int first_frame, int end_frame);
+
+  private:
+    Frames& frames_;
+    double threshold_;
+
+    bool changed(int frame1, int frame2);
+  };
+} }
+
+
+#endif // MDL_OPENCV_TRANSITION_SEARCH_H
@@ -0,0 +1,212 @@
+/*
+ * Copyright (C) 2018-2025 Werner Turing <werner.turing@protonmail.com>
+ *
+ * This file is part of multi-delogo.
+ *
+ * multi-delogo is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * multi-delogo is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with multi-delogo.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include <cstdlib>
+#include <algorithm>
+#include <chrono>
+#include <functional>
+#include <memory>
+#include <string>
+#include <vector>
+#include <iostream>
+
+#include "filter-generator/FilterData.hpp"
+
+#include "FilterListAdapter.hpp"
+#include "FilterListComparison.hpp"
+
+using namespace mdl;
+
+
+// Compares the sampling modes, box extraction methods and tracking of
+// logos of the logo finder, running the search on the same part of a
+// video with each one. The first run, with the previous methods, is the
+// reference
+
+
+class StopAtEndCallback : public LogoFinderCallback
+{
+public:
+  StopAtEndCallback(int frame_interval, int end_frame);
+  void success(const LogoFinderResult& result) override;
+  void failure(int start_frame, int end_frame) override;
+  void set_finder(LogoFinder* finder);
+
+private:
+  int frame_interval_;
+  int end_frame_;
+  LogoFinder* finder_;
+
+  void stop_at_end(int start_frame);
+};
+
+
+struct BenchmarkResult
+{
+  std::string name;
+  double seconds;
+  std::unique_ptr<fg::FilterData> filter_data;
+};
+
+
+void print_usage()
+{
+  std::cout << "Usage: logo-finder-benchmark [options] <video> <start_frame> <end_frame> <frame_interval>" << std::endl
+            << std::endl
+            << "Options:" << std::endl
+            << "  --threads <n>  Number of threads used to analyse the video" << std::endl;
+}
+
+
+BenchmarkResult run(const std::string& name, const std::function<void(LogoFinder&)>& configure,
+                    const std::string& video, int start_frame, int end_frame, int frame_interval,
+                    int threads)
+{
+  BenchmarkResult result{name, 0, std::unique_ptr<fg::FilterData>(new fg::FilterData())};
+  result.filter_data->set_movie_file(video);
+
+  StopAtEndCallback callback(frame_interval, end_frame);
+  std::shared_ptr<LogoFinder> finder = create_logo_finder(*result.filter_data, callback, false);
+  finder->set_start_frame(start_frame);
+  finder->set_frame_interval_min(frame_interval);
+  finder->set_extra_frames(0);
+  finder->set_threads(threads);
+  configure(*finder);
+  callback.set_finder(finder.get());
+
+  auto start = std::chrono::steady_clock::now();
+  auto res = finder->find_logos();
+  std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+  result.seconds = elapsed.count();
+
+  if (!res.first) {
+    std::cout << name << ": " << res.second << std::endl;
+  }
+  return result;
+}
+
+
+int main(int argc, char* argv[])
+{
+  std::vector<std::string> args;
+  int threads = 1;
+  for (int i = 1; i < argc; ++i) {
+    std::string arg = argv[i];
+    if (arg == "--threads" && i + 1 < argc) {
+      threads = std::max(1, atoi(argv[++i]));
+    } else {
+      args.push_back(arg);
+    }
+  }
+
+  if (args.size() != 4) {
+    print_usage();
+    return 1;
+  }
+
+  int start_frame = std::stoi(args[1]) - 1;
+  int end_frame = std::stoi(args[2]);
+  int frame_interval = std::stoi(args[3]);
+
+  std::vector<BenchmarkResult> results;
+  results.push_back(run("exhaustive, contours",
+                        [](LogoFinder& finder) {
+                          finder.set_sampling_mode(SamplingMode::EXHAUSTIVE);
+                          finder.set_box_extraction(BoxExtraction::CONTOURS);
+                        },
+                        args[0], start_frame, end_frame, frame_interval, threads));
+  results.push_back(run("seek, contours",
+                        [](LogoFinder& finder) {
+                          finder.set_sampling_mode(SamplingMode::SEEK);
+                          finder.set_box_extraction(BoxExtraction::CONTOURS);
+                        },
+                        args[0], start_frame, end_frame, frame_interval, threads));
+  results.push_back(run("exhaustive, fused",
+                        [](LogoFinder& finder) {
+                          finder.set_sampling_mode(SamplingMode::EXHAUSTIVE);
+                          finder.set_box_extraction(BoxExtraction::FUSED);
+                        },
+                        args[0], start_frame, end_frame, frame_interval, threads));
+  results.push_back(run("exhaustive, fused, tracking",
+                        [](LogoFinder& finder) {
+                          finder.set_sampling_mode(SamplingMode::EXHAUSTIVE);
+                          finder.set_box_extraction(BoxExtraction::FUSED);
+                          finder.set_max_tracked_logos(4);
+                        },
+                        args[0], start_frame, end_frame, frame_interval, threads));
+  results.push_back(run("exhaustive, fused, variance, frame step 20",
+                        [](LogoFinder& finder) {
+                          finder.set_sampling_mode(SamplingMode::EXHAUSTIVE);
+                          finder.set_box_extraction(BoxExtraction::FUSED);
+                          finder.set_detection_signal(DetectionSignal::VARIANCE);
+                          finder.set_frame_step(20);
+                        },
+                        args[0], start_frame, end_frame, frame_interval, threads));
+  results.push_back(run("exhaustive, fused, analysis at 360p",
+                        [](LogoFinder& finder) {
+                          finder.set_sampling_mode(SamplingMode::EXHAUSTIVE);
+                          finder.set_box_extraction(BoxExtraction::FUSED);
+                          finder.set_analysis_height(360);
+                        },
+                        args[0], start_frame, end_frame, frame_interval, threads));
+
+  fg::FilterList& reference = results[0].filter_data->filter_list();
+  for (auto& result: results) {
+    fg::FilterList& filter_list = result.filter_data->filter_list();
+    std::cout << result.name << ": "
+              << result.seconds << "s"
+              << ", speedup " << results[0].seconds / result.seconds << "x"
+              << ", " << filter_list.size() << " filters"
+              << ", " << FilterListComparison::compare(reference, filter_list).equal
+              << " of " << reference.size() << " equal to " << results[0].name
+              << std::endl;
+  }
+}
+
+
+StopAtEndCallback::StopAtEndCallback(int frame_interval, int end_frame)
+  : frame_interval_(frame_interval)
+  , end_frame_(end_frame)
+{
+}
+
+
+void StopAtEndCallback::success(const LogoFinderResult& result)
+{
+  stop_at_end(result.start_frame);
+}
+
+
+void StopAtEndCallback::failure(int start_frame, int end_frame)
+{
+  stop_at_end(start_frame);
+}
+
+
+void StopAtEndCallback::set_finder(LogoFinder* finder)
+{
+  finder_ = finder;
+}
+
+
+void StopAtEndCallback::stop_at_end(int start_frame)
+{
+  if ((start_frame + frame_interval_) > end_frame_) {
+    finder_->stop();
+  }
+}
@@ -17,14 +17,30 @@
  * along with multi-delogo.  If not, see <http://www.gnu.org/licenses/>.
  */
 #include <cstdlib>
+#include <cstdio>
 #include <limits>
+#include <algorithm>
+#include <chrono>
+#include <functional>
 #include <memory>
+#include <string>
+#include <stdexcept>
+#include <sstream>
+#include <vector>
 #include <iostream>
+#include <iomanip>
 #include <fstream>
+#include <thread>
+#include <mutex>
 
 #include "filter-generator/FilterData.hpp"
 
 #include "FilterListAdapter.hpp"
+#include "FilterListComparison.hpp"
+#include "SearchJournal.hpp"
+#include "SearchOptions.hpp"
+#include "OpenCVLogoFinder.hpp"
+#include "Profiler.hpp"
 
 using namespace mdl;
 
@@ -45,55 +61,855 @@ private:
 };
 
 
+// Receives the results replayed from a journal, which are only added
+// to the filters
+class NullCallback : public LogoFinderCallback
+{
+public:
+  void success(const LogoFinderResult&) override { };
+  void failure(int, int) override { };
+};
+
+
+// Parameters of the search changed by a sweep, as name=value pairs
+struct ParameterSet
+{
+  std::string line;
+  std::vector<std::pair<std::string, std::string>> values;
+};
+
+
+struct SweepResult
+{
+  double seconds;
+  std::unique_ptr<fg::FilterData> filter_data;
+};
+
+
+// Video of a batch, with the arguments and parameters of its search
+struct BatchItem
+{
+  std::string video;
+  std::string output;
+  int start_frame;
+  int frame_interval_min;
+  int frame_interval_max;
+  int end_frame;
+  std::vector<std::pair<std::string, std::string>> values;
+};
+
+
+// Prints the results of the videos of a batch searched at the same
+// time, each line with the name of the video and its progress
+class BatchCallback : public LogoFinderCallback
+{
+public:
+  BatchCallback(const BatchItem& item, std::mutex& output_mutex);
+  void success(const LogoFinderResult& result) override;
+  void failure(int start_frame, int end_frame) override;
+  void set_finder(LogoFinder* finder);
+
+private:
+  const BatchItem& item_;
+  std::mutex& output_mutex_;
+  LogoFinder* finder_;
+
+  void print_progress(const char* result, int start_frame, int end_frame);
+};
+
+
+typedef std::function<void(LogoFinder&)> Configure;
+
+
+void print_usage()
+{
+  std::cout << "Usage: logo-finder [options] <video> <output> <start_frame> <frame_interval_min> <frame_interval_max> [<end_frame>]" << std::endl
+            << "       logo-finder [options] --batch <file>" << std::endl
+            << std::endl
+            << "Options:" << std::endl;
+  SearchOptions::write_usage(std::cout);
+  std::cout << "  --review <file>            Search again only the frames marked for review" << std::endl
+            << "                             in this project, saving it with the results in" << std::endl
+            << "                             <output> (<start_frame> is ignored)" << std::endl
+            << "  --shard <i>/<n>            Search only the i-th of n parts of the frames," << std::endl
+            << "                             from 1 to n, to be joined with mdl-merge (give" << std::endl
+            << "                             it <frame_interval_max> with --max-interval)" << std::endl
+            << "  --resume                   Continue a search that was interrupted, from the" << std::endl
+            << "                             results saved in <output>.journal, which is" << std::endl
+            << "                             written during the search and removed when it" << std::endl
+            << "                             finishes (an interrupted --review is just run" << std::endl
+            << "                             again)" << std::endl
+            << "  --overwrite                Start again a search that was interrupted," << std::endl
+            << "                             replacing <output>.journal" << std::endl
+            << "  --profile                  Print the time spent in each stage of the search" << std::endl
+            << "  --trace <file>             Save the stages of the search as a Chrome trace" << std::endl
+            << "                             (JSON), to be opened in chrome://tracing" << std::endl
+            << "  --sweep <file>             Search once for each parameter set in the file," << std::endl
+            << "                             one per line as name=value pairs (for instance" << std::endl
+            << "                             \"min-width=40 gradient-threshold=170\"), saving" << std::endl
+            << "                             each result in <output> with the set number." << std::endl
+            << "                             Parameters: min-width, max-width, min-height," << std::endl
+            << "                             max-height, max-logos, gradient-threshold," << std::endl
+            << "                             close-steps, max-deviation, similarity-threshold" << std::endl
+            << "                             and scene-cut-threshold. The sums of the frames" << std::endl
+            << "                             are shared through the cache, so an interval is" << std::endl
+            << "                             decoded again only when a set starts or ends it" << std::endl
+            << "                             at another frame, but the frames compared to" << std::endl
+            << "                             find where each logo starts and ends are decoded" << std::endl
+            << "                             for every set" << std::endl
+            << "  --reference <file>         Compare the results of the sweep with the filters" << std::endl
+            << "                             of this project" << std::endl
+            << "  --batch <file>             Search the videos listed in the file, one per line" << std::endl
+            << "                             with the arguments <video> <output> <start_frame>" << std::endl
+            << "                             <frame_interval_min> <frame_interval_max>" << std::endl
+            << "                             [<end_frame>], followed by optional parameters" << std::endl
+            << "                             as in --sweep, which can also be frame-step and" << std::endl
+            << "                             analysis-height. Names with spaces are quoted." << std::endl
+            << "                             Videos whose output exists are skipped, so an" << std::endl
+            << "                             interrupted batch can be run again" << std::endl
+            << "  --jobs <n>                 Number of videos of a batch searched at the same" << std::endl
+            << "                             time (default 1). Each search gets an equal part" << std::endl
+            << "                             of the threads when it starts, and keeps them" << std::endl
+            << "                             until it finishes" << std::endl;
+}
+
+
+bool set_parameter(LogoFinder& finder, const std::string& name, const std::string& value)
+{
+  try {
+    if (name == "min-width") {
+      finder.set_min_logo_width(std::stoi(value));
+    } else if (name == "max-width") {
+      finder.set_max_logo_width(std::stoi(value));
+    } else if (name == "min-height") {
+      finder.set_min_logo_height(std::stoi(value));
+    } else if (name == "max-height") {
+      finder.set_max_logo_height(std::stoi(value));
+    } else if (name == "frame-step") {
+      finder.set_frame_step(std::stoi(value));
+    } else if (name == "analysis-height") {
+      finder.set_analysis_height(std::stoi(value));
+    } else if (name == "max-logos") {
+      finder.set_max_logos(std::stoi(value));
+    } else if (name == "gradient-threshold") {
+      finder.set_gradient_threshold(std::stoi(value));
+    } else if (name == "close-steps") {
+      finder.set_close_steps(std::stoi(value));
+    } else if (name == "similarity-threshold") {
+      finder.set_similarity_threshold(std::stod(value));
+    } else if (name == "max-deviation") {
+      finder.set_max_deviation(std::stoi(value));
+    } else if (name == "scene-cut-threshold") {
+      finder.set_scene_cut_threshold(std::stod(value));
+    } else {
+      return false;
+    }
+  } catch (const std::logic_error&) {
+    return false;
+  }
+
+  return true;
+}
+
+
+// Only used to check the parameters of a sweep before it starts
+class ParameterChecker : public LogoFinder
+{
+public:
+  ParameterChecker(LogoFinderCallback& callback)
+    : LogoFinder(callback, false) { };
+
+  int get_total_frames() const override {
+    return 0;
+  }
+
+  find_result find_logos() override {
+    return std::make_pair(true, "");
+  }
+
+  void stop() override { };
+};
+
+
+// Parameters that change how the frames are summed, and so can't share
+// the sums with the other sets of a sweep. The others can move where
+// the intervals start and end, like the logo sizes, which only makes
+// the cache miss for the intervals that moved
+bool changes_sums(const std::string& name)
+{
+  return name == "frame-step" || name == "analysis-height";
+}
+
+
+bool read_parameter_sets(const std::string& file, std::vector<ParameterSet>& sets)
+{
+  MatcherCallback callback(1);
+  ParameterChecker checker(callback);
+
+  std::ifstream in(file);
+  if (!in) {
+    std::cout << "Could not open " << file << std::endl;
+    return false;
+  }
+
+  std::string line;
+  while (std::getline(in, line)) {
+    ParameterSet set{line, {}};
+    std::istringstream words(line);
+    std::string word;
+    while (words >> word) {
+      if (word[0] == '#') {
+        break;
+      }
+
+      size_t equal = word.find('=');
+      std::string name = word.substr(0, equal);
+      std::string value = equal == std::string::npos ? "" : word.substr(equal + 1);
+
+      if (!set_parameter(checker, name, value)) {
+        std::cout << "Invalid parameter " << word << " in " << file << std::endl;
+        return false;
+      }
+      if (changes_sums(name)) {
+        std::cout << name << " can't be swept, it changes the frames averaged;"
+                  << " give it as an option and run a sweep for each value" << std::endl;
+        return false;
+      }
+
+      set.values.push_back(std::make_pair(name, value));
+    }
+
+    if (!set.values.empty()) {
+      sets.push_back(set);
+    }
+  }
+
+  return true;
+}
+
+
+bool read_batch_items(const std::string& file, std::vector<BatchItem>& items)
+{
+  MatcherCallback callback(1);
+  ParameterChecker checker(callback);
+
+  std::ifstream in(file);
+  if (!in) {
+    std::cout << "Could not open " << file << std::endl;
+    return false;
+  }
+
+  std::string line;
+  while (std::getline(in, line)) {
+    std::istringstream words(line);
+    std::vector<std::string> arguments;
+    BatchItem item;
+    std::string word;
+    while (words >> std::quoted(word)) {
+      if (word[0] == '#') {
+        break;
+      }
+
+      size_t equal = word.find('=');
+      if (equal == std::string::npos) {
+        arguments.push_back(word);
+        continue;
+      }
+
+      std::string name = word.substr(0, equal);
+      std::string value = word.substr(equal + 1);
+      if (!set_parameter(checker, name, value)) {
+        std::cout << "Invalid parameter " << word << " in " << file << std::endl;
+        return false;
+      }
+      item.values.push_back(std::make_pair(name, value));
+    }
+
+    if (arguments.empty()) {
+      continue;
+    }
+    try {
+      if (arguments.size() < 5 || arguments.size() > 6) {
+        throw std::invalid_argument(line);
+      }
+      item.video = arguments[0];
+      item.output = arguments[1];
+      item.start_frame = std::stoi(arguments[2]) - 1;
+      item.frame_interval_min = std::stoi(arguments[3]);
+      item.frame_interval_max = std::stoi(arguments[4]);
+      item.end_frame = arguments.size() == 6 ? std::stoi(arguments[5]) : std::numeric_limits<int>::max();
+    } catch (const std::logic_error&) {
+      std::cout << "Invalid line in " << file << ": " << line << std::endl;
+      return false;
+    }
+    items.push_back(item);
+  }
+
+  return true;
+}
+
+
+std::unique_ptr<fg::FilterData> new_filter_data(const std::string& video, int frame_interval_min,
+                                                const std::vector<fg::SearchRegion>& search_regions);
+std::unique_ptr<fg::FilterData> load_project(const std::string& file);
+int batch(const std::vector<BatchItem>& items, int jobs, int threads,
+          const std::vector<fg::SearchRegion>& search_regions,
+          const std::string& cache_dir, const Configure& configure);
+LogoSearchRange get_shard_range(int shard, int n_shards, int start_frame, int end_frame, int frame_interval);
+LogoFinder::find_result find_logos(fg::FilterData& filter_data, int frame_interval_min, int end_frame,
+                                   bool verbose, const Configure& configure, std::ostream* journal = nullptr);
+int sweep(const std::string& sweep_file, const std::string& reference_file,
+          const std::string& video, const std::string& output,
+          const std::vector<fg::SearchRegion>& search_regions,
+          int frame_interval_min, int end_frame,
+          std::string cache_file, const Configure& configure);
+std::string temporary_file(const std::string& prefix, const std::string& suffix);
+std::string sweep_output_file(const std::string& output, int set);
+void print_sweep_summary(const std::vector<ParameterSet>& sets, const std::vector<SweepResult>& results,
+                         fg::FilterData* reference);
+
+
 int main(int argc, char* argv[])
 {
-  if (argc < 5) {
-    std::cout << "Usage: logo-finder <video> <output> <start_frame> <frame_interval_min> <frame_interval_max> [<end_frame>]" << std::endl;
+  std::vector<std::string> args;
+  SearchOptions options;
+  bool profile = false;
+  std::string trace_file;
+  std::string sweep_file;
+  std::string reference_file;
+  std::string review_file;
+  int shard = 0;
+  int n_shards = 0;
+  std::string batch_file;
+  int jobs = 1;
+  bool resume = false;
+  bool overwrite = false;
+  for (int i = 1; i < argc; ++i) {
+    std::string arg = argv[i];
+    bool search_option;
+    try {
+      search_option = options.read(argc, argv, i);
+    } catch (const std::invalid_argument&) {
+      print_usage();
+      return 1;
+    }
+    if (search_option) {
+      continue;
+    }
+
+    if (arg == "--resume") {
+      resume = true;
+    } else if (arg == "--overwrite") {
+      overwrite = true;
+    } else if (arg == "--profile") {
+      profile = true;
+    } else if (arg == "--trace" && i + 1 < argc) {
+      trace_file = argv[++i];
+    } else if (arg == "--sweep" && i + 1 < argc) {
+      sweep_file = argv[++i];
+    } else if (arg == "--reference" && i + 1 < argc) {
+      reference_file = argv[++i];
+    } else if (arg == "--review" && i + 1 < argc) {
+      review_file = argv[++i];
+    } else if (arg == "--batch" && i + 1 < argc) {
+      batch_file = argv[++i];
+    } else if (arg == "--jobs" && i + 1 < argc) {
+      jobs = std::max(1, atoi(argv[++i]));
+    } else if (arg == "--shard" && i + 1 < argc) {
+      if (sscanf(argv[++i], "%d/%d", &shard, &n_shards) != 2 || n_shards < 1 || shard < 1 || shard > n_shards) {
+        print_usage();
+        return 1;
+      }
+    } else {
+      args.push_back(arg);
+    }
+  }
+
+  bool batch_mode = !batch_file.empty();
+  if (batch_mode ? !args.empty() : args.size() < 5) {
+    print_usage();
+    return 1;
+  }
+  if (batch_mode && (!review_file.empty() || !sweep_file.empty() || n_shards > 0)) {
+    std::cout << "--batch can't be used with --review, --sweep or --shard" << std::endl;
+    return 1;
+  }
+  if (resume && (batch_mode || !review_file.empty() || !sweep_file.empty())) {
+    std::cout << "--resume can't be used with --batch, --review or --sweep" << std::endl;
+    return 1;
+  }
+  if (resume && overwrite) {
+    std::cout << "--resume and --overwrite can't be used together" << std::endl;
+    return 1;
+  }
+  if (!batch_mode && sweep_file.empty() && review_file.empty() && !resume && !overwrite
+      && std::ifstream(args[1] + ".journal").is_open()) {
+    std::cout << args[1] << ".journal is left from a search that was interrupted. "
+              << "Give --resume to continue it, or --overwrite to start again" << std::endl;
+    return 1;
+  }
+  if (!review_file.empty() && !sweep_file.empty()) {
+    std::cout << "--review and --sweep can't be used together" << std::endl;
+    return 1;
+  }
+  if (!review_file.empty() && n_shards > 0) {
+    std::cout << "--review and --shard can't be used together" << std::endl;
     return 1;
   }
 
-  int start_frame = atoi(argv[3]) - 1;
-  int frame_interval_min = atoi(argv[4]);
-  int frame_interval_max = atoi(argv[5]);
+  // Given for each video in a batch
+  int start_frame = 0;
+  int frame_interval_min = 0;
+  int frame_interval_max = 0;
+  int end_frame = std::numeric_limits<int>::max();
+  if (!batch_mode) {
+    try {
+      start_frame = std::stoi(args[2]) - 1;
+      frame_interval_min = std::stoi(args[3]);
+      frame_interval_max = std::stoi(args[4]);
+      if (args.size() == 6) {
+        end_frame = std::stoi(args[5]);
+      }
+    } catch (const std::logic_error&) {
+      print_usage();
+      return 1;
+    }
+  }
 
-  fg::FilterData filter_data;
-  filter_data.set_movie_file(argv[1]);
-  filter_data.set_jump_size(frame_interval_min);
+  std::unique_ptr<opencv::Profiler> profiler;
+  if (profile || !trace_file.empty()) {
+    profiler.reset(new opencv::Profiler(!trace_file.empty()));
+  }
 
-  MatcherCallback matcher_callback(frame_interval_min);
+  std::vector<LogoSearchRange> search_ranges;
+  SearchResumePoint resume_point{-1, 0};
 
-  std::shared_ptr<LogoFinder> finder
-    = create_logo_finder(filter_data, matcher_callback, true);
-  finder->set_start_frame(start_frame);
-  finder->set_frame_interval_min(frame_interval_min);
-  finder->set_extra_frames(frame_interval_max - frame_interval_min);
+  Configure configure = [&](LogoFinder& finder) {
+    finder.set_start_frame(start_frame);
+    if (n_shards > 0) {
+      int last_frame = std::min(end_frame, finder.get_total_frames());
+      finder.set_search_ranges({get_shard_range(shard, n_shards, start_frame, last_frame, frame_interval_min)});
+    } else {
+      finder.set_search_ranges(search_ranges);
+    }
+    if (resume_point.start_frame >= 0) {
+      if (n_shards > 0) {
+        std::vector<LogoSearchRange> ranges = finder.get_search_ranges();
+        ranges[0].start_frame = std::max(ranges[0].start_frame, resume_point.start_frame);
+        finder.set_search_ranges(ranges);
+      } else {
+        finder.set_start_frame(resume_point.start_frame);
+      }
+      finder.set_initial_failures(resume_point.failures);
+    }
+    finder.set_frame_interval_min(frame_interval_min);
+    finder.set_extra_frames(frame_interval_max - frame_interval_min);
+    options.configure(finder);
+    // The finders made by create_logo_finder() are always OpenCV ones
+    if (profiler) {
+      dynamic_cast<opencv::OpenCVLogoFinder&>(finder).set_profiler(profiler.get());
+    }
+  };
 
-  int end_frame;
-  if (argc == 7) {
-    end_frame = atoi(argv[6]);
+  if (batch_mode) {
+    std::cout << "Processing batch " << batch_file
+              << ", " << jobs << " job(s)";
   } else {
-    end_frame = std::numeric_limits<int>::max();
+    std::cout << "Processing video " << args[0]
+              << " from " << start_frame << " until " << end_frame
+              << ", interval " << frame_interval_min << "-" << frame_interval_max;
   }
+  options.write(std::cout);
+  std::cout << ", " << (review_file.empty() ? "whole video" : "review of " + review_file)
+            << ", " << (n_shards > 0 ? "shard " + std::to_string(shard) + "/" + std::to_string(n_shards) : "no shards")
+            << (batch_mode ? "" : ", output " + args[1])
+            << std::endl;
+
+  int ret;
+  if (batch_mode) {
+    std::vector<BatchItem> items;
+    if (!read_batch_items(batch_file, items)) {
+      return 1;
+    }
+    ret = batch(items, jobs, options.threads, options.search_regions, options.cache_file, configure);
+  } else if (sweep_file.empty()) {
+    std::unique_ptr<fg::FilterData> filter_data;
+    if (review_file.empty()) {
+      filter_data = new_filter_data(args[0], frame_interval_min, options.search_regions);
+    } else {
+      // The results replace the review filters of the project, the
+      // other filters are kept
+      filter_data = load_project(review_file);
+      if (!filter_data) {
+        return 1;
+      }
+      filter_data->set_movie_file(args[0]);
+      if (!options.search_regions.empty()) {
+        filter_data->search_regions() = options.search_regions;
+      }
+      search_ranges = get_review_ranges(filter_data->filter_list(), std::numeric_limits<int>::max());
+      std::cout << search_ranges.size() << " range(s) marked for review" << std::endl;
+    }
+
+    // The results are journaled as they are found, and replayed by
+    // --resume after an interrupted search. A review is not, it is
+    // just run again
+    bool journaled = review_file.empty();
+    std::string journal_file = args[1] + ".journal";
+    std::ofstream journal;
+    if (resume) {
+      // Written again without an incomplete last line, that the new
+      // results would be appended to
+      std::stringstream previous;
+      {
+        std::ifstream in(journal_file);
+        previous << in.rdbuf();
+      }
+      journal.open(journal_file);
+      NullCallback null_callback;
+      FilterListAdapter adapter(filter_data->filter_list(), null_callback);
+      SearchJournal rewrite(journal, adapter);
+      resume_point = SearchJournal::replay(previous, rewrite);
+      if (resume_point.start_frame >= 0) {
+        std::cout << "Resuming from " << resume_point.start_frame
+                  << " after " << resume_point.failures << " failure(s)" << std::endl;
+      } else {
+        std::cout << "Nothing to resume in " << journal_file << std::endl;
+      }
+    } else if (journaled) {
+      journal.open(journal_file);
+    }
+
+    LogoFinder::find_result res(true, "");
+    if (review_file.empty() || !search_ranges.empty()) {
+      res = find_logos(*filter_data, frame_interval_min, end_frame, true, configure,
+                       journaled ? &journal : nullptr);
+    }
+    journal.close();
+
+    std::ofstream output(args[1]);
+    filter_data->save(output);
+
+    if (res.first) {
+      if (journaled) {
+        std::remove(journal_file.c_str());
+      }
+      std::cout << "Finished successfully" << std::endl;
+      ret = 0;
+    } else {
+      std::cout << "Error: " << res.second << std::endl;
+      ret = 2;
+    }
+  } else {
+    ret = sweep(sweep_file, reference_file, args[0], args[1], options.search_regions,
+                frame_interval_min, end_frame, options.cache_file, configure);
+  }
+
+  if (profile) {
+    std::cout << std::endl;
+    profiler->write_summary(std::cout);
+    std::cout << std::endl;
+  }
+  if (!trace_file.empty()) {
+    std::ofstream trace(trace_file);
+    profiler->write_trace(trace);
+  }
+
+  return ret;
+}
+
+
+std::unique_ptr<fg::FilterData> new_filter_data(const std::string& video, int frame_interval_min,
+                                                const std::vector<fg::SearchRegion>& search_regions)
+{
+  std::unique_ptr<fg::FilterData> filter_data(new fg::FilterData());
+  filter_data->set_movie_file(video);
+  filter_data->set_jump_size(frame_interval_min);
+  filter_data->search_regions() = search_regions;
+  return filter_data;
+}
+
+
+std::unique_ptr<fg::FilterData> load_project(const std::string& file)
+{
+  std::unique_ptr<fg::FilterData> filter_data(new fg::FilterData());
+  std::ifstream in(file);
+  try {
+    filter_data->load(in);
+  } catch (const std::exception& e) {
+    std::cout << "Could not load " << file << ": " << e.what() << std::endl;
+    return nullptr;
+  }
+  return filter_data;
+}
+
+
+// Runs up to jobs searches at the same time. Each search gets the
+// threads divided among the videos not finished yet when it starts,
+// and keeps them until it finishes: the threads of a search that
+// finishes are not given to the others still running, so the last
+// videos of a batch can leave threads idle. Each project is
+// saved as soon as its search finishes, first to a temporary file so
+// that the output of an interrupted search is never taken as done
+int batch(const std::vector<BatchItem>& items, int jobs, int threads,
+          const std::vector<fg::SearchRegion>& search_regions,
+          const std::string& cache_dir, const Configure& configure)
+{
+  std::vector<const BatchItem*> pending;
+  for (auto& item: items) {
+    if (std::ifstream(item.output)) {
+      std::cout << "Skipping " << item.video << ", " << item.output << " already exists" << std::endl;
+    } else {
+      pending.push_back(&item);
+    }
+  }
+
+  std::mutex mutex;
+  size_t next = 0;
+  size_t finished = 0;
+  bool all_finished = true;
+
+  auto run_jobs = [&]() {
+    for (;;) {
+      const BatchItem* item;
+      int item_threads;
+      {
+        std::lock_guard<std::mutex> lock(mutex);
+        if (next == pending.size()) {
+          return;
+        }
+        item = pending[next++];
+        size_t unfinished = pending.size() - finished;
+        item_threads = std::max(1, threads / int(std::min<size_t>(jobs, unfinished)));
+        std::cout << "Starting " << item->video << " with " << item_threads << " thread(s)" << std::endl;
+      }
+
+      std::unique_ptr<fg::FilterData> filter_data
+        = new_filter_data(item->video, item->frame_interval_min, search_regions);
+      BatchCallback callback(*item, mutex);
+      auto start = std::chrono::steady_clock::now();
+      LogoFinder::find_result res;
+      try {
+        std::shared_ptr<LogoFinder> finder = create_logo_finder(*filter_data, callback, false);
+        configure(*finder);
+        finder->set_start_frame(item->start_frame);
+        finder->set_frame_interval_min(item->frame_interval_min);
+        finder->set_extra_frames(item->frame_interval_max - item->frame_interval_min);
+        finder->set_threads(item_threads);
+        if (!cache_dir.empty()) {
+          std::string name = item->output.substr(item->output.rfind('/') + 1);
+          finder->set_cache_file(cache_dir + "/" + name + ".sums");
+        }
+        for (auto& value: item->values) {
+          set_parameter(*finder, value.first, value.second);
+        }
+        callback.set_finder(finder.get());
+        res = finder->find_logos();
+      } catch (const std::exception& e) {
+        res = std::make_pair(false, std::string(e.what()));
+      }
+      std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+
+      if (res.first) {
+        std::string temporary = item->output + ".part";
+        {
+          std::ofstream output(temporary);
+          filter_data->save(output);
+        }
+        std::rename(temporary.c_str(), item->output.c_str());
+      }
+
+      std::lock_guard<std::mutex> lock(mutex);
+      ++finished;
+      std::cout << "[" << finished << "/" << pending.size() << "] " << item->video;
+      if (res.first) {
+        std::cout << " finished in " << std::fixed << std::setprecision(1) << elapsed.count() << "s" << std::endl;
+      } else {
+        std::cout << " failed: " << res.second << std::endl;
+        all_finished = false;
+      }
+    }
+  };
+
+  std::vector<std::thread> workers;
+  for (int i = 0; i < std::min<int>(jobs, pending.size()); ++i) {
+    workers.emplace_back(run_jobs);
+  }
+  for (auto& worker: workers) {
+    worker.join();
+  }
+
+  return all_finished ? 0 : 2;
+}
+
+
+// The shards are made of whole intervals, so that they start where
+// the search of all the frames would start an interval if no logo were
+// found. Each shard is searched up to the start of the next, the
+// logos crossing the boundaries are joined by mdl-merge
+LogoSearchRange get_shard_range(int shard, int n_shards, int start_frame, int end_frame, int frame_interval)
+{
+  long long n_intervals = (end_frame - start_frame + frame_interval - 1) / frame_interval;
+  auto boundary = [&](int i) {
+    return std::min(end_frame, start_frame + int(n_intervals * i / n_shards) * frame_interval);
+  };
+  return LogoSearchRange{boundary(shard - 1), boundary(shard)};
+}
+
+
+LogoFinder::find_result find_logos(fg::FilterData& filter_data, int frame_interval_min, int end_frame,
+                                   bool verbose, const Configure& configure, std::ostream* journal)
+{
+  MatcherCallback matcher_callback(frame_interval_min);
+  LogoFinderCallback* callback = &matcher_callback;
+  std::unique_ptr<SearchJournal> search_journal;
+  if (journal) {
+    search_journal.reset(new SearchJournal(*journal, matcher_callback));
+    callback = search_journal.get();
+  }
+
+  std::shared_ptr<LogoFinder> finder
+    = create_logo_finder(filter_data, *callback, verbose);
+  configure(*finder);
 
   matcher_callback.set_end_frame(end_frame);
   matcher_callback.set_finder(finder.get());
 
-  std::cout << "Processing video " << argv[1]
-            << " from " << start_frame << " until " << end_frame
-            << ", interval " << frame_interval_min << "-" << frame_interval_max
-            << ", output " << argv[2]
-            << std::endl;
+  return finder->find_logos();
+}
 
-  auto res = finder->find_logos();
 
-  std::ofstream output(argv[2]);
-  filter_data.save(output);
+int sweep(const std::string& sweep_file, const std::string& reference_file,
+          const std::string& video, const std::string& output,
+          const std::vector<fg::SearchRegion>& search_regions,
+          int frame_interval_min, int end_frame,
+          std::string cache_file, const Configure& configure)
+{
+  std::vector<ParameterSet> sets;
+  if (!read_parameter_sets(sweep_file, sets)) {
+    return 1;
+  }
+  if (sets.empty()) {
+    std::cout << "No parameter sets in " << sweep_file << std::endl;
+    return 1;
+  }
 
-  if (res.first) {
-    std::cout << "Finished successfully" << std::endl;
-  } else {
-    std::cout << "Error: " << res.second << std::endl;
-    return 2;
+  std::unique_ptr<fg::FilterData> reference;
+  if (!reference_file.empty()) {
+    reference = load_project(reference_file);
+    if (!reference) {
+      return 1;
+    }
+  }
+
+  // The sums of the frames are shared by the parameter sets through
+  // the cache, so the intervals searched with the same boundaries are
+  // decoded only by the first set
+  bool temporary_cache = cache_file.empty();
+  if (temporary_cache) {
+    cache_file = temporary_file("logo-finder-sweep", ".sums");
+  }
+
+  std::vector<SweepResult> results;
+  bool all_finished = true;
+  for (size_t i = 0; i < sets.size(); ++i) {
+    std::cout << "Parameter set " << i + 1 << ": " << sets[i].line << std::endl;
+
+    SweepResult result{0, new_filter_data(video, frame_interval_min, search_regions)};
+    auto start = std::chrono::steady_clock::now();
+    auto res = find_logos(*result.filter_data, frame_interval_min, end_frame, false,
+      [&](LogoFinder& finder) {
+        configure(finder);
+        finder.set_cache_file(cache_file);
+        for (auto& value: sets[i].values) {
+          set_parameter(finder, value.first, value.second);
+        }
+      });
+    std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+    result.seconds = elapsed.count();
+
+    if (!res.first) {
+      std::cout << "Error: " << res.second << std::endl;
+      all_finished = false;
+    }
+
+    std::ofstream out(sweep_output_file(output, i + 1));
+    result.filter_data->save(out);
+    results.push_back(std::move(result));
+  }
+
+  if (temporary_cache) {
+    remove_logo_finder_cache(cache_file);
+  }
+
+  print_sweep_summary(sets, results, reference.get());
+  return all_finished ? 0 : 2;
+}
+
+
+// Name of a file in the temporary directory, made unique by the time
+std::string temporary_file(const std::string& prefix, const std::string& suffix)
+{
+  std::string dir;
+  for (const char* variable: {"TMPDIR", "TEMP", "TMP"}) {
+    const char* value = std::getenv(variable);
+    if (value && *value) {
+      dir = value;
+      break;
+    }
+  }
+  if (dir.empty()) {
+    dir = "/tmp";
+  }
+
+  auto now = std::chrono::system_clock::now().time_since_epoch();
+  return dir + "/" + prefix + "-" + std::to_string(std::chrono::duration_cast<std::chrono::microseconds>(now).count())
+    + suffix;
+}
+
+
+// Inserts the number of the parameter set before the extension
+std::string sweep_output_file(const std::string& output, int set)
+{
+  size_t dot = output.rfind('.');
+  size_t slash = output.rfind('/');
+  if (dot == std::string::npos || (slash != std::string::npos && dot < slash)) {
+    return output + "-" + std::to_string(set);
+  }
+  return output.substr(0, dot) + "-" + std::to_string(set) + output.substr(dot);
+}
+
+
+void print_sweep_summary(const std::vector<ParameterSet>& sets, const std::vector<SweepResult>& results,
+                         fg::FilterData* reference)
+{
+  std::cout << std::endl
+            << std::setw(4) << "Set" << std::setw(10) << "Time (s)"
+            << std::setw(9) << "Filters" << std::setw(8) << "Review";
+  if (reference) {
+    std::cout << std::setw(7) << "Equal" << std::setw(11) << "Different" << std::setw(9) << "Missing";
+  }
+  std::cout << "  Parameters" << std::endl;
+
+  for (size_t i = 0; i < results.size(); ++i) {
+    const fg::FilterList& filter_list = results[i].filter_data->filter_list();
+    FilterListComparison comparison = FilterListComparison::compare(
+      reference ? reference->filter_list() : filter_list, filter_list);
+
+    std::cout << std::setw(4) << i + 1
+              << std::setw(10) << std::fixed << std::setprecision(1) << results[i].seconds
+              << std::setw(9) << comparison.filters
+              << std::setw(8) << comparison.review;
+    if (reference) {
+      std::cout << std::setw(7) << comparison.equal
+                << std::setw(11) << comparison.different
+                << std::setw(9) << comparison.missing;
+    }
+    std::cout << "  " << sets[i].line << std::endl;
+  }
+
+  if (reference) {
+    std::cout << "Reference has " << reference->filter_list().size() << " filters" << std::endl;
   }
 }
 
@@ -134,3 +950,45 @@ void MatcherCallback::set_finder(LogoFinder* finder)
 {
   finder_ = finder;
 }
+
+
+BatchCallback::BatchCallback(const BatchItem& item, std::mutex& output_mutex)
+  : item_(item)
+  , output_mutex_(output_mutex)
+  , finder_(nullptr)
+{
+}
+
+
+void BatchCallback::success(const LogoFinderResult& result)
+{
+  print_progress("success", result.start_frame, result.end_frame);
+}
+
+
+void BatchCallback::failure(int start_frame, int end_frame)
+{
+  print_progress("failure", start_frame, end_frame);
+}
+
+
+void BatchCallback::set_finder(LogoFinder* finder)
+{
+  finder_ = finder;
+}
+
+
+void BatchCallback::print_progress(const char* result, int start_frame, int end_frame)
+{
+  int last_frame = std::min(item_.end_frame, finder_->get_total_frames());
+  int percent = 100 * std::min(1.0, double(end_frame - item_.start_frame) / std::max(1, last_frame - item_.start_frame));
+  {
+    std::lock_guard<std::mutex> lock(output_mutex_);
+    std::cout << item_.video << ": " << percent << "%, " << result
+              << " at " << start_frame << "-" << end_frame << std::endl;
+  }
+
+  if ((start_frame + item_.frame_interval_min) > item_.end_frame) {
+    finder_->stop();
+  }
+}
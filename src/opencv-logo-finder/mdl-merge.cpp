@@ -0,0 +1,197 @@
+/*
+ * Copyright (C) 2018-2025 Werner Turing <werner.turing@protonmail.com>
+ *
+ * This file is part of multi-delogo.
+ *
+ * multi-delogo is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * multi-delogo is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with multi-delogo.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include <cstdlib>
+#include <algorithm>
+#include <memory>
+#include <string>
+#include <stdexcept>
+#include <vector>
+#include <iostream>
+#include <fstream>
+
+#include "filter-generator/FilterData.hpp"
+
+#include "gui/common/Exceptions.hpp"
+
+#include "FilterListAdapter.hpp"
+#include "ShardMerge.hpp"
+#include "SearchOptions.hpp"
+
+using namespace mdl;
+
+
+// Joins the projects saved by logo-finder --shard into one project,
+// searching again the frames around the seams where a logo was split
+// in different filters
+
+
+class PrintCallback : public LogoFinderCallback
+{
+public:
+  void success(const LogoFinderResult& result) override;
+  void failure(int start_frame, int end_frame) override;
+};
+
+
+void print_usage()
+{
+  std::cout << "Usage: mdl-merge [options] <output> <shard>..." << std::endl
+            << std::endl
+            << "Options:" << std::endl
+            << "  --margin <n>        Number of frames searched again on each side of the" << std::endl
+            << "                      seams (default twice the jump size of the projects)" << std::endl
+            << "  --max-interval <n>  The <frame_interval_max> given to logo-finder for the" << std::endl
+            << "                      shards, so that the seams are searched as precisely" << std::endl
+            << "                      (default the jump size of the projects, which finds" << std::endl
+            << "                      the transitions only at multiples of it)" << std::endl
+            << "  --no-recheck        Leave the frames around the seams marked for review" << std::endl
+            << "                      instead of searching them again" << std::endl
+            << std::endl
+            << "The seams are searched with the options of logo-finder below, which" << std::endl
+            << "should be the ones given for the shards:" << std::endl;
+  SearchOptions::write_usage(std::cout);
+}
+
+
+std::unique_ptr<fg::FilterData> load_project(const std::string& file);
+
+
+int main(int argc, char* argv[])
+{
+  std::vector<std::string> args;
+  int margin = -1;
+  int max_interval = -1;
+  SearchOptions options;
+  bool recheck = true;
+  for (int i = 1; i < argc; ++i) {
+    std::string arg = argv[i];
+    bool search_option;
+    try {
+      search_option = options.read(argc, argv, i);
+    } catch (const std::invalid_argument&) {
+      print_usage();
+      return 1;
+    }
+    if (search_option) {
+      continue;
+    }
+
+    if (arg == "--margin" && i + 1 < argc) {
+      margin = std::max(0, atoi(argv[++i]));
+    } else if (arg == "--max-interval" && i + 1 < argc) {
+      max_interval = std::max(0, atoi(argv[++i]));
+    } else if (arg == "--no-recheck") {
+      recheck = false;
+    } else {
+      args.push_back(arg);
+    }
+  }
+
+  if (args.size() < 3) {
+    print_usage();
+    return 1;
+  }
+
+  std::vector<std::unique_ptr<fg::FilterData>> shards;
+  for (size_t i = 1; i < args.size(); ++i) {
+    std::unique_ptr<fg::FilterData> shard = load_project(args[i]);
+    if (!shard) {
+      return 1;
+    }
+    shards.push_back(std::move(shard));
+  }
+
+  fg::FilterData merged;
+  merged.set_movie_file(shards[0]->movie_file());
+  merged.set_jump_size(shards[0]->jump_size());
+  merged.search_regions() = options.search_regions.empty()
+    ? shards[0]->search_regions() : options.search_regions;
+  if (margin < 0) {
+    margin = 2 * merged.jump_size();
+  }
+  if (max_interval < merged.jump_size()) {
+    max_interval = merged.jump_size();
+  }
+
+  PrintCallback callback;
+  std::shared_ptr<LogoFinder> finder;
+  try {
+    finder = create_logo_finder(merged, callback, true);
+  } catch (const VideoNotOpenedException& e) {
+    std::cout << "Could not open video " << merged.movie_file() << std::endl;
+    return 1;
+  }
+
+  std::vector<const fg::FilterList*> lists;
+  for (auto& shard: shards) {
+    lists.push_back(&shard->filter_list());
+  }
+  std::vector<LogoSearchRange> ranges
+    = ShardMerge::merge(lists, margin, finder->get_total_frames(), merged.filter_list());
+  std::cout << ranges.size() << " seam(s) to be searched again" << std::endl;
+
+  int ret = 0;
+  if (recheck && !ranges.empty()) {
+    options.configure(*finder);
+    finder->set_search_ranges(ranges);
+    finder->set_frame_interval_min(merged.jump_size());
+    finder->set_extra_frames(max_interval - merged.jump_size());
+
+    auto res = finder->find_logos();
+    if (res.first) {
+      ShardMerge::join_equal_filters(merged.filter_list());
+    } else {
+      std::cout << "Error: " << res.second << std::endl;
+      ret = 2;
+    }
+  }
+
+  std::ofstream output(args[0]);
+  merged.save(output);
+
+  return ret;
+}
+
+
+std::unique_ptr<fg::FilterData> load_project(const std::string& file)
+{
+  std::unique_ptr<fg::FilterData> filter_data(new fg::FilterData());
+  std::ifstream in(file);
+  try {
+    filter_data->load(in);
+  } catch (const std::exception& e) {
+    std::cout << "Could not load " << file << ": " << e.what() << std::endl;
+    return nullptr;
+  }
+  return filter_data;
+}
+
+
+void PrintCallback::success(const LogoFinderResult& result)
+{
+  std::cout << "Success at "
+            << result.start_frame << "-" << result.end_frame << std::endl;
+}
+
+
+void PrintCallback::failure(int start_frame, int end_frame)
+{
+  std::cout << "Failure at "
+            << start_frame << "-" << end_frame << std::endl;
+}
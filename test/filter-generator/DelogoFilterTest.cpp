@@ -122,6 +122,47 @@ BOOST_AUTO_TEST_CASE(delogo_needs_a_one_pixel_margin_from_the_borders_br)
 }
 
 
+BOOST_AUTO_TEST_CASE(test_load_with_other_regions)
+{
+  std::shared_ptr<fg::DelogoFilter> filter = fg::DelogoFilter::load("1;22;333;4444;5;6;7;8");
+
+  BOOST_CHECK_EQUAL(filter->x(), 1);
+  BOOST_CHECK_EQUAL(filter->height(), 4444);
+  BOOST_REQUIRE_EQUAL(filter->other_regions().size(), 1);
+  BOOST_CHECK_EQUAL(filter->other_regions()[0].x, 5);
+  BOOST_CHECK_EQUAL(filter->other_regions()[0].y, 6);
+  BOOST_CHECK_EQUAL(filter->other_regions()[0].width, 7);
+  BOOST_CHECK_EQUAL(filter->other_regions()[0].height, 8);
+}
+
+
+BOOST_AUTO_TEST_CASE(test_load_with_incomplete_other_region)
+{
+  BOOST_CHECK_THROW(fg::DelogoFilter::load("1;22;333;4444;5;6;7"),
+                    fg::InvalidParametersException);
+}
+
+
+BOOST_AUTO_TEST_CASE(test_save_str_with_other_regions)
+{
+  fg::DelogoFilter filter(10, 15, 100, 20, {{500, 15, 60, 30}});
+
+  std::string serialized(filter.save_str());
+
+  BOOST_CHECK_EQUAL(serialized, "delogo;10;15;100;20;500;15;60;30");
+}
+
+
+BOOST_AUTO_TEST_CASE(test_ffmpeg_str_with_other_regions)
+{
+  fg::DelogoFilter filter(50, 60, 150, 30, {{0, 600, 100, 20}});
+
+  std::string ffmpeg(filter.ffmpeg_str(1280, 720));
+
+  BOOST_CHECK_EQUAL(ffmpeg, "delogo=x=50:y=60:w=150:h=30,delogo=x=1:y=600:w=100:h=20");
+}
+
+
 BOOST_AUTO_TEST_CASE(test_ffmpeg_audio_str)
 {
   fg::DelogoFilter filter(1, 2, 3, 4);
@@ -39,6 +39,14 @@ BOOST_AUTO_TEST_CASE(should_identify_a_valid_header)
 }
 
 
+BOOST_AUTO_TEST_CASE(should_identify_a_valid_version_2_header)
+{
+  std::istringstream in("MDLV2\n");
+
+  BOOST_TEST(FilterData::is_filter_data(in));
+}
+
+
 BOOST_AUTO_TEST_CASE(should_identify_a_valid_header_with_windows_line_ending)
 {
   std::istringstream in("MDLV1\r\n");
@@ -66,7 +74,7 @@ BOOST_AUTO_TEST_CASE(should_identify_an_invalid_header_2)
 BOOST_AUTO_TEST_CASE(load_should_fail_if_header_is_invalid)
 {
   std::istringstream in(
-    "MDLV2\n"
+    "MDLV4\n"
     "file=Movie.mp4\n");
 
   FilterData filters;
@@ -165,6 +173,94 @@ BOOST_AUTO_TEST_CASE(should_load_a_file_with_filters_with_windows_line_ending)
 }
 
 
+BOOST_AUTO_TEST_CASE(should_load_a_file_with_search_regions)
+{
+  std::istringstream in(
+    "MDLV2\n"
+    "Movie.mp4\n"
+    "500\n"
+    "2\n"
+    "0;0;320;90\n"
+    "960;630;320;90\n"
+    "1;drawbox;10;20;30;40\n");
+
+  FilterData filters;
+  filters.load(in);
+
+  BOOST_CHECK_EQUAL(filters.movie_file(), "Movie.mp4");
+  BOOST_CHECK_EQUAL(filters.jump_size(), 500);
+
+  BOOST_CHECK_EQUAL(filters.search_regions().size(), 2);
+  BOOST_CHECK_EQUAL(filters.search_regions()[0].x, 0);
+  BOOST_CHECK_EQUAL(filters.search_regions()[0].y, 0);
+  BOOST_CHECK_EQUAL(filters.search_regions()[0].width, 320);
+  BOOST_CHECK_EQUAL(filters.search_regions()[0].height, 90);
+  BOOST_CHECK_EQUAL(filters.search_regions()[1].x, 960);
+  BOOST_CHECK_EQUAL(filters.search_regions()[1].y, 630);
+  BOOST_CHECK_EQUAL(filters.search_regions()[1].width, 320);
+  BOOST_CHECK_EQUAL(filters.search_regions()[1].height, 90);
+
+  BOOST_CHECK_EQUAL(filters.filter_list().size(), 1);
+}
+
+
+BOOST_AUTO_TEST_CASE(a_version_1_file_has_no_search_regions)
+{
+  std::istringstream in(
+    "MDLV1\n"
+    "Movie.mp4\n"
+    "500\n"
+    "1;drawbox;10;20;30;40\n");
+
+  FilterData filters;
+  filters.load(in);
+
+  BOOST_CHECK_EQUAL(filters.search_regions().size(), 0);
+  BOOST_CHECK_EQUAL(filters.filter_list().size(), 1);
+}
+
+
+BOOST_AUTO_TEST_CASE(load_should_fail_if_number_of_search_regions_is_missing)
+{
+  std::istringstream in(
+    "MDLV2\n"
+    "Movie.mp4\n"
+    "500\n");
+
+  FilterData filters;
+  BOOST_CHECK_THROW(filters.load(in), InvalidFilterDataException);
+}
+
+
+BOOST_AUTO_TEST_CASE(load_should_fail_if_some_search_region_is_invalid)
+{
+  std::istringstream in(
+    "MDLV2\n"
+    "Movie.mp4\n"
+    "500\n"
+    "2\n"
+    "0;0;320;90\n"
+    "960;630;320\n");
+
+  FilterData filters;
+  BOOST_CHECK_THROW(filters.load(in), InvalidFilterDataException);
+}
+
+
+BOOST_AUTO_TEST_CASE(load_should_fail_if_some_search_region_is_missing)
+{
+  std::istringstream in(
+    "MDLV2\n"
+    "Movie.mp4\n"
+    "500\n"
+    "2\n"
+    "0;0;320;90\n");
+
+  FilterData filters;
+  BOOST_CHECK_THROW(filters.load(in), InvalidFilterDataException);
+}
+
+
 BOOST_AUTO_TEST_CASE(should_fail_if_some_filter_is_invalid)
 {
   std::istringstream in(
@@ -198,3 +294,67 @@ BOOST_AUTO_TEST_CASE(test_save)
     "251;delogo;9;8;7;6\n";
   BOOST_CHECK_EQUAL(out.str(), expected);
 }
+
+
+BOOST_AUTO_TEST_CASE(should_load_a_file_with_other_delogo_regions)
+{
+  std::istringstream in(
+    "MDLV3\n"
+    "Movie.mp4\n"
+    "500\n"
+    "0\n"
+    "1;delogo;10;20;30;40;50;60;70;80\n");
+
+  FilterData filters;
+  filters.load(in);
+
+  BOOST_CHECK_EQUAL(filters.search_regions().size(), 0);
+  BOOST_REQUIRE_EQUAL(filters.filter_list().size(), 1);
+  auto filter = std::dynamic_pointer_cast<DelogoFilter>(filters.filter_list().get_by_start_frame(1)->second);
+  BOOST_REQUIRE(filter);
+  BOOST_CHECK_EQUAL(filter->other_regions().size(), 1);
+}
+
+
+BOOST_AUTO_TEST_CASE(test_save_with_search_regions)
+{
+  FilterData filters;
+  filters.set_movie_file("/home/user/videos/test.mp4");
+  filters.set_jump_size(360);
+  filters.search_regions().push_back(SearchRegion{960, 0, 320, 90});
+  filters.filter_list().insert(1, filter_ptr(new DelogoFilter(1, 2, 3, 4)));
+
+  std::ostringstream out;
+  filters.save(out);
+
+  std::string expected =
+    "MDLV2\n"
+    "/home/user/videos/test.mp4\n"
+    "360\n"
+    "1\n"
+    "960;0;320;90\n"
+    "1;delogo;1;2;3;4\n";
+  BOOST_CHECK_EQUAL(out.str(), expected);
+}
+
+
+BOOST_AUTO_TEST_CASE(test_save_with_other_delogo_regions)
+{
+  FilterData filters;
+  filters.set_movie_file("/home/user/videos/test.mp4");
+  filters.set_jump_size(360);
+  filters.filter_list().insert(1, filter_ptr(new DelogoFilter(1, 2, 3, 4)));
+  filters.filter_list().insert(251, filter_ptr(new DelogoFilter(9, 8, 7, 6, {DelogoRegion{5, 6, 7, 8}})));
+
+  std::ostringstream out;
+  filters.save(out);
+
+  std::string expected =
+    "MDLV3\n"
+    "/home/user/videos/test.mp4\n"
+    "360\n"
+    "0\n"
+    "1;delogo;1;2;3;4\n"
+    "251;delogo;9;8;7;6;5;6;7;8\n";
+  BOOST_CHECK_EQUAL(out.str(), expected);
+}
@@ -0,0 +1,117 @@
+/*
+ * Copyright (C) 2018-2025 Werner Turing <werner.turing@protonmail.com>
+ *
+ * This file is part of multi-delogo.
+ *
+ * multi-delogo is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * multi-delogo is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with multi-delogo.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include <memory>
+#include <thread>
+#include <vector>
+
+#include "FrameBufferPool.hpp"
+
+using namespace mdl::opencv;
+
+
+#define BOOST_TEST_MODULE frame buffer pool
+#define BOOST_TEST_DYN_LINK
+#include <boost/test/unit_test.hpp>
+
+
+BOOST_AUTO_TEST_CASE(test_released_buffers_should_be_reused)
+{
+  auto pool = FrameBufferPool::create(4);
+
+  FrameBufferPool::buffer_ptr buffer = pool->acquire(1000);
+  unsigned char* memory = buffer.get();
+  buffer.reset();
+  BOOST_CHECK_EQUAL(pool->get_free_buffers(), 1);
+
+  buffer = pool->acquire(1000);
+  BOOST_CHECK(buffer.get() == memory);
+  BOOST_CHECK_EQUAL(pool->get_free_buffers(), 0);
+  BOOST_CHECK_EQUAL(pool->get_allocations(), 1);
+}
+
+
+BOOST_AUTO_TEST_CASE(test_buffers_in_use_should_not_be_reused)
+{
+  auto pool = FrameBufferPool::create(4);
+
+  FrameBufferPool::buffer_ptr buffer1 = pool->acquire(1000);
+  FrameBufferPool::buffer_ptr copy = buffer1;
+  buffer1.reset();
+  FrameBufferPool::buffer_ptr buffer2 = pool->acquire(1000);
+
+  BOOST_CHECK(buffer2.get() != copy.get());
+  BOOST_CHECK_EQUAL(pool->get_allocations(), 2);
+}
+
+
+BOOST_AUTO_TEST_CASE(test_a_new_size_should_free_the_buffers)
+{
+  auto pool = FrameBufferPool::create(4);
+
+  FrameBufferPool::buffer_ptr buffer = pool->acquire(1000);
+  pool->acquire(1000);
+  BOOST_CHECK_EQUAL(pool->get_free_buffers(), 1);
+
+  pool->acquire(2000);
+  BOOST_CHECK_EQUAL(pool->get_free_buffers(), 1);
+
+  // Of the old size, not kept
+  buffer.reset();
+  BOOST_CHECK_EQUAL(pool->get_free_buffers(), 1);
+}
+
+
+BOOST_AUTO_TEST_CASE(test_free_buffers_should_be_limited)
+{
+  auto pool = FrameBufferPool::create(2);
+
+  std::vector<FrameBufferPool::buffer_ptr> buffers;
+  for (int i = 0; i < 5; ++i) {
+    buffers.push_back(pool->acquire(1000));
+  }
+  buffers.clear();
+
+  BOOST_CHECK_EQUAL(pool->get_free_buffers(), 2);
+}
+
+
+BOOST_AUTO_TEST_CASE(test_buffers_should_outlive_the_pool)
+{
+  auto pool = FrameBufferPool::create(2);
+  FrameBufferPool::buffer_ptr buffer = pool->acquire(1000);
+  pool.reset();
+
+  buffer.get()[999] = 1;
+  buffer.reset();
+}
+
+
+BOOST_AUTO_TEST_CASE(test_buffers_can_be_released_by_other_threads)
+{
+  auto pool = FrameBufferPool::create(8);
+  std::vector<FrameBufferPool::buffer_ptr> buffers;
+  for (int i = 0; i < 8; ++i) {
+    buffers.push_back(pool->acquire(1000));
+  }
+
+  std::thread releaser([&buffers] { buffers.clear(); });
+  releaser.join();
+
+  BOOST_CHECK_EQUAL(pool->get_free_buffers(), 8);
+}
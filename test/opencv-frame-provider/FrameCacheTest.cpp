@@ -0,0 +1,113 @@
+/*
+ * Copyright (C) 2018-2025 Werner Turing <werner.turing@protonmail.com>
+ *
+ * This file is part of multi-delogo.
+ *
+ * multi-delogo is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * multi-delogo is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with multi-delogo.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include <memory>
+#include <string>
+
+#include "FrameCache.hpp"
+
+using namespace mdl::opencv;
+
+
+#define BOOST_TEST_MODULE frame cache
+#define BOOST_TEST_DYN_LINK
+#include <boost/test/unit_test.hpp>
+
+
+typedef std::shared_ptr<std::string> frame_ptr;
+
+frame_ptr frame(const std::string& name)
+{
+  return std::make_shared<std::string>(name);
+}
+
+
+BOOST_AUTO_TEST_CASE(test_get_should_return_the_frame_put)
+{
+  FrameCache<frame_ptr> cache(100);
+  frame_ptr frame10 = frame("10");
+  cache.put(10, frame10, 30);
+
+  frame_ptr cached;
+  BOOST_REQUIRE(cache.get(10, cached));
+  BOOST_CHECK(cached == frame10);
+  BOOST_CHECK(!cache.get(11, cached));
+  BOOST_CHECK_EQUAL(cache.get_hits(), 1);
+  BOOST_CHECK_EQUAL(cache.get_misses(), 1);
+}
+
+
+BOOST_AUTO_TEST_CASE(test_least_recently_used_should_be_dropped)
+{
+  FrameCache<frame_ptr> cache(100);
+  cache.put(1, frame("1"), 40);
+  cache.put(2, frame("2"), 40);
+  frame_ptr cached;
+  cache.get(1, cached);
+
+  cache.put(3, frame("3"), 40);
+
+  BOOST_CHECK(cache.contains(1));
+  BOOST_CHECK(!cache.contains(2));
+  BOOST_CHECK(cache.contains(3));
+  BOOST_CHECK_EQUAL(cache.get_bytes(), 80);
+}
+
+
+BOOST_AUTO_TEST_CASE(test_put_again_should_replace_the_frame)
+{
+  FrameCache<frame_ptr> cache(100);
+  cache.put(1, frame("old"), 40);
+  cache.put(1, frame("new"), 50);
+
+  frame_ptr cached;
+  BOOST_REQUIRE(cache.get(1, cached));
+  BOOST_CHECK_EQUAL(*cached, "new");
+  BOOST_CHECK_EQUAL(cache.size(), 1);
+  BOOST_CHECK_EQUAL(cache.get_bytes(), 50);
+}
+
+
+BOOST_AUTO_TEST_CASE(test_frames_bigger_than_the_budget_should_not_be_kept)
+{
+  FrameCache<frame_ptr> cache(100);
+  cache.put(1, frame("1"), 40);
+  cache.put(2, frame("2"), 120);
+
+  BOOST_CHECK(cache.contains(1));
+  BOOST_CHECK(!cache.contains(2));
+}
+
+
+BOOST_AUTO_TEST_CASE(test_reducing_the_budget_should_drop_frames)
+{
+  FrameCache<frame_ptr> cache(100);
+  cache.put(1, frame("1"), 30);
+  cache.put(2, frame("2"), 30);
+  cache.put(3, frame("3"), 30);
+
+  cache.set_max_bytes(60);
+
+  BOOST_CHECK(!cache.contains(1));
+  BOOST_CHECK(cache.contains(2));
+  BOOST_CHECK(cache.contains(3));
+
+  cache.set_max_bytes(0);
+  BOOST_CHECK_EQUAL(cache.size(), 0);
+  BOOST_CHECK_EQUAL(cache.get_bytes(), 0);
+}
@@ -0,0 +1,151 @@
+/*
+ * Copyright (C) 2018-2025 Werner Turing <werner.turing@protonmail.com>
+ *
+ * This file is part of multi-delogo.
+ *
+ * multi-delogo is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * multi-delogo is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with multi-delogo.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include <cstdio>
+#include <string>
+#include <fstream>
+
+#include "KeyframeIndex.hpp"
+
+using namespace mdl::opencv;
+
+
+#define BOOST_TEST_MODULE keyframe index
+#define BOOST_TEST_DYN_LINK
+#include <boost/test/unit_test.hpp>
+
+
+// Packets of a video with frames I B B P B B P... in presentation
+// order, stored as I P B B P B B..., with a keyframe every 250 frames
+// and PTS in units of 1/90000s at 25fps. n_frames must be 3k + 1
+KeyframeIndex long_gop_index(int n_frames)
+{
+  const int GOP = 250;
+  const int PTS_PER_FRAME = 3600;
+
+  KeyframeIndex index;
+  for (int stored = 0; stored < n_frames; ++stored) {
+    int frame;
+    if (stored == 0) {
+      frame = 0;
+    } else if ((stored - 1) % 3 == 0) {
+      frame = stored + 2;
+    } else {
+      frame = stored - 1;
+    }
+    index.add_packet(int64_t(frame) * PTS_PER_FRAME, frame % GOP == 0);
+  }
+  index.finish();
+  return index;
+}
+
+
+struct TempFiles
+{
+  const std::string index_file = "KeyframeIndexTest.keyframes";
+  const std::string video_file = "KeyframeIndexTest.video";
+
+  TempFiles()
+  {
+    std::ofstream(video_file) << "not really a video";
+  }
+
+  ~TempFiles()
+  {
+    std::remove(index_file.c_str());
+    std::remove(video_file.c_str());
+  }
+};
+
+
+BOOST_AUTO_TEST_CASE(test_keyframe_before)
+{
+  KeyframeIndex index = long_gop_index(1000);
+
+  BOOST_REQUIRE(!index.empty());
+  BOOST_CHECK_EQUAL(index.get_number_of_frames(), 1000);
+  BOOST_CHECK_EQUAL(index.get_keyframe_before(0), 0);
+  BOOST_CHECK_EQUAL(index.get_keyframe_before(249), 0);
+  BOOST_CHECK_EQUAL(index.get_keyframe_before(250), 250);
+  BOOST_CHECK_EQUAL(index.get_keyframe_before(999), 750);
+}
+
+
+BOOST_AUTO_TEST_CASE(test_frames_should_be_in_presentation_order)
+{
+  KeyframeIndex index = long_gop_index(1000);
+
+  BOOST_CHECK_EQUAL(index.get_frame_for_pts(0), 0);
+  BOOST_CHECK_EQUAL(index.get_frame_for_pts(3600), 1);
+  BOOST_CHECK_EQUAL(index.get_frame_for_pts(3600 * 500), 500);
+  BOOST_CHECK_EQUAL(index.get_frame_for_pts(3600 * 999), 999);
+  BOOST_CHECK_EQUAL(index.get_frame_for_pts(1800), -1);
+  BOOST_CHECK_EQUAL(index.get_frame_for_pts(3600 * 1000), -1);
+}
+
+
+BOOST_AUTO_TEST_CASE(test_repeated_pts_should_leave_the_index_empty)
+{
+  KeyframeIndex index;
+  index.add_packet(0, true);
+  index.add_packet(3600, false);
+  index.add_packet(3600, false);
+  index.finish();
+
+  BOOST_CHECK(index.empty());
+  BOOST_CHECK_EQUAL(index.get_keyframe_before(1), -1);
+}
+
+
+BOOST_AUTO_TEST_CASE(test_no_keyframe_at_the_start_should_leave_the_index_empty)
+{
+  KeyframeIndex index;
+  index.add_packet(0, false);
+  index.add_packet(3600, true);
+  index.finish();
+
+  BOOST_CHECK(index.empty());
+}
+
+
+BOOST_AUTO_TEST_CASE(test_save_and_load)
+{
+  TempFiles files;
+  KeyframeIndex index = long_gop_index(1000);
+  BOOST_REQUIRE(index.save(files.index_file, files.video_file));
+
+  KeyframeIndex loaded;
+  BOOST_REQUIRE(loaded.load(files.index_file, files.video_file));
+  BOOST_CHECK_EQUAL(loaded.get_number_of_frames(), 1000);
+  BOOST_CHECK_EQUAL(loaded.get_keyframe_before(620), 500);
+  BOOST_CHECK_EQUAL(loaded.get_frame_for_pts(3600 * 620), 620);
+}
+
+
+BOOST_AUTO_TEST_CASE(test_index_of_a_changed_video_should_not_be_loaded)
+{
+  TempFiles files;
+  KeyframeIndex index = long_gop_index(1000);
+  BOOST_REQUIRE(index.save(files.index_file, files.video_file));
+
+  std::ofstream(files.video_file, std::ios::app) << " anymore";
+
+  KeyframeIndex loaded;
+  BOOST_CHECK(!loaded.load(files.index_file, files.video_file));
+  BOOST_CHECK(loaded.empty());
+}
@@ -0,0 +1,105 @@
+/*
+ * Copyright (C) 2018-2025 Werner Turing <werner.turing@protonmail.com>
+ *
+ * This file is part of multi-delogo.
+ *
+ * multi-delogo is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * multi-delogo is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with multi-delogo.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include <vector>
+#include <thread>
+
+#include "PrefetchQueue.hpp"
+
+using namespace mdl::opencv;
+
+
+#define BOOST_TEST_MODULE prefetch queue
+#define BOOST_TEST_DYN_LINK
+#include <boost/test/unit_test.hpp>
+
+
+BOOST_AUTO_TEST_CASE(test_frames_should_be_taken_in_order)
+{
+  PrefetchQueue queue;
+  queue.set_requests({10, 9, 20});
+
+  int frame;
+  BOOST_REQUIRE(queue.wait(frame));
+  BOOST_CHECK_EQUAL(frame, 10);
+  BOOST_REQUIRE(queue.wait(frame));
+  BOOST_CHECK_EQUAL(frame, 9);
+  BOOST_REQUIRE(queue.wait(frame));
+  BOOST_CHECK_EQUAL(frame, 20);
+  BOOST_CHECK_EQUAL(queue.size(), 0);
+}
+
+
+BOOST_AUTO_TEST_CASE(test_repeated_frames_should_keep_the_first_position)
+{
+  PrefetchQueue queue;
+  queue.set_requests({10, 9, 10, 20, 9});
+
+  BOOST_CHECK_EQUAL(queue.size(), 3);
+  int frame;
+  queue.wait(frame);
+  BOOST_CHECK_EQUAL(frame, 10);
+  queue.wait(frame);
+  BOOST_CHECK_EQUAL(frame, 9);
+}
+
+
+BOOST_AUTO_TEST_CASE(test_new_requests_should_replace_the_pending_ones)
+{
+  PrefetchQueue queue;
+  queue.set_requests({10, 9, 20});
+  queue.set_requests({30, 29});
+
+  int frame;
+  queue.wait(frame);
+  BOOST_CHECK_EQUAL(frame, 30);
+  BOOST_CHECK_EQUAL(queue.size(), 1);
+
+  queue.cancel();
+  BOOST_CHECK_EQUAL(queue.size(), 0);
+}
+
+
+BOOST_AUTO_TEST_CASE(test_wait_should_wake_up_with_requests)
+{
+  PrefetchQueue queue;
+  int frame = -1;
+  bool taken = false;
+  std::thread worker([&] { taken = queue.wait(frame); });
+
+  queue.set_requests({42});
+  worker.join();
+
+  BOOST_CHECK(taken);
+  BOOST_CHECK_EQUAL(frame, 42);
+}
+
+
+BOOST_AUTO_TEST_CASE(test_stop_should_end_wait)
+{
+  PrefetchQueue queue;
+  queue.set_requests({1, 2});
+  bool taken = true;
+  int frame;
+  queue.stop();
+  std::thread worker([&] { taken = queue.wait(frame); });
+  worker.join();
+
+  BOOST_CHECK(!taken);
+  BOOST_CHECK_EQUAL(queue.size(), 0);
+}
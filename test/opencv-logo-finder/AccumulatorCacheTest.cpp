@@ -0,0 +1,289 @@
+/*
+ * Copyright (C) 2018-2025 Werner Turing <werner.turing@protonmail.com>
+ *
+ * This file is part of multi-delogo.
+ *
+ * multi-delogo is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * multi-delogo is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with multi-delogo.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include <cstdio>
+#include <cstdint>
+#include <string>
+#include <vector>
+#include <fstream>
+
+#include <opencv2/core.hpp>
+
+#include "AccumulatorCache.hpp"
+#include "FrameAccumulator.hpp"
+
+using namespace mdl::opencv;
+
+
+#define BOOST_TEST_MODULE accumulator cache
+#define BOOST_TEST_DYN_LINK
+#include <boost/test/unit_test.hpp>
+
+
+const std::string VIDEO_FILE = "AccumulatorCacheTest.video";
+const std::string CACHE_FILE = "AccumulatorCacheTest.cache";
+const cv::Size FRAME_SIZE(1280, 720);
+
+
+// The cache only looks at the size and modification time of the video
+struct Files
+{
+  Files()
+  {
+    write_video("not really a video");
+    AccumulatorCache::remove(CACHE_FILE);
+  }
+
+  ~Files()
+  {
+    std::remove(VIDEO_FILE.c_str());
+    AccumulatorCache::remove(CACHE_FILE);
+  }
+
+  void write_video(const std::string& contents)
+  {
+    std::ofstream video(VIDEO_FILE);
+    video << contents;
+  }
+};
+
+
+FrameAccumulator random_sums(int n_frames, const cv::Rect& tile, bool squares = false)
+{
+  FrameAccumulator sums;
+  sums.reset(tile.height, tile.width, 3, squares);
+  cv::Mat frame(tile.height, tile.width, CV_8UC3);
+  for (int i = 0; i < n_frames; ++i) {
+    cv::randu(frame, cv::Scalar::all(0), cv::Scalar::all(256));
+    sums.add(frame);
+  }
+  return sums;
+}
+
+
+bool equal(const FrameAccumulator& sums1, const FrameAccumulator& sums2)
+{
+  cv::Mat avg1, avg2;
+  return sums1.average(avg1) && sums2.average(avg2)
+    && avg1.size() == avg2.size()
+    && cv::norm(avg1, avg2, cv::NORM_INF) == 0;
+}
+
+
+BOOST_FIXTURE_TEST_CASE(should_read_the_sums_after_opening_again, Files)
+{
+  cv::Rect tile1(0, 0, 40, 30);
+  cv::Rect tile2(100, 50, 21, 13);
+  FrameAccumulator sums1 = random_sums(25, tile1);
+  FrameAccumulator sums2 = random_sums(300, tile2);
+
+  AccumulatorCache cache;
+  BOOST_REQUIRE(cache.open(CACHE_FILE, VIDEO_FILE));
+  cache.put(0, 250, 10, FRAME_SIZE, tile1, sums1);
+  cache.put(250, 500, 10, FRAME_SIZE, tile2, sums2);
+
+  FrameAccumulator read;
+  BOOST_TEST(!cache.get(0, 250, 10, FRAME_SIZE, tile1, false, read));
+
+  BOOST_REQUIRE(cache.open(CACHE_FILE, VIDEO_FILE));
+  BOOST_TEST(cache.size() == 2);
+  BOOST_REQUIRE(cache.get(0, 250, 10, FRAME_SIZE, tile1, false, read));
+  BOOST_TEST(read.frames() == 25);
+  BOOST_TEST(equal(read, sums1));
+  BOOST_REQUIRE(cache.get(250, 500, 10, FRAME_SIZE, tile2, false, read));
+  BOOST_TEST(read.frames() == 300);
+  BOOST_TEST(equal(read, sums2));
+}
+
+
+BOOST_FIXTURE_TEST_CASE(should_not_find_sums_with_another_key, Files)
+{
+  cv::Rect tile(0, 0, 40, 30);
+
+  AccumulatorCache cache;
+  BOOST_REQUIRE(cache.open(CACHE_FILE, VIDEO_FILE));
+  cache.put(0, 250, 10, FRAME_SIZE, tile, random_sums(25, tile));
+  BOOST_REQUIRE(cache.open(CACHE_FILE, VIDEO_FILE));
+
+  FrameAccumulator read;
+  BOOST_TEST(!cache.get(1, 250, 10, FRAME_SIZE, tile, false, read));
+  BOOST_TEST(!cache.get(0, 251, 10, FRAME_SIZE, tile, false, read));
+  BOOST_TEST(!cache.get(0, 250, 5, FRAME_SIZE, tile, false, read));
+  BOOST_TEST(!cache.get(0, 250, 10, FRAME_SIZE, cv::Rect(1, 0, 40, 30), false, read));
+  BOOST_TEST(!cache.get(0, 250, 10, FRAME_SIZE, cv::Rect(0, 0, 40, 31), false, read));
+  BOOST_TEST(!cache.get(0, 250, 10, cv::Size(640, 360), tile, false, read));
+}
+
+
+BOOST_FIXTURE_TEST_CASE(should_keep_the_sums_of_the_squares_apart, Files)
+{
+  cv::Rect tile(0, 0, 41, 29);
+  FrameAccumulator with_squares = random_sums(25, tile, true);
+
+  AccumulatorCache cache;
+  BOOST_REQUIRE(cache.open(CACHE_FILE, VIDEO_FILE));
+  cache.put(0, 250, 10, FRAME_SIZE, tile, with_squares);
+  cache.put(250, 500, 10, FRAME_SIZE, tile, random_sums(300, tile));
+  BOOST_REQUIRE(cache.open(CACHE_FILE, VIDEO_FILE));
+  BOOST_TEST(cache.size() == 2);
+
+  FrameAccumulator read;
+  BOOST_TEST(!cache.get(0, 250, 10, FRAME_SIZE, tile, false, read));
+  BOOST_TEST(!cache.get(250, 500, 10, FRAME_SIZE, tile, true, read));
+
+  BOOST_REQUIRE(cache.get(0, 250, 10, FRAME_SIZE, tile, true, read));
+  BOOST_TEST(read.has_squares());
+  BOOST_TEST(equal(read, with_squares));
+  cv::Mat dev1, dev2;
+  BOOST_REQUIRE(read.deviation(dev1));
+  BOOST_REQUIRE(with_squares.deviation(dev2));
+  BOOST_TEST(cv::norm(dev1, dev2, cv::NORM_INF) == 0);
+}
+
+
+BOOST_FIXTURE_TEST_CASE(should_be_emptied_when_the_video_changes, Files)
+{
+  cv::Rect tile(0, 0, 40, 30);
+
+  AccumulatorCache cache;
+  BOOST_REQUIRE(cache.open(CACHE_FILE, VIDEO_FILE));
+  cache.put(0, 250, 10, FRAME_SIZE, tile, random_sums(25, tile));
+
+  write_video("another video, with another size");
+  BOOST_REQUIRE(cache.open(CACHE_FILE, VIDEO_FILE));
+  BOOST_TEST(cache.size() == 0);
+
+  FrameAccumulator read;
+  BOOST_TEST(!cache.get(0, 250, 10, FRAME_SIZE, tile, false, read));
+}
+
+
+BOOST_FIXTURE_TEST_CASE(should_ignore_incomplete_sums, Files)
+{
+  cv::Rect tile(0, 0, 40, 30);
+
+  AccumulatorCache cache;
+  BOOST_REQUIRE(cache.open(CACHE_FILE, VIDEO_FILE));
+  cache.put(0, 250, 10, FRAME_SIZE, tile, random_sums(25, tile));
+  cache.put(250, 500, 10, FRAME_SIZE, tile, random_sums(25, tile));
+  cache.close();
+
+  // As if the search was interrupted while the last sums were written
+  std::ifstream in(CACHE_FILE + ".0", std::ios::binary);
+  std::vector<char> contents((std::istreambuf_iterator<char>(in)), std::istreambuf_iterator<char>());
+  in.close();
+  std::ofstream out(CACHE_FILE + ".0", std::ios::binary | std::ios::trunc);
+  out.write(contents.data(), contents.size() - 100);
+  out.close();
+
+  BOOST_REQUIRE(cache.open(CACHE_FILE, VIDEO_FILE));
+  BOOST_TEST(cache.size() == 1);
+
+  FrameAccumulator read;
+  BOOST_TEST(cache.get(0, 250, 10, FRAME_SIZE, tile, false, read));
+  BOOST_TEST(!cache.get(250, 500, 10, FRAME_SIZE, tile, false, read));
+
+  // New sums are written after the complete ones
+  cache.put(250, 500, 10, FRAME_SIZE, tile, random_sums(30, tile));
+  BOOST_REQUIRE(cache.open(CACHE_FILE, VIDEO_FILE));
+  BOOST_TEST(cache.size() == 2);
+  BOOST_REQUIRE(cache.get(250, 500, 10, FRAME_SIZE, tile, false, read));
+  BOOST_TEST(read.frames() == 30);
+}
+
+
+BOOST_FIXTURE_TEST_CASE(should_delete_the_oldest_sums_when_full, Files)
+{
+  // 40x30 sums of 25 frames take a little more than 7 kB each
+  cv::Rect tile(0, 0, 40, 30);
+  uint64_t max_bytes = 8 * 16 * 1024;
+
+  AccumulatorCache cache;
+  cache.set_max_bytes(max_bytes);
+  BOOST_REQUIRE(cache.open(CACHE_FILE, VIDEO_FILE));
+  for (int i = 0; i < 100; ++i) {
+    cache.put(i * 250, (i + 1) * 250, 10, FRAME_SIZE, tile, random_sums(25, tile));
+    BOOST_TEST(cache.bytes() <= max_bytes + 16 * 1024);
+  }
+
+  BOOST_REQUIRE(cache.open(CACHE_FILE, VIDEO_FILE));
+  BOOST_TEST(cache.size() < 100);
+  BOOST_TEST(cache.size() > 8);
+
+  FrameAccumulator read;
+  BOOST_TEST(!cache.get(0, 250, 10, FRAME_SIZE, tile, false, read));
+  BOOST_TEST(cache.get(99 * 250, 100 * 250, 10, FRAME_SIZE, tile, false, read));
+  std::ifstream first_segment(CACHE_FILE + ".0");
+  BOOST_TEST(!first_segment);
+}
+
+
+BOOST_FIXTURE_TEST_CASE(should_keep_the_sums_read_recently, Files)
+{
+  cv::Rect tile(0, 0, 40, 30);
+  uint64_t max_bytes = 8 * 16 * 1024;
+  FrameAccumulator sums = random_sums(25, tile);
+
+  AccumulatorCache cache;
+  cache.set_max_bytes(max_bytes);
+  BOOST_REQUIRE(cache.open(CACHE_FILE, VIDEO_FILE));
+  cache.put(0, 250, 10, FRAME_SIZE, tile, sums);
+
+  FrameAccumulator read;
+  for (int i = 1; i < 100; ++i) {
+    cache.put(i * 250, (i + 1) * 250, 10, FRAME_SIZE, tile, random_sums(25, tile));
+    if (i % 10 == 0) {
+      BOOST_REQUIRE(cache.open(CACHE_FILE, VIDEO_FILE));
+      BOOST_REQUIRE(cache.get(0, 250, 10, FRAME_SIZE, tile, false, read));
+    }
+  }
+
+  BOOST_REQUIRE(cache.open(CACHE_FILE, VIDEO_FILE));
+  BOOST_REQUIRE(cache.get(0, 250, 10, FRAME_SIZE, tile, false, read));
+  BOOST_TEST(equal(read, sums));
+  BOOST_TEST(!cache.get(250, 500, 10, FRAME_SIZE, tile, false, read));
+}
+
+
+BOOST_FIXTURE_TEST_CASE(should_delete_the_segments_when_removed, Files)
+{
+  cv::Rect tile(0, 0, 40, 30);
+
+  AccumulatorCache cache;
+  cache.set_max_bytes(8 * 16 * 1024);
+  BOOST_REQUIRE(cache.open(CACHE_FILE, VIDEO_FILE));
+  for (int i = 0; i < 10; ++i) {
+    cache.put(i * 250, (i + 1) * 250, 10, FRAME_SIZE, tile, random_sums(25, tile));
+  }
+  cache.close();
+
+  AccumulatorCache::remove(CACHE_FILE);
+  for (int i = 0; i < 10; ++i) {
+    std::ifstream segment(CACHE_FILE + "." + std::to_string(i));
+    BOOST_TEST(!segment);
+  }
+  std::ifstream cache_file(CACHE_FILE);
+  BOOST_TEST(!cache_file);
+}
+
+
+BOOST_AUTO_TEST_CASE(should_not_open_without_the_video)
+{
+  AccumulatorCache cache;
+  BOOST_TEST(!cache.open(CACHE_FILE, "AccumulatorCacheTest.missing"));
+}
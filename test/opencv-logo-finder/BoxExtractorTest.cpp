@@ -0,0 +1,159 @@
+/*
+ * Copyright (C) 2018-2025 Werner Turing <werner.turing@protonmail.com>
+ *
+ * This file is part of multi-delogo.
+ *
+ * multi-delogo is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * multi-delogo is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with multi-delogo.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include <vector>
+
+#include <opencv2/core.hpp>
+#include <opencv2/imgproc.hpp>
+
+#include "BoxExtractor.hpp"
+
+using namespace mdl::opencv;
+
+
+#define BOOST_TEST_MODULE box extractor
+#define BOOST_TEST_DYN_LINK
+#include <boost/test/unit_test.hpp>
+
+
+// How the logo finder calculates the masks with the contours
+// extraction: one pass for each channel and operation
+cv::Mat opencv_mask(const cv::Mat& frame, int channel, int threshold, int close_steps)
+{
+  cv::Mat grey, gradient, thresh, closed;
+  cv::extractChannel(frame, grey, channel);
+  cv::morphologyEx(grey, gradient, cv::MORPH_GRADIENT, cv::Mat::ones(3, 3, CV_8U));
+  cv::threshold(gradient, thresh, threshold, 255, cv::THRESH_BINARY);
+  cv::morphologyEx(thresh, closed, cv::MORPH_CLOSE,
+                   cv::getStructuringElement(cv::MORPH_RECT, cv::Size(7, 1)),
+                   cv::Point(-1, -1), close_steps);
+  return closed;
+}
+
+
+cv::Mat random_frame(int rows, int cols)
+{
+  cv::Mat frame(rows, cols, CV_8UC3);
+  cv::randu(frame, cv::Scalar::all(0), cv::Scalar::all(256));
+  return frame;
+}
+
+
+// A dark frame with a bright rectangle outline in one channel
+cv::Mat frame_with_box(int rows, int cols, const cv::Rect& box, int channel)
+{
+  cv::Mat frame(rows, cols, CV_8UC3, cv::Scalar::all(0));
+  cv::Scalar color(0, 0, 0);
+  color[channel] = 255;
+  cv::rectangle(frame, box, color, 1);
+  return frame;
+}
+
+
+bool equal(const cv::Mat& m1, const cv::Mat& m2)
+{
+  return m1.size() == m2.size() && m1.type() == m2.type()
+    && cv::norm(m1, m2, cv::NORM_INF) == 0;
+}
+
+
+BOOST_AUTO_TEST_CASE(should_calculate_the_same_masks_as_opencv)
+{
+  cv::Mat frame = random_frame(61, 97);
+
+  BoxExtractor extractor;
+  extractor.extract_masks(frame, 190, 3 * 3);
+
+  for (int channel = 0; channel < 3; ++channel) {
+    BOOST_TEST(equal(extractor.get_mask(channel), opencv_mask(frame, channel, 190, 3)));
+  }
+}
+
+
+BOOST_AUTO_TEST_CASE(should_calculate_the_same_masks_as_opencv_with_other_parameters)
+{
+  cv::Mat frame = random_frame(20, 300);
+
+  BoxExtractor extractor;
+  for (int close_steps = 1; close_steps <= 4; ++close_steps) {
+    extractor.extract_masks(frame, 120, close_steps * 3);
+
+    for (int channel = 0; channel < 3; ++channel) {
+      BOOST_TEST(equal(extractor.get_mask(channel), opencv_mask(frame, channel, 120, close_steps)));
+    }
+  }
+}
+
+
+BOOST_AUTO_TEST_CASE(should_find_a_box)
+{
+  cv::Mat frame = frame_with_box(120, 200, cv::Rect(100, 50, 60, 15), 1);
+
+  BoxExtractor extractor;
+  extractor.extract_masks(frame, 190, 9);
+
+  BOOST_TEST(extractor.find_box(0, cv::Size(47, 9), cv::Size(135, 23)).width == 0);
+  // The gradient makes the box one pixel bigger on each side
+  BOOST_TEST(extractor.find_box(1, cv::Size(47, 9), cv::Size(135, 23)) == cv::Rect(99, 49, 62, 17));
+  BOOST_TEST(extractor.find_box(2, cv::Size(47, 9), cv::Size(135, 23)).width == 0);
+}
+
+
+BOOST_AUTO_TEST_CASE(should_ignore_boxes_of_other_sizes)
+{
+  cv::Mat frame = frame_with_box(120, 200, cv::Rect(100, 50, 30, 15), 0);
+
+  BoxExtractor extractor;
+  extractor.extract_masks(frame, 190, 9);
+
+  BOOST_TEST(extractor.find_box(0, cv::Size(47, 9), cv::Size(135, 23)).width == 0);
+}
+
+
+BOOST_AUTO_TEST_CASE(should_only_set_the_allowed_pixels)
+{
+  cv::Mat frame = frame_with_box(120, 200, cv::Rect(100, 50, 60, 15), 1);
+  cv::Mat allowed(120, 200, CV_8U, cv::Scalar(0));
+  allowed(cv::Rect(90, 40, 80, 35)).setTo(255);
+
+  BoxExtractor extractor;
+  extractor.extract_masks(frame, 190, 9, allowed);
+  BOOST_TEST(extractor.find_box(1, cv::Size(47, 9), cv::Size(135, 23)) == cv::Rect(99, 49, 62, 17));
+
+  allowed(cv::Rect(90, 40, 40, 35)).setTo(0);
+  extractor.extract_masks(frame, 190, 9, allowed);
+  BOOST_TEST(extractor.find_box(1, cv::Size(47, 9), cv::Size(135, 23)).width == 0);
+}
+
+
+BOOST_AUTO_TEST_CASE(should_find_all_boxes)
+{
+  cv::Mat frame = frame_with_box(120, 200, cv::Rect(20, 20, 60, 15), 1);
+  cv::rectangle(frame, cv::Rect(100, 80, 70, 20), cv::Scalar(0, 255, 0), cv::FILLED);
+
+  BoxExtractor extractor;
+  extractor.extract_masks(frame, 190, 9);
+  std::vector<ScoredBox> boxes;
+  extractor.find_boxes(1, cv::Size(47, 9), cv::Size(135, 23), cv::Point(5, 10), boxes);
+
+  BOOST_REQUIRE(boxes.size() == 2);
+  BOOST_TEST(boxes[0].box == cv::Rect(24, 29, 62, 17));
+  BOOST_TEST(boxes[1].box == cv::Rect(104, 89, 72, 22));
+  BOOST_TEST((boxes[0].score > 0 && boxes[0].score <= 1));
+  BOOST_TEST((boxes[1].score > 0 && boxes[1].score <= 1));
+}
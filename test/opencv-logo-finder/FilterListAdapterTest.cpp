@@ -0,0 +1,113 @@
+/*
+ * Copyright (C) 2018-2025 Werner Turing <werner.turing@protonmail.com>
+ *
+ * This file is part of multi-delogo.
+ *
+ * multi-delogo is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * multi-delogo is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with multi-delogo.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include <vector>
+
+#include "filter-generator/FilterList.hpp"
+#include "filter-generator/Filters.hpp"
+
+#include "FilterListAdapter.hpp"
+
+using namespace mdl;
+
+
+#define BOOST_TEST_MODULE filter list adapter
+#define BOOST_TEST_DYN_LINK
+#include <boost/test/unit_test.hpp>
+
+
+class NullCallback : public LogoFinderCallback
+{
+public:
+  void success(const LogoFinderResult&) override { };
+  void failure(int, int) override { };
+};
+
+
+bool is_review(const fg::FilterList& filters, int start_frame)
+{
+  auto filter = filters.get_by_start_frame(start_frame);
+  return filter && filter->second->type() == fg::FilterType::REVIEW;
+}
+
+
+BOOST_AUTO_TEST_CASE(test_get_review_ranges)
+{
+  fg::FilterList filters;
+  filters.insert(1, fg::filter_ptr(new fg::DelogoFilter(10, 15, 100, 20)));
+  filters.insert(101, fg::filter_ptr(new fg::ReviewFilter()));
+  filters.insert(201, fg::filter_ptr(new fg::ReviewFilter()));
+  filters.insert(301, fg::filter_ptr(new fg::DelogoFilter(20, 15, 100, 20)));
+  filters.insert(401, fg::filter_ptr(new fg::ReviewFilter()));
+
+  std::vector<LogoSearchRange> ranges = get_review_ranges(filters, 1000);
+
+  BOOST_REQUIRE_EQUAL(ranges.size(), 2);
+  BOOST_CHECK_EQUAL(ranges[0].start_frame, 100);
+  BOOST_CHECK_EQUAL(ranges[0].end_frame, 300);
+  BOOST_CHECK_EQUAL(ranges[1].start_frame, 400);
+  BOOST_CHECK_EQUAL(ranges[1].end_frame, 1000);
+}
+
+
+BOOST_AUTO_TEST_CASE(test_get_review_ranges_without_review_filters)
+{
+  fg::FilterList filters;
+  filters.insert(1, fg::filter_ptr(new fg::DelogoFilter(10, 15, 100, 20)));
+
+  BOOST_CHECK(get_review_ranges(filters, 1000).empty());
+}
+
+
+BOOST_AUTO_TEST_CASE(test_results_replace_review_filters)
+{
+  fg::FilterList filters;
+  filters.insert(1, fg::filter_ptr(new fg::DelogoFilter(10, 15, 100, 20)));
+  filters.insert(101, fg::filter_ptr(new fg::ReviewFilter()));
+  filters.insert(201, fg::filter_ptr(new fg::ReviewFilter()));
+  filters.insert(301, fg::filter_ptr(new fg::DelogoFilter(20, 15, 100, 20)));
+
+  NullCallback callback;
+  FilterListAdapter adapter(filters, callback);
+  adapter.success(LogoFinderResult{100, 249, 30, 15, 100, 20});
+  adapter.failure(250, 299);
+
+  BOOST_CHECK_EQUAL(filters.size(), 4);
+  BOOST_CHECK(filters.get_by_start_frame(101)->second->type() == fg::FilterType::DELOGO);
+  BOOST_CHECK(!filters.get_by_start_frame(201));
+  BOOST_CHECK(is_review(filters, 251));
+  BOOST_CHECK(filters.get_by_start_frame(301)->second->type() == fg::FilterType::DELOGO);
+}
+
+
+BOOST_AUTO_TEST_CASE(test_other_logos_are_added_to_the_filter)
+{
+  fg::FilterList filters;
+
+  NullCallback callback;
+  FilterListAdapter adapter(filters, callback);
+  LogoFinderResult result{0, 99, 10, 15, 100, 20};
+  result.other_logos.push_back(LogoBox{500, 15, 60, 30});
+  adapter.success(result);
+
+  auto filter = std::dynamic_pointer_cast<fg::DelogoFilter>(filters.get_by_start_frame(1)->second);
+  BOOST_REQUIRE(filter);
+  BOOST_REQUIRE_EQUAL(filter->other_regions().size(), 1);
+  BOOST_CHECK_EQUAL(filter->other_regions()[0].x, 500);
+  BOOST_CHECK_EQUAL(filter->other_regions()[0].height, 30);
+}
@@ -0,0 +1,70 @@
+/*
+ * Copyright (C) 2018-2025 Werner Turing <werner.turing@protonmail.com>
+ *
+ * This file is part of multi-delogo.
+ *
+ * multi-delogo is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * multi-delogo is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with multi-delogo.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include "filter-generator/FilterList.hpp"
+#include "filter-generator/Filters.hpp"
+
+#include "FilterListComparison.hpp"
+
+using namespace mdl;
+
+
+#define BOOST_TEST_MODULE filter list comparison
+#define BOOST_TEST_DYN_LINK
+#include <boost/test/unit_test.hpp>
+
+
+BOOST_AUTO_TEST_CASE(test_compare)
+{
+  fg::FilterList reference;
+  reference.insert(1, fg::filter_ptr(new fg::DelogoFilter(10, 15, 100, 20)));
+  reference.insert(101, fg::filter_ptr(new fg::DelogoFilter(20, 15, 100, 20)));
+  reference.insert(201, fg::filter_ptr(new fg::DelogoFilter(30, 15, 100, 20)));
+  reference.insert(301, fg::filter_ptr(new fg::DelogoFilter(40, 15, 100, 20)));
+
+  fg::FilterList filters;
+  filters.insert(1, fg::filter_ptr(new fg::DelogoFilter(10, 15, 100, 20)));
+  filters.insert(101, fg::filter_ptr(new fg::DelogoFilter(20, 15, 100, 21)));
+  filters.insert(201, fg::filter_ptr(new fg::ReviewFilter()));
+  filters.insert(305, fg::filter_ptr(new fg::DelogoFilter(40, 15, 100, 20)));
+  filters.insert(401, fg::filter_ptr(new fg::ReviewFilter()));
+
+  FilterListComparison comparison = FilterListComparison::compare(reference, filters);
+
+  BOOST_CHECK_EQUAL(comparison.reference_filters, 4);
+  BOOST_CHECK_EQUAL(comparison.filters, 5);
+  BOOST_CHECK_EQUAL(comparison.equal, 1);
+  BOOST_CHECK_EQUAL(comparison.different, 2);
+  BOOST_CHECK_EQUAL(comparison.missing, 1);
+  BOOST_CHECK_EQUAL(comparison.review, 2);
+}
+
+
+BOOST_AUTO_TEST_CASE(test_compare_with_itself)
+{
+  fg::FilterList filters;
+  filters.insert(1, fg::filter_ptr(new fg::DelogoFilter(10, 15, 100, 20)));
+  filters.insert(101, fg::filter_ptr(new fg::ReviewFilter()));
+
+  FilterListComparison comparison = FilterListComparison::compare(filters, filters);
+
+  BOOST_CHECK_EQUAL(comparison.equal, 2);
+  BOOST_CHECK_EQUAL(comparison.different, 0);
+  BOOST_CHECK_EQUAL(comparison.missing, 0);
+  BOOST_CHECK_EQUAL(comparison.review, 1);
+}
@@ -0,0 +1,271 @@
+/*
+ * Copyright (C) 2018-2025 Werner Turing <werner.turing@protonmail.com>
+ *
+ * This file is part of multi-delogo.
+ *
+ * multi-delogo is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * multi-delogo is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with multi-delogo.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include <vector>
+
+#include <opencv2/core.hpp>
+
+#include "FrameAccumulator.hpp"
+
+using namespace mdl::opencv;
+
+
+#define BOOST_TEST_MODULE frame accumulator
+#define BOOST_TEST_DYN_LINK
+#include <boost/test/unit_test.hpp>
+
+
+std::vector<cv::Mat> random_frames(int n, int rows, int cols)
+{
+  std::vector<cv::Mat> frames;
+  for (int i = 0; i < n; ++i) {
+    cv::Mat frame(rows, cols, CV_8UC3);
+    cv::randu(frame, cv::Scalar::all(0), cv::Scalar::all(256));
+    frames.push_back(frame);
+  }
+  return frames;
+}
+
+
+// How the logo finder used to calculate averages
+cv::Mat double_average(const std::vector<cv::Mat>& frames)
+{
+  cv::Mat sum(frames[0].rows, frames[0].cols, CV_64FC3, cv::Scalar(0, 0, 0));
+  cv::Mat frame_f;
+  for (const auto& frame: frames) {
+    frame.convertTo(frame_f, CV_64FC3);
+    sum += frame_f;
+  }
+
+  cv::Mat avg;
+  sum.convertTo(avg, CV_8U, 1. / frames.size());
+  return avg;
+}
+
+
+cv::Mat double_deviation(const std::vector<cv::Mat>& frames)
+{
+  cv::Mat mean(frames[0].rows, frames[0].cols, CV_64FC3, cv::Scalar(0, 0, 0));
+  cv::Mat frame_f;
+  for (const auto& frame: frames) {
+    frame.convertTo(frame_f, CV_64FC3);
+    mean += frame_f;
+  }
+  mean /= double(frames.size());
+
+  cv::Mat variance(frames[0].rows, frames[0].cols, CV_64FC3, cv::Scalar(0, 0, 0));
+  for (const auto& frame: frames) {
+    frame.convertTo(frame_f, CV_64FC3);
+    frame_f -= mean;
+    variance += frame_f.mul(frame_f);
+  }
+  variance /= double(frames.size());
+
+  cv::Mat deviation;
+  cv::sqrt(variance, deviation);
+  deviation.convertTo(deviation, CV_8U);
+  return deviation;
+}
+
+
+bool equal(const cv::Mat& m1, const cv::Mat& m2)
+{
+  return m1.size() == m2.size() && m1.type() == m2.type()
+    && cv::norm(m1, m2, cv::NORM_INF) == 0;
+}
+
+
+BOOST_AUTO_TEST_CASE(should_calculate_the_same_average_as_with_doubles)
+{
+  auto frames = random_frames(25, 37, 53);
+
+  FrameAccumulator accumulator;
+  accumulator.reset(37, 53, 3);
+  for (const auto& frame: frames) {
+    accumulator.add(frame);
+  }
+
+  cv::Mat avg;
+  BOOST_REQUIRE(accumulator.average(avg));
+  BOOST_TEST(accumulator.frames() == 25);
+  BOOST_TEST(equal(avg, double_average(frames)));
+}
+
+
+BOOST_AUTO_TEST_CASE(should_calculate_the_same_average_after_widening_the_sums)
+{
+  auto frames = random_frames(300, 19, 41);
+
+  FrameAccumulator accumulator;
+  accumulator.reset(19, 41, 3);
+  for (const auto& frame: frames) {
+    accumulator.add(frame);
+  }
+
+  cv::Mat avg;
+  BOOST_REQUIRE(accumulator.average(avg));
+  BOOST_TEST(equal(avg, double_average(frames)));
+}
+
+
+BOOST_AUTO_TEST_CASE(should_add_other_accumulators)
+{
+  auto frames = random_frames(400, 16, 33);
+
+  FrameAccumulator first;
+  first.reset(16, 33, 3);
+  FrameAccumulator second;
+  second.reset(16, 33, 3);
+  FrameAccumulator third;
+  third.reset(16, 33, 3);
+  for (int i = 0; i < 400; ++i) {
+    if (i < 200) {
+      first.add(frames[i]);
+    } else if (i < 300) {
+      second.add(frames[i]);
+    } else {
+      third.add(frames[i]);
+    }
+  }
+
+  FrameAccumulator total;
+  total.reset(16, 33, 3);
+  total.add(first);
+  total.add(second);
+  total.add(third);
+
+  cv::Mat avg;
+  BOOST_REQUIRE(total.average(avg));
+  BOOST_TEST(total.frames() == 400);
+  BOOST_TEST(equal(avg, double_average(frames)));
+}
+
+
+BOOST_AUTO_TEST_CASE(should_accept_regions_of_frames)
+{
+  auto frames = random_frames(10, 50, 50);
+
+  std::vector<cv::Mat> regions;
+  FrameAccumulator accumulator;
+  accumulator.reset(20, 15, 3);
+  for (const auto& frame: frames) {
+    cv::Mat region(frame, cv::Rect(7, 11, 15, 20));
+    regions.push_back(region.clone());
+    accumulator.add(region);
+  }
+
+  cv::Mat avg;
+  BOOST_REQUIRE(accumulator.average(avg));
+  BOOST_TEST(equal(avg, double_average(regions)));
+}
+
+
+BOOST_AUTO_TEST_CASE(should_not_calculate_average_without_frames)
+{
+  FrameAccumulator accumulator;
+  accumulator.reset(10, 10, 3);
+
+  cv::Mat avg;
+  BOOST_TEST(!accumulator.average(avg));
+}
+
+
+BOOST_AUTO_TEST_CASE(should_load_the_sums_it_returns)
+{
+  for (int n_frames: {20, 300}) {
+    auto frames = random_frames(n_frames, 12, 17);
+
+    FrameAccumulator accumulator;
+    accumulator.reset(12, 17, 3);
+    for (const auto& frame: frames) {
+      accumulator.add(frame);
+    }
+
+    std::vector<char> sums(static_cast<const char*>(accumulator.sums()),
+                           static_cast<const char*>(accumulator.sums()) + accumulator.sums_size());
+    FrameAccumulator loaded;
+    loaded.load(12, 17, 3, n_frames, sums.data());
+
+    cv::Mat avg;
+    BOOST_REQUIRE(loaded.average(avg));
+    BOOST_TEST(loaded.frames() == n_frames);
+    BOOST_TEST(loaded.sums_size() == accumulator.sums_size());
+    BOOST_TEST(equal(avg, double_average(frames)));
+  }
+}
+
+
+BOOST_AUTO_TEST_CASE(should_calculate_the_standard_deviation)
+{
+  for (int n_frames: {30, 300}) {
+    auto frames = random_frames(n_frames, 21, 35);
+
+    FrameAccumulator accumulator;
+    accumulator.reset(21, 35, 3, true);
+    for (const auto& frame: frames) {
+      accumulator.add(frame);
+    }
+
+    cv::Mat dev;
+    BOOST_REQUIRE(accumulator.deviation(dev));
+    cv::Mat avg;
+    BOOST_REQUIRE(accumulator.average(avg));
+    // Rounding of the square root can differ
+    BOOST_TEST(cv::norm(dev, double_deviation(frames), cv::NORM_INF) <= 1);
+    BOOST_TEST(equal(avg, double_average(frames)));
+  }
+}
+
+
+BOOST_AUTO_TEST_CASE(should_add_the_squares_of_other_accumulators)
+{
+  auto frames = random_frames(300, 16, 33);
+
+  FrameAccumulator first;
+  first.reset(16, 33, 3, true);
+  FrameAccumulator second;
+  second.reset(16, 33, 3, true);
+  FrameAccumulator all;
+  all.reset(16, 33, 3, true);
+  for (int i = 0; i < 300; ++i) {
+    (i < 100 ? first : second).add(frames[i]);
+    all.add(frames[i]);
+  }
+
+  FrameAccumulator total;
+  total.reset(16, 33, 3, true);
+  total.add(first);
+  total.add(second);
+
+  cv::Mat dev, expected;
+  BOOST_REQUIRE(total.deviation(dev));
+  BOOST_REQUIRE(all.deviation(expected));
+  BOOST_TEST(equal(dev, expected));
+}
+
+
+BOOST_AUTO_TEST_CASE(should_have_no_deviation_without_the_squares)
+{
+  FrameAccumulator accumulator;
+  accumulator.reset(10, 10, 3);
+  accumulator.add(cv::Mat(10, 10, CV_8UC3, cv::Scalar::all(7)));
+
+  cv::Mat dev;
+  BOOST_TEST(!accumulator.has_squares());
+  BOOST_TEST(!accumulator.deviation(dev));
+}
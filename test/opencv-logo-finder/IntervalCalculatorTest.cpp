@@ -75,3 +75,22 @@ BOOST_AUTO_TEST_CASE(should_return_one_subinterval_for_third_level)
 }
 
 BOOST_AUTO_TEST_SUITE_END()
+
+
+BOOST_AUTO_TEST_SUITE(get_first_sample)
+
+BOOST_AUTO_TEST_CASE(should_return_the_start_if_it_is_a_sample)
+{
+  BOOST_TEST(IntervalCalculator::get_first_sample(0, 10) == 0);
+  BOOST_TEST(IntervalCalculator::get_first_sample(1230, 10) == 1230);
+}
+
+
+BOOST_AUTO_TEST_CASE(should_return_the_next_multiple_of_the_step)
+{
+  BOOST_TEST(IntervalCalculator::get_first_sample(1, 10) == 10);
+  BOOST_TEST(IntervalCalculator::get_first_sample(1231, 10) == 1240);
+  BOOST_TEST(IntervalCalculator::get_first_sample(1239, 10) == 1240);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,199 @@
+/*
+ * Copyright (C) 2018-2025 Werner Turing <werner.turing@protonmail.com>
+ *
+ * This file is part of multi-delogo.
+ *
+ * multi-delogo is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * multi-delogo is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with multi-delogo.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include <string>
+#include <sstream>
+#include <vector>
+#include <thread>
+#include <chrono>
+
+#include "Profiler.hpp"
+
+using namespace mdl::opencv;
+
+
+#define BOOST_TEST_MODULE profiler
+#define BOOST_TEST_DYN_LINK
+#include <boost/test/unit_test.hpp>
+
+
+BOOST_AUTO_TEST_CASE(test_add_should_sum_the_runs_of_a_stage)
+{
+  Profiler profiler;
+  Profiler::clock::time_point start = Profiler::clock::now();
+
+  profiler.add(Profiler::Stage::AVERAGE_FRAME, start, start + std::chrono::milliseconds(10));
+  profiler.add(Profiler::Stage::AVERAGE_FRAME, start, start + std::chrono::milliseconds(30));
+  profiler.add(Profiler::Stage::FILTER_2D, start, start + std::chrono::milliseconds(5));
+
+  BOOST_CHECK_EQUAL(profiler.get_runs(Profiler::Stage::AVERAGE_FRAME), 2);
+  BOOST_CHECK_CLOSE(profiler.get_seconds(Profiler::Stage::AVERAGE_FRAME), 0.04, 0.001);
+  BOOST_CHECK_EQUAL(profiler.get_runs(Profiler::Stage::FILTER_2D), 1);
+  BOOST_CHECK_CLOSE(profiler.get_seconds(Profiler::Stage::FILTER_2D), 0.005, 0.001);
+}
+
+
+BOOST_AUTO_TEST_CASE(test_stages_not_run_should_be_zero)
+{
+  Profiler profiler;
+
+  BOOST_CHECK_EQUAL(profiler.get_runs(Profiler::Stage::CONTOURS), 0);
+  BOOST_CHECK_EQUAL(profiler.get_seconds(Profiler::Stage::CONTOURS), 0);
+  BOOST_CHECK_EQUAL(profiler.get_count(Profiler::Counter::SEEKS), 0);
+}
+
+
+BOOST_AUTO_TEST_CASE(test_count)
+{
+  Profiler profiler;
+
+  profiler.count(Profiler::Counter::FRAMES_GRABBED);
+  profiler.count(Profiler::Counter::FRAMES_GRABBED, 9);
+  profiler.count(Profiler::Counter::SEEKS);
+
+  BOOST_CHECK_EQUAL(profiler.get_count(Profiler::Counter::FRAMES_GRABBED), 10);
+  BOOST_CHECK_EQUAL(profiler.get_count(Profiler::Counter::SEEKS), 1);
+}
+
+
+BOOST_AUTO_TEST_CASE(test_scope_should_add_a_run)
+{
+  Profiler profiler;
+
+  {
+    Profiler::Scope scope(&profiler, Profiler::Stage::TRANSITION_SCAN);
+  }
+
+  BOOST_CHECK_EQUAL(profiler.get_runs(Profiler::Stage::TRANSITION_SCAN), 1);
+}
+
+
+BOOST_AUTO_TEST_CASE(test_scope_without_profiler_should_do_nothing)
+{
+  Profiler::Scope scope(nullptr, Profiler::Stage::TRANSITION_SCAN);
+}
+
+
+BOOST_AUTO_TEST_CASE(test_count_from_several_threads)
+{
+  Profiler profiler;
+
+  std::vector<std::thread> threads;
+  for (int i = 0; i < 4; ++i) {
+    threads.push_back(std::thread([&profiler] {
+          for (int j = 0; j < 1000; ++j) {
+            Profiler::Scope scope(&profiler, Profiler::Stage::GRAB);
+            profiler.count(Profiler::Counter::FRAMES_GRABBED);
+          }
+        }));
+  }
+  for (auto& thread: threads) {
+    thread.join();
+  }
+
+  BOOST_CHECK_EQUAL(profiler.get_count(Profiler::Counter::FRAMES_GRABBED), 4000);
+  BOOST_CHECK_EQUAL(profiler.get_runs(Profiler::Stage::GRAB), 4000);
+}
+
+
+BOOST_AUTO_TEST_CASE(test_summary_should_have_stages_and_counters)
+{
+  Profiler profiler;
+  Profiler::clock::time_point start = Profiler::clock::now();
+  profiler.add(Profiler::Stage::AVERAGE_FRAME, start, start + std::chrono::milliseconds(10));
+  profiler.count(Profiler::Counter::SEEKS, 3);
+
+  std::ostringstream out;
+  profiler.write_summary(out);
+
+  BOOST_CHECK(out.str().find("average_frame") != std::string::npos);
+  BOOST_CHECK(out.str().find("seeks") != std::string::npos);
+}
+
+
+BOOST_AUTO_TEST_CASE(test_trace_should_have_only_traced_stages)
+{
+  Profiler profiler(true);
+  Profiler::clock::time_point start = Profiler::clock::now();
+  profiler.add(Profiler::Stage::ACCUMULATE, start, start + std::chrono::milliseconds(10));
+  profiler.add(Profiler::Stage::GRAB, start, start + std::chrono::milliseconds(1));
+  profiler.count(Profiler::Counter::FRAMES_GRABBED, 5);
+
+  std::ostringstream out;
+  profiler.write_trace(out);
+  std::string trace = out.str();
+
+  BOOST_CHECK(trace.find("{\"name\":\"accumulate\"") != std::string::npos);
+  BOOST_CHECK(trace.find("\"dur\":10000") != std::string::npos);
+  BOOST_CHECK(trace.find("\"name\":\"grab\"") == std::string::npos);
+  BOOST_CHECK(trace.find("{\"name\":\"frames grabbed\",\"ph\":\"C\"") != std::string::npos);
+  BOOST_CHECK(trace.find("\"args\":{\"value\":5}") != std::string::npos);
+  BOOST_CHECK_EQUAL(trace.substr(trace.size() - 3), "]}\n");
+}
+
+
+BOOST_AUTO_TEST_CASE(test_trace_should_keep_only_the_first_events)
+{
+  Profiler profiler(true);
+  profiler.set_max_trace_events(2);
+  Profiler::clock::time_point start = Profiler::clock::now();
+  for (int i = 0; i < 5; ++i) {
+    profiler.add(Profiler::Stage::ACCUMULATE, start, start + std::chrono::milliseconds(10));
+  }
+
+  std::ostringstream out;
+  profiler.write_trace(out);
+  std::string trace = out.str();
+
+  size_t events = 0;
+  for (size_t pos = trace.find("\"name\":\"accumulate\""); pos != std::string::npos;
+       pos = trace.find("\"name\":\"accumulate\"", pos + 1)) {
+    ++events;
+  }
+  BOOST_CHECK_EQUAL(events, 2u);
+  BOOST_CHECK_EQUAL(profiler.get_dropped_trace_events(), 3u);
+  BOOST_CHECK_EQUAL(profiler.get_runs(Profiler::Stage::ACCUMULATE), 5);
+}
+
+
+BOOST_AUTO_TEST_CASE(test_profile_without_trace_should_keep_no_events)
+{
+  Profiler profiler;
+  Profiler::clock::time_point start = Profiler::clock::now();
+  profiler.add(Profiler::Stage::ACCUMULATE, start, start + std::chrono::milliseconds(10));
+
+  std::ostringstream out;
+  profiler.write_trace(out);
+
+  BOOST_CHECK(out.str().find("\"name\":\"accumulate\"") == std::string::npos);
+  BOOST_CHECK_EQUAL(profiler.get_runs(Profiler::Stage::ACCUMULATE), 1);
+}
+
+
+BOOST_AUTO_TEST_CASE(test_counters_of_different_profilers_should_be_separate)
+{
+  Profiler profiler1;
+  Profiler profiler2;
+
+  profiler1.count(Profiler::Counter::SEEKS);
+  profiler2.count(Profiler::Counter::SEEKS, 2);
+  profiler1.count(Profiler::Counter::SEEKS);
+
+  BOOST_CHECK_EQUAL(profiler1.get_count(Profiler::Counter::SEEKS), 2);
+  BOOST_CHECK_EQUAL(profiler2.get_count(Profiler::Counter::SEEKS), 2);
+}
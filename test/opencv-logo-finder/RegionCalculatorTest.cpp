@@ -0,0 +1,111 @@
+/*
+ * Copyright (C) 2018-2025 Werner Turing <werner.turing@protonmail.com>
+ *
+ * This file is part of multi-delogo.
+ *
+ * multi-delogo is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * multi-delogo is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with multi-delogo.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include <vector>
+
+#include <opencv2/core.hpp>
+
+#include "RegionCalculator.hpp"
+
+using namespace mdl::opencv;
+
+
+#define BOOST_TEST_MODULE region calculator
+#define BOOST_TEST_DYN_LINK
+#include <boost/test/unit_test.hpp>
+
+
+BOOST_AUTO_TEST_SUITE(get_corners)
+
+BOOST_AUTO_TEST_CASE(should_return_the_four_corners)
+{
+  auto corners = RegionCalculator::get_corners(1280, 720, 0.25);
+
+  BOOST_REQUIRE(corners.size() == 4);
+  BOOST_TEST(corners[0] == cv::Rect(0, 0, 320, 180));
+  BOOST_TEST(corners[1] == cv::Rect(960, 0, 320, 180));
+  BOOST_TEST(corners[2] == cv::Rect(0, 540, 320, 180));
+  BOOST_TEST(corners[3] == cv::Rect(960, 540, 320, 180));
+}
+
+
+BOOST_AUTO_TEST_CASE(should_return_the_whole_frame_if_corners_touch)
+{
+  auto corners = RegionCalculator::get_corners(1280, 720, 0.5);
+
+  BOOST_REQUIRE(corners.size() == 1);
+  BOOST_TEST(corners[0] == cv::Rect(0, 0, 1280, 720));
+}
+
+BOOST_AUTO_TEST_SUITE_END()
+
+
+BOOST_AUTO_TEST_SUITE(get_tiles)
+
+BOOST_AUTO_TEST_CASE(should_return_the_whole_frame_without_regions)
+{
+  auto tiles = RegionCalculator::get_tiles(1280, 720, {});
+
+  BOOST_REQUIRE(tiles.size() == 1);
+  BOOST_TEST(tiles[0] == cv::Rect(0, 0, 1280, 720));
+}
+
+
+BOOST_AUTO_TEST_CASE(should_keep_separate_regions)
+{
+  auto tiles = RegionCalculator::get_tiles(1280, 720, {cv::Rect(0, 0, 100, 50),
+                                                       cv::Rect(1000, 600, 100, 50)});
+
+  BOOST_REQUIRE(tiles.size() == 2);
+  BOOST_TEST(tiles[0] == cv::Rect(0, 0, 100, 50));
+  BOOST_TEST(tiles[1] == cv::Rect(1000, 600, 100, 50));
+}
+
+
+BOOST_AUTO_TEST_CASE(should_clip_regions_to_the_frame)
+{
+  auto tiles = RegionCalculator::get_tiles(1280, 720, {cv::Rect(1200, -10, 200, 50),
+                                                       cv::Rect(2000, 0, 100, 50)});
+
+  BOOST_REQUIRE(tiles.size() == 1);
+  BOOST_TEST(tiles[0] == cv::Rect(1200, 0, 80, 40));
+}
+
+
+BOOST_AUTO_TEST_CASE(should_return_the_whole_frame_if_all_regions_are_outside_the_frame)
+{
+  auto tiles = RegionCalculator::get_tiles(1280, 720, {cv::Rect(2000, 0, 100, 50)});
+
+  BOOST_REQUIRE(tiles.size() == 1);
+  BOOST_TEST(tiles[0] == cv::Rect(0, 0, 1280, 720));
+}
+
+
+BOOST_AUTO_TEST_CASE(should_merge_overlapping_regions)
+{
+  auto tiles = RegionCalculator::get_tiles(1280, 720, {cv::Rect(0, 0, 100, 50),
+                                                       cv::Rect(500, 500, 10, 10),
+                                                       cv::Rect(150, 0, 100, 50),
+                                                       cv::Rect(90, 40, 70, 20)});
+
+  BOOST_REQUIRE(tiles.size() == 2);
+  BOOST_TEST(tiles[0] == cv::Rect(0, 0, 250, 60));
+  BOOST_TEST(tiles[1] == cv::Rect(500, 500, 10, 10));
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,104 @@
+/*
+ * Copyright (C) 2018-2025 Werner Turing <werner.turing@protonmail.com>
+ *
+ * This file is part of multi-delogo.
+ *
+ * multi-delogo is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * multi-delogo is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with multi-delogo.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include <vector>
+#include <thread>
+#include <chrono>
+
+#include <opencv2/core.hpp>
+
+#include "SceneCutDetector.hpp"
+
+using namespace mdl::opencv;
+
+
+#define BOOST_TEST_MODULE scene cut detector
+#define BOOST_TEST_DYN_LINK
+#include <boost/test/unit_test.hpp>
+
+
+cv::Mat random_frame(int rows, int cols)
+{
+  cv::Mat frame(rows, cols, CV_8UC3);
+  cv::randu(frame, cv::Scalar::all(0), cv::Scalar::all(256));
+  return frame;
+}
+
+
+const std::vector<cv::Rect> TILES = {cv::Rect(0, 0, 64, 48), cv::Rect(256, 0, 64, 48)};
+
+
+BOOST_AUTO_TEST_CASE(should_not_find_a_cut_in_the_first_frame)
+{
+  SceneCutDetector detector(TILES, 0.3);
+
+  BOOST_TEST(!detector.add(random_frame(240, 320)));
+  BOOST_TEST(detector.last_distance() == 0);
+}
+
+
+BOOST_AUTO_TEST_CASE(should_not_find_a_cut_in_similar_frames)
+{
+  SceneCutDetector detector(TILES, 0.3);
+  cv::Mat frame(240, 320, CV_8UC3, cv::Scalar(100, 50, 20));
+
+  detector.add(frame);
+  frame(cv::Rect(0, 0, 32, 48)).setTo(cv::Scalar(102, 53, 21));
+  BOOST_TEST(!detector.add(frame));
+  BOOST_TEST(detector.last_distance() < 0.3);
+}
+
+
+BOOST_AUTO_TEST_CASE(should_find_a_cut_when_a_tile_changes)
+{
+  SceneCutDetector detector(TILES, 0.3);
+  cv::Mat frame(240, 320, CV_8UC3, cv::Scalar(20, 20, 20));
+
+  detector.add(frame);
+  frame(TILES[1]).setTo(cv::Scalar(200, 100, 20));
+  BOOST_TEST(detector.add(frame));
+  BOOST_TEST(detector.last_distance() > 0.3);
+
+  // Compared with the last frame, not the first
+  BOOST_TEST(!detector.add(frame));
+}
+
+
+BOOST_AUTO_TEST_CASE(should_ignore_changes_outside_the_tiles)
+{
+  SceneCutDetector detector(TILES, 0.3);
+  cv::Mat frame(240, 320, CV_8UC3, cv::Scalar(20, 20, 20));
+
+  detector.add(frame);
+  frame(cv::Rect(0, 100, 320, 140)).setTo(cv::Scalar(255, 255, 255));
+  BOOST_TEST(!detector.add(frame));
+}
+
+
+BOOST_AUTO_TEST_CASE(should_stop_waiting_for_cuts_when_stopped)
+{
+  // Never started, so the frames are never scanned
+  SceneCutDetector detector(TILES, 0.3);
+
+  std::thread stopper([&detector] {
+      std::this_thread::sleep_for(std::chrono::milliseconds(50));
+      detector.request_stop();
+    });
+  BOOST_TEST(detector.find_cut(0, 1000) == -1);
+  stopper.join();
+}
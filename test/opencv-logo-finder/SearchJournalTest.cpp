@@ -0,0 +1,148 @@
+/*
+ * Copyright (C) 2018-2025 Werner Turing <werner.turing@protonmail.com>
+ *
+ * This file is part of multi-delogo.
+ *
+ * multi-delogo is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * multi-delogo is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with multi-delogo.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include <vector>
+#include <sstream>
+
+#include "SearchJournal.hpp"
+
+using namespace mdl;
+
+
+#define BOOST_TEST_MODULE search journal
+#define BOOST_TEST_DYN_LINK
+#include <boost/test/unit_test.hpp>
+
+
+class RecordingCallback : public LogoFinderCallback
+{
+public:
+  std::vector<LogoFinderResult> results;
+
+  void success(const LogoFinderResult& result) override
+  {
+    results.push_back(result);
+  }
+
+  void failure(int start_frame, int end_frame) override
+  {
+    results.push_back(LogoFinderResult{start_frame, end_frame, 0, 0, 0, 0});
+  }
+};
+
+
+BOOST_AUTO_TEST_CASE(test_results_are_passed_on)
+{
+  std::stringstream journal;
+  RecordingCallback callback;
+  SearchJournal search_journal(journal, callback);
+
+  search_journal.success(LogoFinderResult{0, 99, 10, 15, 100, 20});
+  search_journal.failure(100, 199);
+
+  BOOST_REQUIRE_EQUAL(callback.results.size(), 2);
+  BOOST_CHECK_EQUAL(callback.results[0].x, 10);
+  BOOST_CHECK_EQUAL(callback.results[1].start_frame, 100);
+}
+
+
+BOOST_AUTO_TEST_CASE(test_replay)
+{
+  std::stringstream journal;
+  RecordingCallback unused;
+  SearchJournal search_journal(journal, unused);
+  search_journal.success(LogoFinderResult{0, 99, 10, 15, 100, 20});
+  search_journal.failure(100, 199);
+  search_journal.failure(200, 299);
+
+  RecordingCallback callback;
+  SearchResumePoint resume_point = SearchJournal::replay(journal, callback);
+
+  BOOST_CHECK_EQUAL(resume_point.start_frame, 300);
+  BOOST_CHECK_EQUAL(resume_point.failures, 2);
+  BOOST_REQUIRE_EQUAL(callback.results.size(), 3);
+  BOOST_CHECK_EQUAL(callback.results[0].start_frame, 0);
+  BOOST_CHECK_EQUAL(callback.results[0].end_frame, 99);
+  BOOST_CHECK_EQUAL(callback.results[0].x, 10);
+  BOOST_CHECK_EQUAL(callback.results[0].y, 15);
+  BOOST_CHECK_EQUAL(callback.results[0].width, 100);
+  BOOST_CHECK_EQUAL(callback.results[0].height, 20);
+  BOOST_CHECK_EQUAL(callback.results[2].start_frame, 200);
+}
+
+
+BOOST_AUTO_TEST_CASE(test_replay_other_logos)
+{
+  std::stringstream journal;
+  RecordingCallback unused;
+  SearchJournal search_journal(journal, unused);
+  LogoFinderResult result{0, 99, 10, 15, 100, 20};
+  result.other_logos.push_back(LogoBox{500, 15, 60, 30});
+  result.other_logos.push_back(LogoBox{10, 400, 80, 20});
+  search_journal.success(result);
+  search_journal.success(LogoFinderResult{100, 199, 10, 15, 100, 20});
+
+  RecordingCallback callback;
+  SearchJournal::replay(journal, callback);
+
+  BOOST_REQUIRE_EQUAL(callback.results.size(), 2);
+  BOOST_REQUIRE_EQUAL(callback.results[0].other_logos.size(), 2);
+  BOOST_CHECK_EQUAL(callback.results[0].other_logos[0].x, 500);
+  BOOST_CHECK_EQUAL(callback.results[0].other_logos[0].height, 30);
+  BOOST_CHECK_EQUAL(callback.results[0].other_logos[1].y, 400);
+  BOOST_CHECK_EQUAL(callback.results[0].other_logos[1].width, 80);
+  BOOST_CHECK(callback.results[1].other_logos.empty());
+}
+
+
+BOOST_AUTO_TEST_CASE(test_success_resets_failures)
+{
+  std::stringstream journal("failure 0 99\n"
+                            "success 100 150 10 15 100 20\n");
+
+  RecordingCallback callback;
+  SearchResumePoint resume_point = SearchJournal::replay(journal, callback);
+
+  BOOST_CHECK_EQUAL(resume_point.start_frame, 151);
+  BOOST_CHECK_EQUAL(resume_point.failures, 0);
+}
+
+
+BOOST_AUTO_TEST_CASE(test_incomplete_line_is_ignored)
+{
+  std::stringstream journal("success 0 99 10 15 100 20\n"
+                            "success 100 199 10");
+
+  RecordingCallback callback;
+  SearchResumePoint resume_point = SearchJournal::replay(journal, callback);
+
+  BOOST_CHECK_EQUAL(resume_point.start_frame, 100);
+  BOOST_CHECK_EQUAL(callback.results.size(), 1);
+}
+
+
+BOOST_AUTO_TEST_CASE(test_empty_journal)
+{
+  std::stringstream journal;
+
+  RecordingCallback callback;
+  SearchResumePoint resume_point = SearchJournal::replay(journal, callback);
+
+  BOOST_CHECK_EQUAL(resume_point.start_frame, -1);
+  BOOST_CHECK(callback.results.empty());
+}
@@ -0,0 +1,136 @@
+/*
+ * Copyright (C) 2018-2025 Werner Turing <werner.turing@protonmail.com>
+ *
+ * This file is part of multi-delogo.
+ *
+ * multi-delogo is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * multi-delogo is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with multi-delogo.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include <string>
+#include <vector>
+#include <stdexcept>
+
+#include "gui/common/LogoFinder.hpp"
+
+#include "SearchOptions.hpp"
+
+using namespace mdl;
+
+
+#define BOOST_TEST_MODULE search options
+#define BOOST_TEST_DYN_LINK
+#include <boost/test/unit_test.hpp>
+
+
+class NullCallback : public LogoFinderCallback
+{
+public:
+  void success(const LogoFinderResult&) override { };
+  void failure(int, int) override { };
+};
+
+
+class OptionsFinder : public LogoFinder
+{
+public:
+  OptionsFinder(LogoFinderCallback& callback)
+    : LogoFinder(callback, false) { };
+
+  int get_total_frames() const override {
+    return 0;
+  }
+
+  find_result find_logos() override {
+    return std::make_pair(true, "");
+  }
+
+  void stop() override { };
+};
+
+
+std::vector<std::string> read_options(SearchOptions& options, std::vector<std::string> args)
+{
+  std::vector<char*> argv{const_cast<char*>("program")};
+  for (auto& arg: args) {
+    argv.push_back(&arg[0]);
+  }
+
+  std::vector<std::string> others;
+  for (int i = 1; i < int(argv.size()); ++i) {
+    if (!options.read(argv.size(), argv.data(), i)) {
+      others.push_back(argv[i]);
+    }
+  }
+  return others;
+}
+
+
+BOOST_AUTO_TEST_CASE(test_read_should_take_only_search_options)
+{
+  SearchOptions options;
+  std::vector<std::string> others = read_options(options,
+    {"--max-logos", "2", "--review", "x.mdl", "--sampling", "seek", "--scene-cuts", "video.mp4"});
+
+  BOOST_CHECK_EQUAL(options.max_logos, 2);
+  BOOST_CHECK(options.sampling_mode == SamplingMode::SEEK);
+  BOOST_CHECK(options.scene_cuts);
+  BOOST_REQUIRE_EQUAL(others.size(), 3);
+  BOOST_CHECK_EQUAL(others[0], "--review");
+  BOOST_CHECK_EQUAL(others[1], "x.mdl");
+  BOOST_CHECK_EQUAL(others[2], "video.mp4");
+}
+
+
+BOOST_AUTO_TEST_CASE(test_read_should_reject_invalid_values)
+{
+  SearchOptions options;
+
+  BOOST_CHECK_THROW(read_options(options, {"--signal", "colour"}), std::invalid_argument);
+  BOOST_CHECK_THROW(read_options(options, {"--region", "10,20"}), std::invalid_argument);
+}
+
+
+BOOST_AUTO_TEST_CASE(test_configure_should_set_the_options_read)
+{
+  SearchOptions options;
+  read_options(options,
+    {"--threads", "4", "--box-extraction", "fused", "--signal", "variance", "--frame-step", "3",
+     "--analysis-height", "360", "--corners", "25", "--track", "2", "--max-logos", "3"});
+
+  NullCallback callback;
+  OptionsFinder finder(callback);
+  options.configure(finder);
+
+  BOOST_CHECK_EQUAL(finder.get_threads(), 4);
+  BOOST_CHECK(finder.get_box_extraction() == BoxExtraction::FUSED);
+  BOOST_CHECK(finder.get_detection_signal() == DetectionSignal::VARIANCE);
+  BOOST_CHECK_EQUAL(finder.get_frame_step(), 3);
+  BOOST_CHECK_EQUAL(finder.get_analysis_height(), 360);
+  BOOST_CHECK_CLOSE(finder.get_corner_size(), 0.25, 0.001);
+  BOOST_CHECK_EQUAL(finder.get_max_tracked_logos(), 2);
+  BOOST_CHECK_EQUAL(finder.get_max_logos(), 3);
+}
+
+
+BOOST_AUTO_TEST_CASE(test_configure_should_keep_the_defaults_not_given)
+{
+  NullCallback callback;
+  OptionsFinder reference(callback);
+  OptionsFinder finder(callback);
+  SearchOptions().configure(finder);
+
+  BOOST_CHECK_EQUAL(finder.get_frame_step(), reference.get_frame_step());
+  BOOST_CHECK_EQUAL(finder.get_decode_buffer_size(), reference.get_decode_buffer_size());
+  BOOST_CHECK_EQUAL(finder.get_cache_size(), reference.get_cache_size());
+  BOOST_CHECK_EQUAL(finder.get_max_logos(), 1);
+}
@@ -0,0 +1,150 @@
+/*
+ * Copyright (C) 2018-2025 Werner Turing <werner.turing@protonmail.com>
+ *
+ * This file is part of multi-delogo.
+ *
+ * multi-delogo is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * multi-delogo is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with multi-delogo.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include <vector>
+
+#include "filter-generator/FilterList.hpp"
+#include "filter-generator/Filters.hpp"
+
+#include "ShardMerge.hpp"
+
+using namespace mdl;
+
+
+#define BOOST_TEST_MODULE shard merge
+#define BOOST_TEST_DYN_LINK
+#include <boost/test/unit_test.hpp>
+
+
+fg::filter_ptr delogo(int x)
+{
+  return fg::filter_ptr(new fg::DelogoFilter(x, 15, 100, 20));
+}
+
+
+bool is_delogo(const fg::FilterList& filters, int start_frame, int x)
+{
+  auto filter = filters.get_by_start_frame(start_frame);
+  return filter && filter->second->save_str() == delogo(x)->save_str();
+}
+
+
+bool is_review(const fg::FilterList& filters, int start_frame)
+{
+  auto filter = filters.get_by_start_frame(start_frame);
+  return filter && filter->second->type() == fg::FilterType::REVIEW;
+}
+
+
+BOOST_AUTO_TEST_CASE(test_equal_logos_are_joined_at_the_seam)
+{
+  fg::FilterList shard1;
+  shard1.insert(1, delogo(10));
+  shard1.insert(101, delogo(20));
+  fg::FilterList shard2;
+  shard2.insert(201, delogo(20));
+  shard2.insert(301, delogo(30));
+
+  fg::FilterList merged;
+  std::vector<LogoSearchRange> ranges = ShardMerge::merge({&shard2, &shard1}, 20, 1000, merged);
+
+  BOOST_CHECK(ranges.empty());
+  BOOST_CHECK_EQUAL(merged.size(), 3);
+  BOOST_CHECK(is_delogo(merged, 1, 10));
+  BOOST_CHECK(is_delogo(merged, 101, 20));
+  BOOST_CHECK(is_delogo(merged, 301, 30));
+}
+
+
+BOOST_AUTO_TEST_CASE(test_different_logos_are_searched_again)
+{
+  fg::FilterList shard1;
+  shard1.insert(1, delogo(10));
+  fg::FilterList shard2;
+  shard2.insert(201, delogo(20));
+  shard2.insert(401, delogo(30));
+
+  fg::FilterList merged;
+  std::vector<LogoSearchRange> ranges = ShardMerge::merge({&shard1, &shard2}, 20, 1000, merged);
+
+  BOOST_REQUIRE_EQUAL(ranges.size(), 1);
+  BOOST_CHECK_EQUAL(ranges[0].start_frame, 180);
+  BOOST_CHECK_EQUAL(ranges[0].end_frame, 220);
+  BOOST_CHECK_EQUAL(merged.size(), 4);
+  BOOST_CHECK(is_delogo(merged, 1, 10));
+  BOOST_CHECK(is_review(merged, 181));
+  BOOST_CHECK(is_delogo(merged, 221, 20));
+  BOOST_CHECK(is_delogo(merged, 401, 30));
+}
+
+
+BOOST_AUTO_TEST_CASE(test_search_range_stops_at_next_filter)
+{
+  fg::FilterList shard1;
+  shard1.insert(1, delogo(10));
+  fg::FilterList shard2;
+  shard2.insert(201, delogo(20));
+  shard2.insert(211, delogo(30));
+
+  fg::FilterList merged;
+  std::vector<LogoSearchRange> ranges = ShardMerge::merge({&shard1, &shard2}, 20, 1000, merged);
+
+  BOOST_REQUIRE_EQUAL(ranges.size(), 1);
+  BOOST_CHECK_EQUAL(ranges[0].start_frame, 180);
+  BOOST_CHECK_EQUAL(ranges[0].end_frame, 210);
+  BOOST_CHECK_EQUAL(merged.size(), 3);
+  BOOST_CHECK(is_review(merged, 181));
+  BOOST_CHECK(is_delogo(merged, 211, 30));
+}
+
+
+BOOST_AUTO_TEST_CASE(test_search_range_stops_at_end_of_video)
+{
+  fg::FilterList shard1;
+  shard1.insert(1, delogo(10));
+  fg::FilterList shard2;
+  shard2.insert(201, delogo(20));
+
+  fg::FilterList merged;
+  std::vector<LogoSearchRange> ranges = ShardMerge::merge({&shard1, &shard2}, 20, 210, merged);
+
+  BOOST_REQUIRE_EQUAL(ranges.size(), 1);
+  BOOST_CHECK_EQUAL(ranges[0].start_frame, 180);
+  BOOST_CHECK_EQUAL(ranges[0].end_frame, 210);
+  BOOST_CHECK_EQUAL(merged.size(), 2);
+  BOOST_CHECK(is_delogo(merged, 1, 10));
+  BOOST_CHECK(is_review(merged, 181));
+}
+
+
+BOOST_AUTO_TEST_CASE(test_join_equal_filters)
+{
+  fg::FilterList filters;
+  filters.insert(1, delogo(10));
+  filters.insert(181, delogo(10));
+  filters.insert(201, fg::filter_ptr(new fg::ReviewFilter()));
+  filters.insert(221, delogo(20));
+  filters.insert(301, delogo(20));
+
+  ShardMerge::join_equal_filters(filters);
+
+  BOOST_CHECK_EQUAL(filters.size(), 3);
+  BOOST_CHECK(is_delogo(filters, 1, 10));
+  BOOST_CHECK(is_review(filters, 201));
+  BOOST_CHECK(is_delogo(filters, 221, 20));
+}
@@ -0,0 +1,217 @@
+/*
+ * Copyright (C) 2018-2025 Werner Turing <werner.turing@protonmail.com>
+ *
+ * This file is part of multi-delogo.
+ *
+ * multi-delogo is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * multi-delogo is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with multi-delogo.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include <cmath>
+#include <cstdint>
+#include <random>
+#include <set>
+#include <vector>
+
+#include "TransitionSearch.hpp"
+
+using namespace mdl::opencv;
+
+
+#define BOOST_TEST_MODULE transition search
+#define BOOST_TEST_DYN_LINK
+#include <boost/test/unit_test.hpp>
+
+
+const double THRESHOLD = 0.7;
+
+
+// Logo area of a synthetic clip. Each segment between switch points
+// shows a different logo, and every frame has some noise. Optionally
+// the logo fades into the next one instead of switching at once
+class SyntheticClip : public TransitionSearch::Frames
+{
+public:
+  SyntheticClip(int n_frames, const std::vector<int>& switch_points, int fade_frames = 0)
+  {
+    const int N_PIXELS = 20 * 20 * 3;
+    std::mt19937 rng(n_frames);
+    std::uniform_int_distribution<int> logo_pixel(0, 255);
+    std::uniform_int_distribution<int> noise(-2, 2);
+
+    std::vector<std::vector<int>> logos(switch_points.size() + 1);
+    for (auto& logo: logos) {
+      for (int i = 0; i < N_PIXELS; ++i) {
+        logo.push_back(logo_pixel(rng));
+      }
+    }
+
+    size_t segment = 0;
+    for (int frame = 0; frame < n_frames; ++frame) {
+      while (segment < switch_points.size() && frame >= switch_points[segment]) {
+        ++segment;
+      }
+
+      // Fading frames are a mix of the logo and the next one
+      double next_weight = 0;
+      if (segment < switch_points.size() && switch_points[segment] - frame <= fade_frames) {
+        next_weight = 1.0 - double(switch_points[segment] - frame) / (fade_frames + 1);
+      }
+
+      std::vector<uint8_t> pixels;
+      for (int i = 0; i < N_PIXELS; ++i) {
+        double value = logos[segment][i];
+        if (next_weight > 0) {
+          value = (1 - next_weight)*value + next_weight*logos[segment + 1][i];
+        }
+        pixels.push_back(std::max(0, std::min(255, int(value) + noise(rng))));
+      }
+      frames_.push_back(pixels);
+    }
+  }
+
+  double difference(int frame1, int frame2) override
+  {
+    read_.insert(frame1);
+    read_.insert(frame2);
+
+    double sum = 0;
+    for (size_t i = 0; i < frames_[frame1].size(); ++i) {
+      double d = double(frames_[frame1][i]) - frames_[frame2][i];
+      sum += d*d;
+    }
+    // As in the finder, the norm is divided by the area of the logo
+    return std::sqrt(sum) / (20 * 20);
+  }
+
+  int frames_read() const
+  {
+    return read_.size();
+  }
+
+private:
+  std::vector<std::vector<uint8_t>> frames_;
+  std::set<int> read_;
+};
+
+
+BOOST_AUTO_TEST_CASE(linear_search_should_find_the_switch_point)
+{
+  SyntheticClip clip(1000, {620});
+  TransitionSearch search(clip, THRESHOLD);
+
+  BOOST_TEST(search.find_linear(500, 1000) == 620);
+}
+
+
+BOOST_AUTO_TEST_CASE(bisecting_search_should_find_the_switch_point)
+{
+  SyntheticClip clip(1000, {620});
+  TransitionSearch search(clip, THRESHOLD);
+
+  BOOST_TEST(search.find_bisecting(500, 1000) == 620);
+}
+
+
+BOOST_AUTO_TEST_CASE(bisecting_search_should_read_less_frames)
+{
+  SyntheticClip linear_clip(5000, {4321});
+  TransitionSearch linear_search(linear_clip, THRESHOLD);
+  SyntheticClip bisecting_clip(5000, {4321});
+  TransitionSearch bisecting_search(bisecting_clip, THRESHOLD);
+
+  BOOST_TEST(linear_search.find_linear(500, 5000) == 4321);
+  BOOST_TEST(bisecting_search.find_bisecting(500, 5000) == 4321);
+  BOOST_TEST(bisecting_clip.frames_read() < 40);
+  BOOST_TEST(linear_clip.frames_read() > 3800);
+}
+
+
+BOOST_AUTO_TEST_CASE(should_find_a_switch_at_the_first_frame)
+{
+  SyntheticClip clip(1000, {500});
+  TransitionSearch search(clip, THRESHOLD);
+
+  BOOST_TEST(search.find_linear(500, 1000) == 500);
+  BOOST_TEST(search.find_bisecting(500, 1000) == 500);
+}
+
+
+BOOST_AUTO_TEST_CASE(should_find_a_switch_at_the_last_frame)
+{
+  SyntheticClip clip(1000, {999});
+  TransitionSearch search(clip, THRESHOLD);
+
+  BOOST_TEST(search.find_linear(500, 1000) == 999);
+  BOOST_TEST(search.find_bisecting(500, 1000) == 999);
+}
+
+
+BOOST_AUTO_TEST_CASE(should_return_the_end_when_there_is_no_switch)
+{
+  SyntheticClip clip(1000, {});
+  TransitionSearch search(clip, THRESHOLD);
+
+  BOOST_TEST(search.find_linear(500, 800) == 800);
+  BOOST_TEST(search.find_bisecting(500, 800) == 800);
+}
+
+
+BOOST_AUTO_TEST_CASE(should_return_the_end_when_the_switch_is_after_it)
+{
+  SyntheticClip clip(1000, {900});
+  TransitionSearch search(clip, THRESHOLD);
+
+  BOOST_TEST(search.find_linear(500, 800) == 800);
+  BOOST_TEST(search.find_bisecting(500, 800) == 800);
+}
+
+
+BOOST_AUTO_TEST_CASE(should_find_the_first_of_many_switch_points)
+{
+  SyntheticClip clip(3000, {700, 1200, 1201, 2500});
+  TransitionSearch search(clip, THRESHOLD);
+
+  BOOST_TEST(search.find_linear(500, 3000) == 700);
+  BOOST_TEST(search.find_bisecting(500, 3000) == 700);
+  BOOST_TEST(search.find_bisecting(701, 3000) == 1200);
+  BOOST_TEST(search.find_bisecting(1201, 3000) == 1201);
+  BOOST_TEST(search.find_bisecting(1202, 3000) == 2500);
+}
+
+
+BOOST_AUTO_TEST_CASE(bisecting_search_should_fall_back_to_linear_when_the_logo_fades)
+{
+  // Consecutive frames of the fade are similar, so there is no
+  // transition, but they become different from the reference
+  SyntheticClip clip(2000, {1500}, 400);
+  TransitionSearch search(clip, THRESHOLD);
+
+  int linear = search.find_linear(500, 2000);
+  BOOST_TEST(search.find_bisecting(500, 2000) == linear);
+}
+
+
+BOOST_AUTO_TEST_CASE(both_searches_should_agree_on_random_clips)
+{
+  std::mt19937 rng(42);
+  for (int i = 0; i < 50; ++i) {
+    int n_frames = std::uniform_int_distribution<int>(100, 2000)(rng);
+    int switch_point = std::uniform_int_distribution<int>(1, n_frames + 100)(rng);
+    int first_frame = std::uniform_int_distribution<int>(1, n_frames - 1)(rng);
+
+    SyntheticClip clip(n_frames, {switch_point});
+    TransitionSearch search(clip, THRESHOLD);
+
+    BOOST_TEST(search.find_bisecting(first_frame, n_frames) == search.find_linear(first_frame, n_frames));
+  }
+}